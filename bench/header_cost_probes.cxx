@@ -0,0 +1,289 @@
+// header_cost_probes.cxx
+//
+// Instantiation probes for the header cost benchmark (cmake/HeaderCost.cmake). The benchmark
+// compiles this file once per header with LBNL_PROBE_<id> defined, where <id> is the header
+// path below include/lbnl without extension, '/' replaced by '_' (algorithm/search.hxx ->
+// algorithm_search). It compiles it a second time with LBNL_PROBE_INCLUDE_ONLY also defined;
+// the difference is the cost of instantiating the typical uses below.
+//
+// Headers without a probe are measured for parsing only.
+
+#if defined(LBNL_PROBE_algorithm)
+#    include <string>
+#    include <vector>
+#    include <lbnl/algorithm.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const std::vector<int> values{3, 1, 2, 3};
+    const std::vector<double> weights{0.5, 1.5};
+    (void)lbnl::find_element(values, [](int v) { return v > 1; });
+    (void)lbnl::contains(values, 2);
+    (void)lbnl::sorted_unique(values);
+    (void)lbnl::merge(values, values);
+    (void)lbnl::zip(values, weights);
+    (void)lbnl::transform_if(values, [](int v) { return v > 1; }, [](int v) { return v * 2; });
+    (void)lbnl::transform_filter(
+      values, [](int v) { return v > 1; }, [](int v) { return v * 0.5; });
+    (void)lbnl::filter(values, [](int v) { return v % 2 == 0; });
+    (void)lbnl::partition(values, [](int v) { return v % 2 == 0; });
+    (void)lbnl::split(std::string("a,b"), ',');
+    (void)lbnl::flatten(std::vector<std::vector<int>>{values});
+    (void)lbnl::transform_to_vector(values, [](int v) { return v + 1; });
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_algorithm_search)
+#    include <vector>
+#    include <lbnl/algorithm/search.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const std::vector<int> values{3, 1, 2};
+    (void)lbnl::find_element(values, [](int v) { return v > 1; });
+    (void)lbnl::contains(values, 2);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_optional)
+#    include <optional>
+#    include <variant>
+#    include <lbnl/optional.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    (void)lbnl::extend(std::optional<int>(2))
+      .map([](int v) { return v * 2.0; })
+      .and_then([](double v) { return std::optional<long>(static_cast<long>(v)); })
+      .value_or(0);
+    (void)lbnl::get_if_opt<int>(std::variant<int, double>(1));
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_optional_utils)
+#    include <optional>
+#    include <vector>
+#    include <lbnl/optional_utils.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const std::vector<std::optional<double>> series{1.0, std::nullopt, 3.0};
+    (void)lbnl::average_optional(series);
+    (void)lbnl::average_optional(series, lbnl::Summation::Kahan, 2);
+    (void)lbnl::optional_stats(series);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_compact_optional)
+#    include <lbnl/compact_optional.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const lbnl::CompactOptional<double> value(2.0);
+    (void)value.map([](double v) { return v * 2.0; }).value_or(0.0);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_optional_column)
+#    include <lbnl/optional_column.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    lbnl::OptionalColumn<double> column{1.0, std::nullopt, 3.0};
+    (void)column.map([](double v) { return v * 2.0; }).average();
+    (void)column.count_valid();
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_variant_utils)
+#    include <string>
+#    include <variant>
+#    include <vector>
+#    include <lbnl/variant_utils.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const std::vector<std::variant<int, std::string, double>> cells{1, std::string("a"), 2.0};
+    (void)lbnl::split_by_alternative(cells);
+    (void)lbnl::split_by_alternative(cells, std::size_t{2});
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_expected)
+#    include <string>
+#    include <lbnl/expected.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const lbnl::ExpectedExt<int, std::string> result(2);
+    (void)result.and_then([](int v) { return lbnl::ExpectedExt<double, std::string>(v * 0.5); })
+      .transform([](double v) { return v + 1.0; })
+      .transform_error([](const std::string & e) { return e.size(); })
+      .value_or(0.0);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_expected_utils)
+#    include <string>
+#    include <vector>
+#    include <lbnl/expected_utils.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const std::vector<lbnl::ExpectedExt<int, std::string>> results{1, 2};
+    (void)lbnl::collect(results);
+    (void)lbnl::partition_results(results);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_error)
+#    include <string>
+#    include <lbnl/error.hxx>
+#    include <lbnl/expected.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const std::string path = "data.csv";
+    const lbnl::ExpectedExt<int, lbnl::Error> result(lbnl::Unexpected(lbnl::Error(1, "row {}", 4)));
+    (void)result.transform_error(lbnl::with_context("reading {}", path)).error().message();
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_lazy_chain)
+#    include <optional>
+#    include <lbnl/lazy_chain.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const std::optional<int> source(2);
+    (void)lbnl::lazy(source).map([](int v) { return v * 2.0; }).value_or(0.0);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_map_utils)
+#    include <map>
+#    include <string>
+#    include <lbnl/map_utils.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const std::map<int, std::string> names{{1, "one"}};
+    (void)lbnl::map_keys(names);
+    (void)lbnl::map_values(names);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_enum_string_mapper)
+#    include <lbnl/enum_string_mapper.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+enum class ProbeColor
+{
+    Red,
+    Green
+};
+
+void probe()
+{
+    constexpr auto names = lbnl::make_enum_string_mapper<ProbeColor>(
+      {{"Red", ProbeColor::Red}, {"Green", ProbeColor::Green}});
+    (void)names.from_string("Green");
+    (void)names.to_string(ProbeColor::Red);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_enum_map)
+#    include <lbnl/enum_map.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+enum class ProbeSide
+{
+    Front,
+    Back
+};
+
+void probe()
+{
+    lbnl::EnumMap<ProbeSide, double, lbnl::EnumRange<ProbeSide::Front, ProbeSide::Back>> loads;
+    loads[ProbeSide::Back] = 1.0;
+    (void)loads.at(ProbeSide::Back);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_memoize) || defined(LBNL_PROBE_memoize_lazy_evaluator)
+#    if defined(LBNL_PROBE_memoize)
+#        include <lbnl/memoize.hxx>
+#    else
+#        include <lbnl/memoize/lazy_evaluator.hxx>
+#    endif
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    lbnl::LazyEvaluator<int, double> evaluator([](int key) { return key * 2.0; });
+    (void)evaluator.get(1);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_memoize_inline_lazy_evaluator)
+#    include <lbnl/memoize/inline_lazy_evaluator.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    auto evaluator = lbnl::make_inline_lazy_evaluator<int>([](int key) { return key * 2.0; });
+    (void)evaluator.get(1);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_memoize_memoized)
+#    include <lbnl/memoize/memoized.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const auto area = lbnl::memoize([](int zone, double height) { return zone * height; });
+    (void)area(1, 2.0);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_recursive_memoize)
+#    include <cstdint>
+#    include <lbnl/recursive_memoize.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    using Evaluator = lbnl::RecursiveEvaluator<int, std::uint64_t>;
+    lbnl::WorkStealingPool pool(2);
+    Evaluator fib(
+      [](int n, Evaluator::Context & ctx) -> std::uint64_t {
+          return n < 2 ? static_cast<std::uint64_t>(n) : ctx.get(n - 1) + ctx.get(n - 2);
+      },
+      pool);
+    (void)fib.get(10);
+}
+#    endif
+#endif
+
+#if defined(LBNL_PROBE_warm_start)
+#    include <lbnl/warm_start.hxx>
+#    if !defined(LBNL_PROBE_INCLUDE_ONLY)
+void probe()
+{
+    const lbnl::LazyEvaluator<int, double> evaluator([](int key) { return key * 1.5; });
+    (void)lbnl::save_warm_start(evaluator, "probe.bin", 1);
+}
+#    endif
+#endif
@@ -0,0 +1,182 @@
+# HeaderCost.cmake
+#
+# Measures what each public header costs a translation unit that includes it, and optionally
+# fails when a header got more expensive than a saved baseline. Run through the header_cost
+# target (see LBNL_HEADER_COST in CMakeLists.txt) or directly:
+#
+#   cmake -DCOMPILER=g++ -DCOMPILER_ID=GNU -DSTD_FLAG=-std=c++20 -DSOURCE_DIR=<repo>
+#         -DWORK_DIR=<dir> -DOUTPUT=<dir>/header_cost.csv [-DBASELINE=<old csv>]
+#         -P cmake/HeaderCost.cmake
+#
+# For every header below include/lbnl it records, as one CSV row:
+#   preprocessed_kb  size of the preprocessed translation unit (deterministic)
+#   parse_ms         compile time of a TU that only includes the header, minus an empty TU
+#   instantiate_ms   extra time for the typical uses in bench/header_cost_probes.cxx
+#                    (empty when the header has no probe)
+# Times are the fastest of REPEAT runs. Parsing is timed with a syntax-only compile; the probes
+# are compiled to an object file so that code generation for the instantiations is included.
+#
+# With BASELINE, a header fails when its preprocessed size grew by more than SIZE_TOLERANCE
+# percent, or its parse + instantiate time grew by more than TIME_TOLERANCE percent and by more
+# than MIN_TIME_DELTA_MS.
+
+foreach(_required COMPILER COMPILER_ID STD_FLAG SOURCE_DIR WORK_DIR OUTPUT)
+    if(NOT DEFINED ${_required})
+        message(FATAL_ERROR "HeaderCost.cmake: ${_required} is not set")
+    endif()
+endforeach()
+
+if(NOT DEFINED REPEAT)
+    set(REPEAT 3)
+endif()
+if(NOT DEFINED SIZE_TOLERANCE)
+    set(SIZE_TOLERANCE 5)
+endif()
+if(NOT DEFINED TIME_TOLERANCE)
+    set(TIME_TOLERANCE 25)
+endif()
+if(NOT DEFINED MIN_TIME_DELTA_MS)
+    set(MIN_TIME_DELTA_MS 20)
+endif()
+
+set(_include_dir "${SOURCE_DIR}/include")
+set(_probes "${SOURCE_DIR}/bench/header_cost_probes.cxx")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+if(COMPILER_ID STREQUAL "MSVC")
+    set(_syntax_only /nologo /Zs /EHsc ${STD_FLAG} "/I${_include_dir}")
+    set(_compile /nologo /c /EHsc ${STD_FLAG} "/I${_include_dir}" "/Fo${WORK_DIR}/probe.obj")
+    set(_preprocess /nologo /EP /EHsc ${STD_FLAG} "/I${_include_dir}")
+    set(_define /D)
+else()
+    set(_syntax_only -fsyntax-only ${STD_FLAG} "-I${_include_dir}")
+    set(_compile -c ${STD_FLAG} "-I${_include_dir}" -o "${WORK_DIR}/probe.o")
+    set(_preprocess -E -P ${STD_FLAG} "-I${_include_dir}")
+    set(_define -D)
+endif()
+
+# Fastest of REPEAT compiles of source with the flags in ARGN, in microseconds
+function(_lbnl_compile_time source result)
+    set(_best "")
+    foreach(_run RANGE 1 ${REPEAT})
+        string(TIMESTAMP _start "%s%f" UTC)
+        execute_process(COMMAND "${COMPILER}" ${ARGN} "${source}"
+                        RESULT_VARIABLE _status
+                        OUTPUT_VARIABLE _output
+                        ERROR_VARIABLE _output)
+        string(TIMESTAMP _stop "%s%f" UTC)
+        if(NOT _status EQUAL 0)
+            message(FATAL_ERROR "HeaderCost.cmake: compiling ${source} failed:\n${_output}")
+        endif()
+        math(EXPR _elapsed "${_stop} - ${_start}")
+        if(_best STREQUAL "" OR _elapsed LESS _best)
+            set(_best ${_elapsed})
+        endif()
+    endforeach()
+    set(${result} ${_best} PARENT_SCOPE)
+endfunction()
+
+file(WRITE "${WORK_DIR}/empty.cxx" "")
+_lbnl_compile_time("${WORK_DIR}/empty.cxx" _empty_us ${_syntax_only})
+
+file(GLOB_RECURSE _headers RELATIVE "${_include_dir}/lbnl" "${_include_dir}/lbnl/*.hxx")
+list(SORT _headers)
+file(READ "${_probes}" _probe_source)
+
+set(_csv "header,preprocessed_kb,parse_ms,instantiate_ms\n")
+foreach(_header IN LISTS _headers)
+    string(REGEX REPLACE "\\.hxx$" "" _id "${_header}")
+    string(REPLACE "/" "_" _id "${_id}")
+    set(_source "${WORK_DIR}/${_id}.cxx")
+    file(WRITE "${_source}" "#include <lbnl/${_header}>\n")
+
+    execute_process(COMMAND "${COMPILER}" ${_preprocess} "${_source}"
+                    OUTPUT_FILE "${WORK_DIR}/${_id}.i"
+                    RESULT_VARIABLE _status
+                    ERROR_VARIABLE _errors)
+    if(NOT _status EQUAL 0)
+        message(FATAL_ERROR "HeaderCost.cmake: lbnl/${_header} is not self-contained:\n${_errors}")
+    endif()
+    file(SIZE "${WORK_DIR}/${_id}.i" _bytes)
+    math(EXPR _kb "(${_bytes} + 512) / 1024")
+
+    _lbnl_compile_time("${_source}" _include_us ${_syntax_only})
+    math(EXPR _parse_ms "(${_include_us} - ${_empty_us}) / 1000")
+    if(_parse_ms LESS 0)
+        set(_parse_ms 0)
+    endif()
+
+    set(_instantiate_ms "")
+    string(FIND "${_probe_source}" "LBNL_PROBE_${_id})" _has_probe)
+    if(NOT _has_probe EQUAL -1)
+        _lbnl_compile_time("${_probes}" _probe_us ${_compile} ${_define}LBNL_PROBE_${_id})
+        _lbnl_compile_time("${_probes}" _probe_include_us ${_compile}
+                           ${_define}LBNL_PROBE_${_id} ${_define}LBNL_PROBE_INCLUDE_ONLY)
+        math(EXPR _instantiate_ms "(${_probe_us} - ${_probe_include_us}) / 1000")
+        if(_instantiate_ms LESS 0)
+            set(_instantiate_ms 0)
+        endif()
+    endif()
+
+    string(APPEND _csv "${_header},${_kb},${_parse_ms},${_instantiate_ms}\n")
+    set(_summary "lbnl/${_header}: ${_kb} KB preprocessed, parse ${_parse_ms} ms")
+    if(NOT _instantiate_ms STREQUAL "")
+        string(APPEND _summary ", instantiate ${_instantiate_ms} ms")
+    endif()
+    message(STATUS "${_summary}")
+
+    set(_kb_${_id} ${_kb})
+    if(_instantiate_ms STREQUAL "")
+        set(_ms_${_id} ${_parse_ms})
+    else()
+        math(EXPR _ms_${_id} "${_parse_ms} + ${_instantiate_ms}")
+    endif()
+endforeach()
+
+file(WRITE "${OUTPUT}" "${_csv}")
+message(STATUS "Header cost written to ${OUTPUT}")
+
+if(NOT DEFINED BASELINE OR BASELINE STREQUAL "")
+    return()
+endif()
+if(NOT EXISTS "${BASELINE}")
+    message(FATAL_ERROR "HeaderCost.cmake: baseline ${BASELINE} does not exist")
+endif()
+
+set(_regressions "")
+file(STRINGS "${BASELINE}" _baseline_rows)
+foreach(_row IN LISTS _baseline_rows)
+    if(NOT _row MATCHES "^([^,]+\\.hxx),([0-9]+),([0-9]+),([0-9]*)$")
+        continue()   # header line
+    endif()
+    set(_header ${CMAKE_MATCH_1})
+    set(_old_kb ${CMAKE_MATCH_2})
+    set(_old_parse ${CMAKE_MATCH_3})
+    set(_old_instantiate "${CMAKE_MATCH_4}")
+    string(REGEX REPLACE "\\.hxx$" "" _id "${_header}")
+    string(REPLACE "/" "_" _id "${_id}")
+    if(NOT DEFINED _kb_${_id})
+        continue()   # header removed or renamed
+    endif()
+
+    math(EXPR _kb_limit "${_old_kb} + ${_old_kb} * ${SIZE_TOLERANCE} / 100")
+    if(_kb_${_id} GREATER _kb_limit)
+        string(APPEND _regressions
+               "  lbnl/${_header}: preprocessed ${_old_kb} KB -> ${_kb_${_id}} KB\n")
+    endif()
+
+    set(_old_ms ${_old_parse})
+    if(NOT _old_instantiate STREQUAL "")
+        math(EXPR _old_ms "${_old_parse} + ${_old_instantiate}")
+    endif()
+    math(EXPR _ms_limit "${_old_ms} + ${_old_ms} * ${TIME_TOLERANCE} / 100")
+    math(EXPR _ms_delta "${_ms_${_id}} - ${_old_ms}")
+    if(_ms_${_id} GREATER _ms_limit AND _ms_delta GREATER MIN_TIME_DELTA_MS)
+        string(APPEND _regressions "  lbnl/${_header}: ${_old_ms} ms -> ${_ms_${_id}} ms\n")
+    endif()
+endforeach()
+
+if(NOT _regressions STREQUAL "")
+    message(FATAL_ERROR "Header cost regressions against ${BASELINE}:\n${_regressions}")
+endif()
+message(STATUS "No header cost regressions against ${BASELINE}")
@@ -0,0 +1,34 @@
+// algorithm/element_forwarding.hxx
+#pragma once
+
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace lbnl
+{
+    namespace detail
+    {
+        // Elements may be moved from when the range yields temporaries, or when it is an owning
+        // range passed as an rvalue. Views passed as rvalues are not moved from, since they refer
+        // to elements owned elsewhere.
+        template<typename R>
+        inline constexpr bool moves_elements_v =
+          !std::is_lvalue_reference_v<std::ranges::range_reference_t<R>>
+          || (!std::is_lvalue_reference_v<R> && !std::ranges::view<std::remove_cvref_t<R>>);
+
+        template<typename R, typename Element>
+        constexpr decltype(auto) element_from(Element & element)
+        {
+            if constexpr(moves_elements_v<R>)
+            {
+                return std::move(element);
+            }
+            else
+            {
+                return static_cast<Element &>(element);
+            }
+        }
+    }   // namespace detail
+
+}   // namespace lbnl
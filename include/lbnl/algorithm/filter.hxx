@@ -0,0 +1,67 @@
+// algorithm/filter.hxx
+#pragma once
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace lbnl
+{
+    //! Filters elements in a range based on a predicate.
+    //!
+    //! This function iterates through the input range and includes only those elements
+    //! that satisfy the given predicate.
+    //!
+    //! \tparam R The type of the input range (must satisfy std::ranges::range).
+    //! \tparam Predicate A callable that takes a const reference to an element and returns a
+    //! boolean.
+    //! \param range The range of elements to filter.
+    //! \param predicate The condition used to determine which elements to include.
+    //! \return A vector containing the elements from the input range that satisfy the predicate.
+    template<std::ranges::range R, typename Predicate>
+    [[nodiscard]] constexpr auto filter(const R & range, Predicate predicate)
+    {
+        std::vector<std::ranges::range_value_t<R>> result;
+        if constexpr(std::ranges::sized_range<R>)
+        {
+            result.reserve(std::ranges::size(range));
+        }
+        std::ranges::for_each(range, [&](const auto & element) {
+            if(predicate(element))
+            {
+                result.push_back(element);
+            }
+        });
+        return result;
+    }
+
+    //! Partitions a range into two groups based on a predicate.
+    //! \tparam R The type of the range (must satisfy std::ranges::range).
+    //! \tparam Predicate A callable that takes a const reference to a range element and returns a
+    //! boolean.
+    //! \param range The range of elements to partition.
+    //! \param predicate The condition to partition elements.
+    //! \return A pair of vectors, where the first contains elements that satisfy the predicate, and
+    //! the second contains the rest.
+    template<std::ranges::range R, typename Predicate>
+    [[nodiscard]] constexpr auto partition(const R & range, Predicate predicate)
+    {
+        std::pair<std::vector<std::ranges::range_value_t<R>>,
+                  std::vector<std::ranges::range_value_t<R>>>
+          result;
+        for(const auto & element : range)
+        {
+            if(predicate(element))
+            {
+                result.first.push_back(element);
+            }
+            else
+            {
+                result.second.push_back(element);
+            }
+        }
+        return result;
+    }
+
+}   // namespace lbnl
@@ -0,0 +1,31 @@
+// algorithm/flatten.hxx
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace lbnl
+{
+    //! Flattens a nested vector into a single vector.
+    //! \tparam T The type of the elements in the inner vectors.
+    //! \param nested The nested vector to flatten.
+    //! \return A single vector containing all elements from the nested vector.
+    template<typename T>
+    [[nodiscard]] constexpr std::vector<T> flatten(const std::vector<std::vector<T>> & nested)
+    {
+        size_t total = 0;
+        for(const auto & inner : nested)
+        {
+            total += inner.size();
+        }
+
+        std::vector<T> result;
+        result.reserve(total);
+        for(const auto & inner : nested)
+        {
+            result.insert(result.end(), inner.begin(), inner.end());
+        }
+        return result;
+    }
+
+}   // namespace lbnl
@@ -0,0 +1,45 @@
+// algorithm/search.hxx
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+
+namespace lbnl
+{
+    //! Finds the first element in the container that satisfies the given predicate.
+    //! \tparam Container The type of the container.
+    //! \tparam Predicate A callable that takes a const reference to a container element and returns
+    //! a boolean.
+    //! \param elements The container to search through.
+    //! \param predicate The condition to be satisfied by the element.
+    //! \return An optional containing the first element that satisfies the predicate, or
+    //! std::nullopt if no such element exists.
+    template<typename Container, std::predicate<const typename Container::value_type &> Predicate>
+    [[nodiscard]] constexpr std::optional<std::decay_t<typename Container::value_type>>
+      find_element(const Container & elements, Predicate predicate)
+    {
+        auto it = std::ranges::find_if(elements, predicate);
+        if(it != std::ranges::cend(elements))
+        {
+            return *it;
+        }
+        return std::nullopt;
+    }
+
+    //! Checks if the container contains a specific value.
+    //! Note: This is a C++20 compatible implementation. In C++23, prefer std::ranges::contains.
+    //! \tparam Container The type of the container.
+    //! \tparam T The type of the value to search for.
+    //! \param elements The container to search through.
+    //! \param value The value to search for.
+    //! \return True if the value is found, false otherwise.
+    template<typename Container, typename T>
+    [[nodiscard]] constexpr bool contains(const Container & elements, const T & value)
+    {
+        return std::ranges::find(elements, value) != std::ranges::cend(elements);
+    }
+
+}   // namespace lbnl
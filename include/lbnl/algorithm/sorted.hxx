@@ -0,0 +1,46 @@
+// algorithm/sorted.hxx
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <vector>
+
+namespace lbnl
+{
+    //! Removes duplicate elements from a container.
+    //! Note: This function sorts the elements before removing duplicates,
+    //! so the original order is NOT preserved. The result is sorted.
+    //! \tparam R The type of the range (must satisfy std::ranges::range).
+    //! \param range The range of elements to process.
+    //! \return A new sorted vector with duplicates removed.
+    template<std::ranges::range R>
+    [[nodiscard]] constexpr auto sorted_unique(const R & range)
+    {
+        using ValueType = std::ranges::range_value_t<R>;
+
+        std::vector<ValueType> result(range.begin(), range.end());
+        std::ranges::sort(result);
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+
+        return result;
+    }
+
+    //! Merges two sorted ranges into a single sorted range.
+    //! \pre Both range1 and range2 MUST be sorted in ascending order.
+    //!      Passing unsorted ranges results in undefined behavior.
+    //! \tparam R1 The type of the first range.
+    //! \tparam R2 The type of the second range.
+    //! \param range1 The first sorted range.
+    //! \param range2 The second sorted range.
+    //! \return A vector containing the merged sorted elements.
+    template<std::ranges::range R1, std::ranges::range R2>
+    [[nodiscard]] constexpr auto merge(const R1 & range1, const R2 & range2)
+    {
+        std::vector<std::ranges::range_value_t<R1>> result;
+        result.reserve(std::ranges::distance(range1) + std::ranges::distance(range2));
+        std::ranges::merge(range1, range2, std::back_inserter(result));
+        return result;
+    }
+
+}   // namespace lbnl
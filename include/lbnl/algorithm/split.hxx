@@ -0,0 +1,41 @@
+// algorithm/split.hxx
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lbnl
+{
+    //! Splits a string into a vector of substrings based on a delimiter.
+    //! \param str The string to split.
+    //! \param delimiter The character used to split the string.
+    //! \return A vector of substrings.
+    template<typename Str, typename CharT = typename std::decay_t<Str>::value_type>
+    [[nodiscard]] constexpr std::vector<std::basic_string<CharT>> split(Str && str, CharT delimiter)
+    {
+        std::basic_string_view<CharT> view{std::forward<Str>(str)};
+        std::vector<std::basic_string<CharT>> result;
+
+        if(view.empty())
+        {
+            return result;
+        }
+
+        size_t start = 0;
+        while(start <= view.size())
+        {
+            size_t end = view.find(delimiter, start);
+            if(end == std::basic_string_view<CharT>::npos)
+                end = view.size();
+            result.emplace_back(view.substr(start, end - start));
+            start = end + 1;
+        }
+
+        return result;
+    }
+
+}   // namespace lbnl
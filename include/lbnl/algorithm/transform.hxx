@@ -0,0 +1,91 @@
+// algorithm/transform.hxx
+#pragma once
+
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lbnl
+{
+    //! Applies a transformation to elements in a range that satisfy a predicate, returning a new
+    //! container.
+    //!
+    //! This function processes each element in the input range. If an element satisfies the given
+    //! predicate, the transformation function is applied to it; otherwise, the element is copied
+    //! unchanged.
+    //!
+    //! \tparam R The type of the range (must satisfy std::ranges::range).
+    //! \tparam Predicate A callable that takes a const reference to a range element and returns a
+    //! boolean.
+    //! \tparam Func A callable that takes a const reference to a range element and returns a
+    //! transformed value.
+    //! \param range The input range to process.
+    //! \param pred The predicate to determine which elements to transform.
+    //! \param func The transformation function applied to elements that satisfy the predicate.
+    //! \return A new vector where matching elements are transformed and others are copied as-is.
+    template<std::ranges::range R, typename Predicate, typename Func>
+    [[nodiscard]] constexpr auto transform_if(const R & range, Predicate pred, Func func)
+    {
+        using Value = std::ranges::range_value_t<R>;
+        std::vector<Value> result;
+        result.reserve(std::ranges::distance(range));
+
+        for(const auto & element : range)
+        {
+            result.push_back(pred(element) ? func(element) : element);
+        }
+
+        return result;
+    }
+
+    //! Applies a transformation to elements in a range that satisfy a predicate.
+    //!
+    //! \tparam R The type of the input range (must satisfy std::ranges::range).
+    //! \tparam Predicate A callable that returns true for elements to be transformed.
+    //! \tparam Func A callable that transforms a matching element.
+    //! \param range The input range to process.
+    //! \param pred The predicate used to select elements.
+    //! \param func The function used to transform selected elements.
+    //! \return A vector of transformed elements that passed the predicate.
+    template<std::ranges::range R, typename Predicate, typename Func>
+    [[nodiscard]] constexpr auto transform_filter(const R & range, Predicate pred, Func func)
+    {
+        using ResultType = std::invoke_result_t<Func, std::ranges::range_value_t<R>>;
+        std::vector<ResultType> result;
+
+        for(const auto & element : range)
+        {
+            if(pred(element))
+            {
+                result.push_back(func(element));
+            }
+        }
+
+        return result;
+    }
+
+    //! Converts a range into a vector.
+    //! \tparam R The type of the range (must satisfy std::ranges::input_range).
+    //! \param r The range to convert.
+    //! \return A vector containing all elements from the range.
+    template<std::ranges::input_range R>
+    [[nodiscard]] constexpr auto to_vector(R && r)
+    {
+        using T = std::ranges::range_value_t<R>;
+        return std::vector<T>(std::ranges::begin(r), std::ranges::end(r));
+    }
+
+    //! Transforms a range into a vector by applying a function to each element.
+    //! \tparam R The type of the range (must satisfy std::ranges::input_range).
+    //! \tparam Func A callable that takes a range element and returns a transformed value.
+    //! \param range The range of elements to transform.
+    //! \param func The transformation function to apply.
+    //! \return A vector containing the transformed elements.
+    template<std::ranges::input_range R, typename Func>
+    [[nodiscard]] constexpr auto transform_to_vector(R && range, Func && func)
+    {
+        return to_vector(range | std::views::transform(std::forward<Func>(func)));
+    }
+
+}   // namespace lbnl
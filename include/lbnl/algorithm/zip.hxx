@@ -0,0 +1,42 @@
+// algorithm/zip.hxx
+#pragma once
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace lbnl
+{
+    //! Combines two containers into a single container of pairs.
+    //! \tparam R1 The type of the first container.
+    //! \tparam R2 The type of the second container.
+    //! \param r1 The first container.
+    //! \param r2 The second container.
+    //! \return A vector of pairs, where each pair contains one element from each container.
+    template<std::ranges::input_range R1, std::ranges::input_range R2>
+    [[nodiscard]] constexpr auto zip(R1 && r1, R2 && r2)
+    {
+        using T1 = std::ranges::range_value_t<R1>;
+        using T2 = std::ranges::range_value_t<R2>;
+        std::vector<std::pair<T1, T2>> result;
+
+        if constexpr(std::ranges::sized_range<R1> && std::ranges::sized_range<R2>)
+        {
+            // Parentheses around std::min prevent Windows min/max macro expansion
+            result.reserve((std::min)(std::ranges::size(r1), std::ranges::size(r2)));
+        }
+
+        auto it1 = std::ranges::begin(r1);
+        auto it2 = std::ranges::begin(r2);
+        auto end1 = std::ranges::end(r1);
+        auto end2 = std::ranges::end(r2);
+
+        for(; it1 != end1 && it2 != end2; ++it1, ++it2)
+        {
+            result.emplace_back(*it1, *it2);
+        }
+        return result;
+    }
+
+}   // namespace lbnl
@@ -0,0 +1,375 @@
+// compact_optional.hxx
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "optional.hxx"
+
+namespace lbnl
+{
+    //
+    // Empty-state policies for CompactOptional. A policy reserves one value of T to mean
+    // "empty": empty_value() returns it and is_empty(v) recognizes it.
+    //
+    template<typename P, typename T>
+    concept CompactOptionalPolicy = requires(const T & value) {
+        { P::empty_value() } -> std::same_as<T>;
+        { P::is_empty(value) } -> std::convertible_to<bool>;
+    };
+
+    namespace detail
+    {
+        template<typename T>
+        struct nan_bits;
+
+        // Quiet NaNs with payload 1: distinct from std::numeric_limits<T>::quiet_NaN() and from
+        // the NaN produced by invalid arithmetic such as 0.0 / 0.0.
+        template<>
+        struct nan_bits<float>
+        {
+            using type = std::uint32_t;
+            static constexpr type empty = 0x7FC0'0001u;
+        };
+
+        template<>
+        struct nan_bits<double>
+        {
+            using type = std::uint64_t;
+            static constexpr type empty = 0x7FF8'0000'0000'0001ull;
+        };
+    }   // namespace detail
+
+    //! Floating point: empty is one specific NaN bit pattern. Other NaNs are ordinary values.
+    template<typename T, typename detail::nan_bits<T>::type Bits = detail::nan_bits<T>::empty>
+        requires std::same_as<T, float> || std::same_as<T, double>
+    struct NaNPolicy
+    {
+        static constexpr T empty_value() noexcept
+        {
+            return std::bit_cast<T>(Bits);
+        }
+
+        static constexpr bool is_empty(T value) noexcept
+        {
+            return std::bit_cast<typename detail::nan_bits<T>::type>(value) == Bits;
+        }
+    };
+
+    //! Integers and enums: empty is the given sentinel value.
+    template<typename T, T Sentinel>
+        requires std::integral<T> || std::is_enum_v<T>
+    struct SentinelPolicy
+    {
+        static constexpr T empty_value() noexcept
+        {
+            return Sentinel;
+        }
+
+        static constexpr bool is_empty(T value) noexcept
+        {
+            return value == Sentinel;
+        }
+    };
+
+    //! Pointers: empty is nullptr.
+    template<typename T>
+        requires std::is_pointer_v<T>
+    struct NullPointerPolicy
+    {
+        static constexpr T empty_value() noexcept
+        {
+            return nullptr;
+        }
+
+        static constexpr bool is_empty(T value) noexcept
+        {
+            return value == nullptr;
+        }
+    };
+
+    //! Policy used when none is given: NaNPolicy for float/double, NullPointerPolicy for
+    //! pointers. Integers have no natural spare value and must name a SentinelPolicy.
+    template<typename T>
+    struct default_compact_policy
+    {
+        using type = void;
+    };
+
+    template<typename T>
+        requires std::same_as<T, float> || std::same_as<T, double>
+    struct default_compact_policy<T>
+    {
+        using type = NaNPolicy<T>;
+    };
+
+    template<typename T>
+        requires std::is_pointer_v<T>
+    struct default_compact_policy<T>
+    {
+        using type = NullPointerPolicy<T>;
+    };
+
+    template<typename T>
+    using default_compact_policy_t = typename default_compact_policy<T>::type;
+
+    template<typename T, typename Policy = default_compact_policy_t<T>>
+    class CompactOptional;
+
+    template<typename T>
+    struct is_compact_optional : std::false_type
+    {};
+
+    template<typename T, typename Policy>
+    struct is_compact_optional<CompactOptional<T, Policy>> : std::true_type
+    {};
+
+    namespace detail
+    {
+        // Result of map() on CompactOptional<T, Policy> producing a U: stays compact when U
+        // is T (same policy) or has a default policy, otherwise falls back to OptionalExt<U>.
+        template<typename U, typename T, typename Policy>
+        struct compact_map_result
+        {
+            using type = OptionalExt<U>;
+        };
+
+        template<typename T, typename Policy>
+        struct compact_map_result<T, T, Policy>
+        {
+            using type = CompactOptional<T, Policy>;
+        };
+
+        template<typename U, typename T, typename Policy>
+            requires(!std::same_as<U, T>) && (!std::is_void_v<default_compact_policy_t<U>>)
+        struct compact_map_result<U, T, Policy>
+        {
+            using type = CompactOptional<U>;
+        };
+    }   // namespace detail
+
+    //
+    // CompactOptional<T, Policy>: an optional that is exactly sizeof(T). The empty state is
+    // stored as a value T never holds in practice (a reserved NaN, a sentinel integer, a null
+    // pointer), chosen by Policy, instead of in a separate flag. A
+    // std::vector<CompactOptional<double>> therefore takes half the memory of a
+    // std::vector<std::optional<double>>.
+    //
+    // The monadic API matches OptionalExt. Storing the reserved value itself yields an empty
+    // optional.
+    //
+    template<typename T, typename Policy>
+    class CompactOptional
+    {
+        static_assert(!std::is_void_v<Policy>,
+                      "CompactOptional: T has no default empty-state policy; "
+                      "name one, e.g. CompactOptional<int, SentinelPolicy<int, -1>>");
+        static_assert(CompactOptionalPolicy<Policy, T>, "CompactOptional: invalid policy for T");
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "CompactOptional is for trivially copyable types");
+
+    public:
+        using value_type = T;
+        using policy_type = Policy;
+
+        constexpr CompactOptional() noexcept : m_value(Policy::empty_value())
+        {}
+
+        constexpr CompactOptional(std::nullopt_t) noexcept : m_value(Policy::empty_value())
+        {}
+
+        constexpr CompactOptional(T value) noexcept : m_value(value)
+        {}
+
+        explicit constexpr CompactOptional(const std::optional<T> & opt) noexcept :
+            m_value(opt ? *opt : Policy::empty_value())
+        {}
+
+        //! Check if the optional contains a value
+        [[nodiscard]] constexpr bool has_value() const noexcept
+        {
+            return !Policy::is_empty(m_value);
+        }
+
+        //! Explicit bool conversion operator
+        [[nodiscard]] constexpr explicit operator bool() const noexcept
+        {
+            return has_value();
+        }
+
+        //! Access the contained value (undefined behavior if empty)
+        [[nodiscard]] constexpr const T & operator*() const noexcept
+        {
+            return m_value;
+        }
+
+        [[nodiscard]] constexpr T & operator*() noexcept
+        {
+            return m_value;
+        }
+
+        [[nodiscard]] constexpr const T * operator->() const noexcept
+        {
+            return std::addressof(m_value);
+        }
+
+        [[nodiscard]] constexpr T * operator->() noexcept
+        {
+            return std::addressof(m_value);
+        }
+
+        //! Throws std::bad_optional_access if empty
+        [[nodiscard]] constexpr const T & value() const
+        {
+            if(!has_value())
+            {
+                throw std::bad_optional_access();
+            }
+            return m_value;
+        }
+
+        //! Returns the contained value if present, or a fallback value otherwise.
+        template<typename U>
+        [[nodiscard]] constexpr T value_or(U && fallback) const
+        {
+            return has_value() ? m_value : static_cast<T>(std::forward<U>(fallback));
+        }
+
+        constexpr T & emplace(T value) noexcept
+        {
+            m_value = value;
+            return m_value;
+        }
+
+        constexpr void reset() noexcept
+        {
+            m_value = Policy::empty_value();
+        }
+
+        //! Applies a function if this optional contains a value. The function may return a plain
+        //! value (treated like map()), a std::optional, an OptionalExt, a CompactOptional or void.
+        template<typename Func>
+        constexpr auto and_then(Func && func) const
+        {
+            using RR = std::remove_cvref_t<std::invoke_result_t<Func, const T &>>;
+
+            if constexpr(std::is_void_v<RR>)
+            {
+                if(has_value())
+                {
+                    std::invoke(std::forward<Func>(func), m_value);
+                    return OptionalExt<std::monostate>(std::monostate{});
+                }
+                return OptionalExt<std::monostate>(std::nullopt);
+            }
+            else if constexpr(is_compact_optional<RR>::value)
+            {
+                return has_value() ? RR(std::invoke(std::forward<Func>(func), m_value)) : RR();
+            }
+            else if constexpr(is_std_optional<RR>::value || is_optional_ext<RR>::value)
+            {
+                if(!has_value())
+                {
+                    return detail::to_ext_empty<RR>();
+                }
+                return detail::to_ext_from(std::invoke(std::forward<Func>(func), m_value));
+            }
+            else
+            {
+                return map(std::forward<Func>(func));
+            }
+        }
+
+        //! Returns this if present, otherwise calls the fallback. A void fallback is run for its
+        //! side effect and gives OptionalExt<std::monostate>, as in OptionalExt::or_else.
+        template<typename Func>
+        constexpr auto or_else(Func && func) const
+        {
+            using Result = std::invoke_result_t<Func>;
+
+            if constexpr(std::is_void_v<Result>)
+            {
+                if(!has_value())
+                {
+                    std::invoke(std::forward<Func>(func));
+                }
+                return OptionalExt<std::monostate>(std::monostate{});
+            }
+            else
+            {
+                return has_value() ? *this : CompactOptional(std::invoke(std::forward<Func>(func)));
+            }
+        }
+
+        //! Transforms the value. The result is CompactOptional when the new type is T or has a
+        //! default policy (float, double, pointers), and OptionalExt otherwise.
+        template<typename Func>
+        constexpr auto map(Func && func) const
+        {
+            using U = std::remove_cvref_t<std::invoke_result_t<Func, const T &>>;
+            using Ret = typename detail::compact_map_result<U, T, Policy>::type;
+            if(has_value())
+            {
+                return Ret(std::invoke(std::forward<Func>(func), m_value));
+            }
+            return Ret(std::nullopt);
+        }
+
+        // C++23-like synonym for map
+        template<typename Func>
+        constexpr auto transform(Func && func) const
+        {
+            return map(std::forward<Func>(func));
+        }
+
+        //! The stored representation: the value, or Policy::empty_value() when empty
+        [[nodiscard]] constexpr const T & raw() const noexcept
+        {
+            return m_value;
+        }
+
+        [[nodiscard]] constexpr std::optional<T> to_optional() const
+        {
+            return has_value() ? std::optional<T>(m_value) : std::nullopt;
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const CompactOptional & lhs,
+                                                       const CompactOptional & rhs)
+        {
+            if(lhs.has_value() != rhs.has_value())
+            {
+                return false;
+            }
+            return !lhs.has_value() || (lhs.m_value == rhs.m_value);
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const CompactOptional & lhs,
+                                                       std::nullopt_t) noexcept
+        {
+            return !lhs.has_value();
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const CompactOptional & lhs, const T & val)
+        {
+            return lhs.has_value() && lhs.m_value == val;
+        }
+
+    private:
+        T m_value;
+    };
+
+    // Adapter: lift a std::optional<T> into a CompactOptional with T's default policy.
+    template<typename T>
+    [[nodiscard]] constexpr auto compact(const std::optional<T> & opt)
+    {
+        return CompactOptional<T>(opt);
+    }
+
+}   // namespace lbnl
@@ -0,0 +1,94 @@
+// detail/parallel_for.hxx
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace lbnl
+{
+    namespace detail
+    {
+        // Calls func(index) for every index in [0, count) on up to concurrency threads, the
+        // calling thread included, and returns once all of them have finished. Indices are
+        // claimed in increasing order. No new index is claimed after func throws or, when func
+        // returns bool, after it returns false. The first exception thrown is rethrown at the
+        // end. If a thread cannot be started, the ones already running share the work.
+        template<typename Func>
+        void parallel_for(std::size_t count, std::size_t concurrency, Func && func)
+        {
+            using Result = std::invoke_result_t<Func &, std::size_t>;
+            constexpr bool stoppable = std::is_same_v<Result, bool>;
+
+            std::atomic<std::size_t> next{0};
+            std::atomic<bool> stop{false};
+            std::mutex exceptionMutex;
+            std::exception_ptr exception;
+
+            auto worker = [&]() {
+                while(!stop.load(std::memory_order_relaxed))
+                {
+                    const auto index = next++;
+                    if(index >= count)
+                    {
+                        return;
+                    }
+                    try
+                    {
+                        if constexpr(stoppable)
+                        {
+                            if(!func(index))
+                            {
+                                stop.store(true, std::memory_order_relaxed);
+                            }
+                        }
+                        else
+                        {
+                            func(index);
+                        }
+                    }
+                    catch(...)
+                    {
+                        stop.store(true, std::memory_order_relaxed);
+                        std::lock_guard lock(exceptionMutex);
+                        if(!exception)
+                        {
+                            exception = std::current_exception();
+                        }
+                    }
+                }
+            };
+
+            const auto threadCount = (std::min)((std::max)(concurrency, std::size_t{1}), count);
+            std::vector<std::thread> threads;
+            for(std::size_t idx = 1; idx < threadCount; ++idx)
+            {
+                try
+                {
+                    threads.emplace_back(worker);
+                }
+                catch(const std::system_error &)
+                {
+                    break;   // out of threads: the ones already running share the remaining work
+                }
+            }
+            worker();   // the calling thread is one of the workers
+            for(auto & thread : threads)
+            {
+                thread.join();
+            }
+
+            if(exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+    }   // namespace detail
+
+}   // namespace lbnl
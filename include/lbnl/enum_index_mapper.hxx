@@ -1,8 +1,15 @@
 // enum_index_mapper.hxx
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <span>
+#include <stdexcept>
 #include <utility>
 #include <type_traits>
 
@@ -13,9 +20,172 @@ namespace lbnl
     template<class E>
     concept Enum = std::is_enum_v<E>;
 
+    namespace detail
+    {
+        // Integral type of an int or an enum (its underlying type)
+        template<typename T>
+        struct integral_of
+        {
+            using type = T;
+        };
+
+        template<Enum T>
+        struct integral_of<T>
+        {
+            using type = std::underlying_type_t<T>;
+        };
+
+        template<typename T>
+        using integral_of_t = typename integral_of<T>::type;
+
+        // Finds the position of an integral key among N unique keys, built once (usually at
+        // compile time). Keys spanning at most 2N consecutive values use a dense table (one
+        // subtraction and one load); sparser keys use a sorted table and binary search.
+        // The two tables share storage, since build() picks one of them.
+        template<typename T, std::size_t N>
+        class KeyPositionTable
+        {
+            static_assert(N < 0xFFFFFFFF, "too many entries for 32-bit positions");
+
+        public:
+            using key_type = T;
+
+            static constexpr std::size_t dense_capacity = 2 * N;
+
+            // Returns false if keys contains a duplicate.
+            constexpr bool build(const std::array<T, N> & keys)
+            {
+                if constexpr(N == 0)
+                {
+                    return true;
+                }
+                else
+                {
+                    const auto [lo, hi] = std::minmax_element(keys.begin(), keys.end());
+                    min_ = *lo;
+                    dense_ = offset(*hi) < dense_capacity;
+
+                    if(dense_)
+                    {
+                        dense_table_.fill(static_cast<std::uint32_t>(N));
+                        for(std::size_t pos = 0; pos < N; ++pos)
+                        {
+                            auto & slot = dense_table_[offset(keys[pos])];
+                            if(slot != N)
+                                return false;
+                            slot = static_cast<std::uint32_t>(pos);
+                        }
+                        return true;
+                    }
+
+                    sorted_ = {};   // makes the sorted table the active member
+                    for(std::size_t pos = 0; pos < N; ++pos)
+                        sorted_[pos] = {keys[pos], static_cast<std::uint32_t>(pos)};
+                    std::sort(sorted_.begin(), sorted_.end());
+                    auto same_key = [](auto const & a, auto const & b) { return a.key == b.key; };
+                    return std::adjacent_find(sorted_.begin(), sorted_.end(), same_key)
+                           == sorted_.end();
+                }
+            }
+
+            [[nodiscard]] constexpr std::optional<std::size_t> find(T key) const
+            {
+                const auto pos = dense_ ? dense_position(key) : sorted_position(key);
+                if(pos >= N)
+                    return std::nullopt;
+                return pos;
+            }
+
+            // Position of key, or exactly N if absent. Branchless: keys below the minimum wrap
+            // to a large offset and fail the same bounds test as keys above the maximum; the
+            // clamped load is then replaced by N with a select, whatever the last slot holds.
+            // Only valid when is_dense().
+            [[nodiscard]] constexpr std::size_t dense_position(T key) const
+            {
+                if constexpr(N == 0)
+                {
+                    return 0;
+                }
+                else
+                {
+                    constexpr auto last = static_cast<offset_t>(dense_capacity - 1);
+                    const auto off = offset(key);
+                    const std::uint32_t slot = dense_table_[(std::min)(off, last)];
+                    const auto outside = static_cast<std::uint32_t>(off >= dense_capacity);
+                    const auto absent = static_cast<std::uint32_t>(N);
+                    return slot ^ ((slot ^ absent) & (0u - outside));
+                }
+            }
+
+            // Position of key, or N if absent, by binary search. Only valid when !is_dense().
+            [[nodiscard]] constexpr std::size_t sorted_position(T key) const
+            {
+                auto less = [](auto const & entry, T k) { return entry.key < k; };
+                auto it = std::lower_bound(sorted_.begin(), sorted_.end(), key, less);
+                if(it == sorted_.end() || it->key != key)
+                    return N;
+                return it->position;
+            }
+
+            [[nodiscard]] constexpr bool is_dense() const
+            {
+                return dense_;
+            }
+
+        private:
+            // Offsets are computed modulo 2^32 (2^64 for 64-bit keys): keys below the minimum
+            // wrap to large offsets. 32-bit offsets keep the bulk kernels gather-friendly.
+            using offset_t = std::conditional_t<(sizeof(T) <= 4), std::uint32_t, std::uint64_t>;
+
+            // Distance from the smallest key; meaningful only when key >= min_.
+            [[nodiscard]] constexpr offset_t offset(T key) const
+            {
+                return static_cast<offset_t>(static_cast<offset_t>(key)
+                                             - static_cast<offset_t>(min_));
+            }
+
+            // Trivial, so that assigning the sorted table switches the active union member
+            struct SortedEntry
+            {
+                T key;
+                std::uint32_t position;
+
+                friend constexpr auto operator<=>(const SortedEntry &,
+                                                  const SortedEntry &) = default;
+            };
+
+            T min_{};
+            bool dense_{false};
+            union
+            {
+                // 32-bit positions: the narrowest element width hardware gathers support
+                std::array<std::uint32_t, dense_capacity> dense_table_{};   // position, N = absent
+                std::array<SortedEntry, N> sorted_;
+            };
+        };
+    }   // namespace detail
+
+    // Outcome of a bulk conversion (EnumIndexMapper::to_enums / to_indices).
+    struct BulkConversion
+    {
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        std::size_t invalid{0};            // number of inputs without a mapping
+        std::size_t first_invalid{npos};   // position of the first one, npos if none
+
+        [[nodiscard]] constexpr bool ok() const
+        {
+            return invalid == 0;
+        }
+    };
+
     // Bidirectional mapping between DB index (int) and Enum.
     // Storage is a constexpr std::array of (index, enum) pairs.
-    // Lookups are O(N) linear scans — fine for small enums and constexpr-friendly.
+    // Both directions are indexed on construction, so a constexpr mapper builds its tables at
+    // compile time: a dense array when the values span at most 2N consecutive integers,
+    // otherwise a sorted table searched in O(log N).
+    // Duplicate indices or enums throw std::invalid_argument, which in a constexpr mapper
+    // is a compile error.
     template<Enum E, std::size_t N>
     class EnumIndexMapper
     {
@@ -25,21 +195,31 @@ namespace lbnl
 
         // The mapping is provided as a constexpr array of unique pairs.
         constexpr explicit EnumIndexMapper(storage_t mapping) : mapping_{mapping}
-        {}
+        {
+            std::array<int, N> indices{};
+            std::array<underlying_t, N> values{};
+            for(std::size_t pos = 0; pos < N; ++pos)
+            {
+                indices[pos] = mapping_[pos].first;
+                values[pos] = static_cast<underlying_t>(mapping_[pos].second);
+            }
+            if(!by_index_.build(indices))
+                throw std::invalid_argument("EnumIndexMapper: duplicate index");
+            if(!by_enum_.build(values))
+                throw std::invalid_argument("EnumIndexMapper: duplicate enum");
+        }
 
         [[nodiscard]] constexpr std::optional<E> to_enum(int index) const
         {
-            for(auto const & p : mapping_)
-                if(p.first == index)
-                    return p.second;
+            if(auto pos = by_index_.find(index))
+                return mapping_[*pos].second;
             return std::nullopt;
         }
 
         [[nodiscard]] constexpr std::optional<int> to_index(E e) const
         {
-            for(auto const & p : mapping_)
-                if(p.second == e)
-                    return p.first;
+            if(auto pos = by_enum_.find(static_cast<underlying_t>(e)))
+                return mapping_[*pos].first;
             return std::nullopt;
         }
 
@@ -58,14 +238,136 @@ namespace lbnl
             return fallback;
         }
 
+        // Bulk conversion of a column of indices. out must be at least as long as indices.
+        // Inputs without a mapping are written as fallback and counted in the result.
+        // With dense indices the loop is branchless, so the compiler can vectorize it.
+        constexpr BulkConversion
+          to_enums(std::span<const int> indices, std::span<E> out, E fallback) const
+        {
+            return convert(by_index_, indices, out, fallback, {}, same_index, enum_of);
+        }
+
+        // As above, and sets bit (i % 64) of valid[i / 64] when indices[i] has a mapping.
+        // valid must hold at least (indices.size() + 63) / 64 words.
+        constexpr BulkConversion to_enums(std::span<const int> indices,
+                                          std::span<E> out,
+                                          E fallback,
+                                          std::span<std::uint64_t> valid) const
+        {
+            return convert(by_index_, indices, out, fallback, valid, same_index, enum_of);
+        }
+
+        // Bulk conversion of a column of enums back to indices; see to_enums.
+        constexpr BulkConversion
+          to_indices(std::span<const E> enums, std::span<int> out, int fallback) const
+        {
+            return convert(by_enum_, enums, out, fallback, {}, to_underlying, index_of);
+        }
+
+        constexpr BulkConversion to_indices(std::span<const E> enums,
+                                            std::span<int> out,
+                                            int fallback,
+                                            std::span<std::uint64_t> valid) const
+        {
+            return convert(by_enum_, enums, out, fallback, valid, to_underlying, index_of);
+        }
+
         // Expose mapping for iteration or tests
         [[nodiscard]] constexpr storage_t const & data() const
         {
             return mapping_;
         }
 
+        // True when the index -> enum direction uses a dense table rather than binary search
+        [[nodiscard]] constexpr bool dense_indices() const
+        {
+            return by_index_.is_dense();
+        }
+
+        // True when the enum -> index direction uses a dense table rather than binary search
+        [[nodiscard]] constexpr bool dense_enums() const
+        {
+            return by_enum_.is_dense();
+        }
+
     private:
+        using underlying_t = std::underlying_type_t<E>;
+
+        static constexpr auto to_underlying = [](E e) { return static_cast<underlying_t>(e); };
+        static constexpr auto same_index = [](int i) { return i; };
+        static constexpr auto enum_of = [](pair_type const & p) { return p.second; };
+        static constexpr auto index_of = [](pair_type const & p) { return p.first; };
+
+        // Shared kernel of the bulk conversions. Works in blocks of 64 inputs so each block
+        // produces one word of the validity mask; the per-element loop has no branches when
+        // the table is dense.
+        template<typename Key, typename In, typename Out, typename KeyOf, typename Target>
+        constexpr BulkConversion convert(detail::KeyPositionTable<Key, N> const & table,
+                                         std::span<const In> in,
+                                         std::span<Out> out,
+                                         Out fallback,
+                                         std::span<std::uint64_t> valid,
+                                         KeyOf key_of,
+                                         Target target) const
+        {
+            if(out.size() < in.size())
+                throw std::invalid_argument("EnumIndexMapper: output span is shorter than input");
+            if(!valid.empty() && valid.size() < (in.size() + 63) / 64)
+                throw std::invalid_argument("EnumIndexMapper: validity mask is too short");
+
+            auto run_block = [&](std::size_t first, std::size_t last, auto position) {
+                std::uint64_t word = 0;
+                for(std::size_t i = first; i < last; ++i)
+                {
+                    const std::size_t pos = position(key_of(in[i]));
+                    const bool found = pos < N;
+                    if constexpr(N == 0)
+                    {
+                        out[i] = fallback;
+                    }
+                    else
+                    {
+                        // Both sides are computed and blended with a mask, so there is no
+                        // branch for the compiler to keep and the loop can be vectorized
+                        using bits_t = std::make_unsigned_t<detail::integral_of_t<Out>>;
+                        const auto mapped =
+                          static_cast<bits_t>(target(mapping_[(std::min)(pos, N - 1)]));
+                        const auto other = static_cast<bits_t>(fallback);
+                        const auto mask = static_cast<bits_t>(-static_cast<bits_t>(found));
+                        out[i] = static_cast<Out>((mapped & mask) | (other & ~mask));
+                    }
+                    word |= std::uint64_t{found} << (i - first);
+                }
+                return word;
+            };
+
+            BulkConversion result;
+            for(std::size_t first = 0; first < in.size(); first += 64)
+            {
+                const auto last = (std::min)(in.size(), first + 64);
+                auto dense = [&table](Key key) { return table.dense_position(key); };
+                auto sorted = [&table](Key key) { return table.sorted_position(key); };
+                const auto word = table.is_dense() ? run_block(first, last, dense)
+                                                   : run_block(first, last, sorted);
+
+                if(!valid.empty())
+                    valid[first / 64] = word;
+
+                const auto count = static_cast<std::size_t>(std::popcount(word));
+                if(count != last - first)
+                {
+                    if(result.invalid == 0)
+                        result.first_invalid =
+                          first + static_cast<std::size_t>(std::countr_one(word));
+                    result.invalid += (last - first) - count;
+                }
+            }
+            return result;
+        }
+
         storage_t mapping_;
+        detail::KeyPositionTable<int, N> by_index_{};
+        detail::KeyPositionTable<underlying_t, N> by_enum_{};
     };
 
     // Existing explicit version (keep it)
@@ -0,0 +1,734 @@
+// enum_map.hxx
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "enum_index_mapper.hxx"
+
+namespace lbnl
+{
+    // Compile-time numbering of the enum values a container can hold: slot(e) gives the
+    // position of e in [0, size), or size when e is outside the set, and value(i) is its inverse.
+    template<typename S>
+    concept EnumSlots = Enum<typename S::enum_type> && requires(typename S::enum_type e, std::size_t i) {
+        { S::size } -> std::convertible_to<std::size_t>;
+        { S::slot(e) } -> std::convertible_to<std::size_t>;
+        { S::value(i) } -> std::same_as<typename S::enum_type>;
+    };
+
+    // Slots for a contiguous range of enum values, First..Last inclusive.
+    template<auto First, auto Last>
+        requires Enum<decltype(First)> && std::same_as<decltype(First), decltype(Last)>
+    struct EnumRange
+    {
+        using enum_type = decltype(First);
+
+    private:
+        using underlying_t = std::underlying_type_t<enum_type>;
+        using wide_t = std::conditional_t<std::is_signed_v<underlying_t>, std::int64_t, std::uint64_t>;
+
+        static constexpr std::uint64_t offset(enum_type e)
+        {
+            return static_cast<std::uint64_t>(static_cast<wide_t>(static_cast<underlying_t>(e)))
+                   - static_cast<std::uint64_t>(static_cast<wide_t>(static_cast<underlying_t>(First)));
+        }
+
+        static_assert(static_cast<underlying_t>(First) <= static_cast<underlying_t>(Last),
+                      "EnumRange: First must not be greater than Last");
+
+    public:
+        static constexpr std::size_t size = static_cast<std::size_t>(offset(Last)) + 1;
+
+        static constexpr std::size_t slot(enum_type e)
+        {
+            const auto off = offset(e);
+            return off < size ? static_cast<std::size_t>(off) : size;
+        }
+
+        static constexpr enum_type value(std::size_t i)
+        {
+            return static_cast<enum_type>(static_cast<underlying_t>(
+              static_cast<wide_t>(static_cast<underlying_t>(First)) + static_cast<wide_t>(i)));
+        }
+    };
+
+    // Slots for the enums of a constexpr mapper (EnumIndexMapper, EnumStringMapper or anything
+    // with a data() array of pairs whose second member is the enum), numbered in table order.
+    template<auto & Mapper>
+    struct MappedEnumSlots
+    {
+    private:
+        using storage_t = std::remove_cvref_t<decltype(Mapper.data())>;
+
+    public:
+        using enum_type = typename storage_t::value_type::second_type;
+
+        static constexpr std::size_t size = std::tuple_size_v<storage_t>;
+
+        static constexpr std::size_t slot(enum_type e)
+        {
+            return table.find(static_cast<underlying_t>(e)).value_or(size);
+        }
+
+        static constexpr enum_type value(std::size_t i)
+        {
+            return Mapper.data()[i].second;
+        }
+
+    private:
+        using underlying_t = std::underlying_type_t<enum_type>;
+
+        static constexpr auto table = [] {
+            std::array<underlying_t, size> values{};
+            for(std::size_t i = 0; i < size; ++i)
+                values[i] = static_cast<underlying_t>(Mapper.data()[i].second);
+            detail::KeyPositionTable<underlying_t, size> result;
+            result.build(values);
+            return result;
+        }();
+    };
+
+    namespace detail
+    {
+        // Fixed-size bit set stored as 64-bit words; bits at or beyond Size are always clear.
+        template<std::size_t Size>
+        struct SlotBits
+        {
+            static constexpr std::size_t word_count = (Size + 63) / 64;
+
+            std::array<std::uint64_t, word_count> words{};
+
+            [[nodiscard]] constexpr bool test(std::size_t i) const
+            {
+                return (words[i / 64] >> (i % 64)) & 1u;
+            }
+
+            constexpr void set(std::size_t i)
+            {
+                words[i / 64] |= std::uint64_t{1} << (i % 64);
+            }
+
+            constexpr void reset(std::size_t i)
+            {
+                words[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+            }
+
+            [[nodiscard]] constexpr std::size_t count() const
+            {
+                std::size_t n = 0;
+                for(auto w : words)
+                    n += static_cast<std::size_t>(std::popcount(w));
+                return n;
+            }
+
+            [[nodiscard]] constexpr bool none() const
+            {
+                for(auto w : words)
+                    if(w != 0)
+                        return false;
+                return true;
+            }
+
+            // First set bit at or after i, or Size
+            [[nodiscard]] constexpr std::size_t next(std::size_t i) const
+            {
+                if(i >= Size)
+                    return Size;
+                auto word = i / 64;
+                auto bits = words[word] & (~std::uint64_t{0} << (i % 64));
+                while(bits == 0)
+                {
+                    if(++word == word_count)
+                        return Size;
+                    bits = words[word];
+                }
+                return word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            }
+
+            // Mask of the valid bits of the last word
+            static constexpr std::uint64_t last_word_mask =
+              Size % 64 == 0 ? ~std::uint64_t{0} : (std::uint64_t{1} << (Size % 64)) - 1;
+
+            static constexpr SlotBits all()
+            {
+                SlotBits result;
+                result.words.fill(~std::uint64_t{0});
+                if constexpr(word_count > 0)
+                    result.words[word_count - 1] &= last_word_mask;
+                return result;
+            }
+
+            friend constexpr bool operator==(const SlotBits &, const SlotBits &) = default;
+        };
+    }   // namespace detail
+
+    template<Enum E, typename V, EnumSlots Slots>
+        requires std::same_as<typename Slots::enum_type, E>
+    class EnumMap;
+
+    //
+    // EnumSet: set of enum values stored as one bit per slot. Union, intersection, difference,
+    // complement and subset tests work a 64-bit word at a time; iteration skips to the next set
+    // bit with a count-trailing-zeros.
+    //
+    template<Enum E, EnumSlots Slots>
+        requires std::same_as<typename Slots::enum_type, E>
+    class EnumSet
+    {
+        using bits_t = detail::SlotBits<Slots::size>;
+
+    public:
+        using key_type = E;
+        using value_type = E;
+        using size_type = std::size_t;
+
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = E;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const E *;
+            using reference = E;
+
+            constexpr const_iterator() = default;
+
+            constexpr E operator*() const
+            {
+                return Slots::value(slot_);
+            }
+
+            constexpr const_iterator & operator++()
+            {
+                slot_ = bits_->next(slot_ + 1);
+                return *this;
+            }
+
+            constexpr const_iterator operator++(int)
+            {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            friend constexpr bool operator==(const const_iterator & a, const const_iterator & b)
+            {
+                return a.slot_ == b.slot_;
+            }
+
+        private:
+            friend class EnumSet;
+
+            constexpr const_iterator(const bits_t * bits, std::size_t slot) : bits_(bits), slot_(slot)
+            {}
+
+            const bits_t * bits_{nullptr};
+            std::size_t slot_{Slots::size};
+        };
+
+        using iterator = const_iterator;
+
+        constexpr EnumSet() = default;
+
+        constexpr EnumSet(std::initializer_list<E> values)
+        {
+            for(auto e : values)
+                insert(e);
+        }
+
+        // Every value of the slot set
+        [[nodiscard]] static constexpr EnumSet all()
+        {
+            EnumSet result;
+            result.bits_ = bits_t::all();
+            return result;
+        }
+
+        [[nodiscard]] static constexpr size_type capacity()
+        {
+            return Slots::size;
+        }
+
+        [[nodiscard]] constexpr size_type size() const
+        {
+            return bits_.count();
+        }
+
+        [[nodiscard]] constexpr bool empty() const
+        {
+            return bits_.none();
+        }
+
+        [[nodiscard]] constexpr bool contains(E e) const
+        {
+            const auto slot = Slots::slot(e);
+            return slot < Slots::size && bits_.test(slot);
+        }
+
+        [[nodiscard]] constexpr size_type count(E e) const
+        {
+            return contains(e) ? 1 : 0;
+        }
+
+        [[nodiscard]] constexpr const_iterator find(E e) const
+        {
+            return contains(e) ? const_iterator(&bits_, Slots::slot(e)) : end();
+        }
+
+        // Returns false if e was already present. Throws std::out_of_range if e has no slot.
+        constexpr bool insert(E e)
+        {
+            const auto slot = checked_slot(e);
+            const bool added = !bits_.test(slot);
+            bits_.set(slot);
+            return added;
+        }
+
+        constexpr size_type erase(E e)
+        {
+            if(!contains(e))
+                return 0;
+            bits_.reset(Slots::slot(e));
+            return 1;
+        }
+
+        constexpr void clear()
+        {
+            bits_ = {};
+        }
+
+        [[nodiscard]] constexpr const_iterator begin() const
+        {
+            return const_iterator(&bits_, bits_.next(0));
+        }
+
+        [[nodiscard]] constexpr const_iterator end() const
+        {
+            return const_iterator(&bits_, Slots::size);
+        }
+
+        // True when every value of this set is also in other
+        [[nodiscard]] constexpr bool is_subset_of(const EnumSet & other) const
+        {
+            for(std::size_t w = 0; w < bits_t::word_count; ++w)
+                if((bits_.words[w] & ~other.bits_.words[w]) != 0)
+                    return false;
+            return true;
+        }
+
+        [[nodiscard]] constexpr bool intersects(const EnumSet & other) const
+        {
+            for(std::size_t w = 0; w < bits_t::word_count; ++w)
+                if((bits_.words[w] & other.bits_.words[w]) != 0)
+                    return true;
+            return false;
+        }
+
+        // Values of the slot set that are not in this set
+        [[nodiscard]] constexpr EnumSet complement() const
+        {
+            auto result = all();
+            for(std::size_t w = 0; w < bits_t::word_count; ++w)
+                result.bits_.words[w] &= ~bits_.words[w];
+            return result;
+        }
+
+        constexpr EnumSet & operator|=(const EnumSet & other)
+        {
+            for(std::size_t w = 0; w < bits_t::word_count; ++w)
+                bits_.words[w] |= other.bits_.words[w];
+            return *this;
+        }
+
+        constexpr EnumSet & operator&=(const EnumSet & other)
+        {
+            for(std::size_t w = 0; w < bits_t::word_count; ++w)
+                bits_.words[w] &= other.bits_.words[w];
+            return *this;
+        }
+
+        constexpr EnumSet & operator-=(const EnumSet & other)
+        {
+            for(std::size_t w = 0; w < bits_t::word_count; ++w)
+                bits_.words[w] &= ~other.bits_.words[w];
+            return *this;
+        }
+
+        constexpr EnumSet & operator^=(const EnumSet & other)
+        {
+            for(std::size_t w = 0; w < bits_t::word_count; ++w)
+                bits_.words[w] ^= other.bits_.words[w];
+            return *this;
+        }
+
+        friend constexpr EnumSet operator|(EnumSet a, const EnumSet & b)
+        {
+            return a |= b;
+        }
+
+        friend constexpr EnumSet operator&(EnumSet a, const EnumSet & b)
+        {
+            return a &= b;
+        }
+
+        friend constexpr EnumSet operator-(EnumSet a, const EnumSet & b)
+        {
+            return a -= b;
+        }
+
+        friend constexpr EnumSet operator^(EnumSet a, const EnumSet & b)
+        {
+            return a ^= b;
+        }
+
+        friend constexpr bool operator==(const EnumSet &, const EnumSet &) = default;
+
+    private:
+        template<Enum E2, typename V, EnumSlots S2>
+            requires std::same_as<typename S2::enum_type, E2>
+        friend class EnumMap;
+
+        static constexpr std::size_t checked_slot(E e)
+        {
+            const auto slot = Slots::slot(e);
+            if(slot >= Slots::size)
+                throw std::out_of_range("EnumSet: enum value has no slot");
+            return slot;
+        }
+
+        bits_t bits_{};
+    };
+
+    //
+    // EnumMap: associative container keyed by enum with one inline slot per enum value and a
+    // presence bit per slot. No allocation, no hashing: a lookup is Slots::slot(key) plus a bit
+    // test. Elements are std::pair<const E, V> so it models AssociativeContainer and works with
+    // the map_utils.hxx functions. Iteration visits present keys in slot order.
+    //
+    template<Enum E, typename V, EnumSlots Slots>
+        requires std::same_as<typename Slots::enum_type, E>
+    class EnumMap
+    {
+        using bits_t = detail::SlotBits<Slots::size>;
+
+    public:
+        using key_type = E;
+        using mapped_type = V;
+        using value_type = std::pair<const E, V>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type &;
+        using const_reference = const value_type &;
+
+        template<bool Const>
+        class basic_iterator
+        {
+            using owner_t = std::conditional_t<Const, const EnumMap, EnumMap>;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = EnumMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+            using reference = std::conditional_t<Const, const value_type &, value_type &>;
+
+            basic_iterator() = default;
+
+            // iterator converts to const_iterator
+            template<bool OtherConst>
+                requires(Const && !OtherConst)
+            basic_iterator(const basic_iterator<OtherConst> & other) : map_(other.map_), slot_(other.slot_)
+            {}
+
+            reference operator*() const
+            {
+                return *map_->element(slot_);
+            }
+
+            pointer operator->() const
+            {
+                return map_->element(slot_);
+            }
+
+            basic_iterator & operator++()
+            {
+                slot_ = map_->present_.next(slot_ + 1);
+                return *this;
+            }
+
+            basic_iterator operator++(int)
+            {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            friend bool operator==(const basic_iterator & a, const basic_iterator & b)
+            {
+                return a.slot_ == b.slot_;
+            }
+
+        private:
+            friend class EnumMap;
+
+            basic_iterator(owner_t * map, std::size_t slot) : map_(map), slot_(slot)
+            {}
+
+            owner_t * map_{nullptr};
+            std::size_t slot_{Slots::size};
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        EnumMap() = default;
+
+        EnumMap(std::initializer_list<value_type> values)
+        {
+            for(const auto & kv : values)
+                insert(kv);
+        }
+
+        EnumMap(const EnumMap & other)
+        {
+            copy_from(other);
+        }
+
+        EnumMap(EnumMap && other) noexcept(std::is_nothrow_move_constructible_v<V>)
+        {
+            for(auto slot = other.present_.next(0); slot < Slots::size; slot = other.present_.next(slot + 1))
+                construct(slot, std::move(other.element(slot)->second));
+        }
+
+        EnumMap & operator=(const EnumMap & other)
+        {
+            if(this != &other)
+            {
+                clear();
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        EnumMap & operator=(EnumMap && other) noexcept(std::is_nothrow_move_constructible_v<V>)
+        {
+            if(this != &other)
+            {
+                clear();
+                for(auto slot = other.present_.next(0); slot < Slots::size; slot = other.present_.next(slot + 1))
+                    construct(slot, std::move(other.element(slot)->second));
+            }
+            return *this;
+        }
+
+        ~EnumMap()
+        {
+            clear();
+        }
+
+        [[nodiscard]] static constexpr size_type capacity()
+        {
+            return Slots::size;
+        }
+
+        [[nodiscard]] size_type size() const
+        {
+            return present_.count();
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return present_.none();
+        }
+
+        [[nodiscard]] bool contains(E key) const
+        {
+            const auto slot = Slots::slot(key);
+            return slot < Slots::size && present_.test(slot);
+        }
+
+        [[nodiscard]] size_type count(E key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        [[nodiscard]] iterator find(E key)
+        {
+            return contains(key) ? iterator(this, Slots::slot(key)) : end();
+        }
+
+        [[nodiscard]] const_iterator find(E key) const
+        {
+            return contains(key) ? const_iterator(this, Slots::slot(key)) : end();
+        }
+
+        // Throws std::out_of_range if key is not present
+        [[nodiscard]] V & at(E key)
+        {
+            if(!contains(key))
+                throw std::out_of_range("EnumMap::at: key not present");
+            return element(Slots::slot(key))->second;
+        }
+
+        [[nodiscard]] const V & at(E key) const
+        {
+            if(!contains(key))
+                throw std::out_of_range("EnumMap::at: key not present");
+            return element(Slots::slot(key))->second;
+        }
+
+        // Value-initializes a missing entry. Throws std::out_of_range if key has no slot.
+        V & operator[](E key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(E key, Args &&... args)
+        {
+            const auto slot = EnumSet<E, Slots>::checked_slot(key);
+            if(present_.test(slot))
+                return {iterator(this, slot), false};
+            construct(slot, std::forward<Args>(args)...);
+            return {iterator(this, slot), true};
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(E key, Args &&... args)
+        {
+            return try_emplace(key, std::forward<Args>(args)...);
+        }
+
+        std::pair<iterator, bool> insert(const value_type & kv)
+        {
+            return try_emplace(kv.first, kv.second);
+        }
+
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(E key, M && value)
+        {
+            auto result = try_emplace(key, std::forward<M>(value));
+            if(!result.second)
+                result.first->second = std::forward<M>(value);
+            return result;
+        }
+
+        size_type erase(E key)
+        {
+            if(!contains(key))
+                return 0;
+            destroy(Slots::slot(key));
+            return 1;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            const auto slot = pos.slot_;
+            destroy(slot);
+            return iterator(this, present_.next(slot + 1));
+        }
+
+        void clear() noexcept
+        {
+            for(auto slot = present_.next(0); slot < Slots::size; slot = present_.next(slot + 1))
+                destroy(slot);
+        }
+
+        // The present keys as an EnumSet (a copy of the presence bits)
+        [[nodiscard]] EnumSet<E, Slots> keys() const
+        {
+            EnumSet<E, Slots> result;
+            result.bits_ = present_;
+            return result;
+        }
+
+        [[nodiscard]] iterator begin()
+        {
+            return iterator(this, present_.next(0));
+        }
+
+        [[nodiscard]] iterator end()
+        {
+            return iterator(this, Slots::size);
+        }
+
+        [[nodiscard]] const_iterator begin() const
+        {
+            return const_iterator(this, present_.next(0));
+        }
+
+        [[nodiscard]] const_iterator end() const
+        {
+            return const_iterator(this, Slots::size);
+        }
+
+        [[nodiscard]] const_iterator cbegin() const
+        {
+            return begin();
+        }
+
+        [[nodiscard]] const_iterator cend() const
+        {
+            return end();
+        }
+
+        friend bool operator==(const EnumMap & a, const EnumMap & b)
+        {
+            if(a.present_ != b.present_)
+                return false;
+            for(auto slot = a.present_.next(0); slot < Slots::size; slot = a.present_.next(slot + 1))
+                if(!(a.element(slot)->second == b.element(slot)->second))
+                    return false;
+            return true;
+        }
+
+    private:
+        value_type * element(std::size_t slot)
+        {
+            return std::launder(reinterpret_cast<value_type *>(storage_ + slot * sizeof(value_type)));
+        }
+
+        const value_type * element(std::size_t slot) const
+        {
+            return std::launder(reinterpret_cast<const value_type *>(storage_ + slot * sizeof(value_type)));
+        }
+
+        template<typename... Args>
+        void construct(std::size_t slot, Args &&... args)
+        {
+            ::new(static_cast<void *>(storage_ + slot * sizeof(value_type)))
+              value_type(std::piecewise_construct,
+                         std::forward_as_tuple(Slots::value(slot)),
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+            present_.set(slot);
+        }
+
+        void destroy(std::size_t slot) noexcept
+        {
+            std::destroy_at(element(slot));
+            present_.reset(slot);
+        }
+
+        void copy_from(const EnumMap & other)
+        {
+            for(auto slot = other.present_.next(0); slot < Slots::size; slot = other.present_.next(slot + 1))
+                construct(slot, other.element(slot)->second);
+        }
+
+        bits_t present_{};
+        alignas(value_type) std::byte storage_[sizeof(value_type) * (Slots::size > 0 ? Slots::size : 1)];
+    };
+
+}   // namespace lbnl
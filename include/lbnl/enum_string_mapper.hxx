@@ -0,0 +1,351 @@
+// enum_string_mapper.hxx
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <type_traits>
+
+#include "enum_index_mapper.hxx"
+
+namespace lbnl
+{
+
+    // Whether EnumStringMapper::from_string matches names exactly or ignoring ASCII case
+    enum class EnumStringCase
+    {
+        Sensitive,
+        Insensitive
+    };
+
+    namespace detail
+    {
+        [[nodiscard]] constexpr char fold_ascii(char c)
+        {
+            return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        // splitmix64 finalizer: spreads every input bit over the whole word
+        [[nodiscard]] constexpr std::uint64_t mix64(std::uint64_t h)
+        {
+            h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+            h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+            return h ^ (h >> 31);
+        }
+
+        // FNV-1a over the name, folding ASCII case first when asked to. FNV alone leaves the
+        // high bits of short, similar names (Zone_01, Zone_02, ...) clustered, so it is mixed.
+        template<EnumStringCase Case>
+        [[nodiscard]] constexpr std::uint64_t name_hash(std::string_view name)
+        {
+            std::uint64_t h = 0xcbf29ce484222325ull;
+            for(char c : name)
+            {
+                if constexpr(Case == EnumStringCase::Insensitive)
+                    c = fold_ascii(c);
+                h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+            }
+            return mix64(h);
+        }
+
+        template<EnumStringCase Case>
+        [[nodiscard]] constexpr bool name_equal(std::string_view a, std::string_view b)
+        {
+            if constexpr(Case == EnumStringCase::Sensitive)
+            {
+                return a == b;
+            }
+            else
+            {
+                if(a.size() != b.size())
+                    return false;
+                for(std::size_t i = 0; i < a.size(); ++i)
+                    if(fold_ascii(a[i]) != fold_ascii(b[i]))
+                        return false;
+                return true;
+            }
+        }
+
+        // Second-level slot of a name hash under a bucket seed
+        [[nodiscard]] constexpr std::uint64_t displace(std::uint64_t h, std::uint32_t seed)
+        {
+            return mix64(h + 0x9e3779b97f4a7c15ull * (std::uint64_t{seed} + 1));
+        }
+    }   // namespace detail
+
+    // Bidirectional mapping between names and Enum values, for parsing text inputs.
+    // Storage is a constexpr std::array of (name, enum) pairs; names must outlive the mapper
+    // (string literals do).
+    // from_string uses a minimal perfect hash built on construction (hash and displace): the
+    // name is hashed once, its bucket either points straight at a slot or gives a seed that
+    // places it, and one comparison confirms the match. to_string uses the same tables as
+    // EnumIndexMapper::to_index and returns a view of the stored name.
+    // Empty names and duplicate names or enums throw std::invalid_argument, which in a
+    // constexpr mapper is a compile error.
+    template<Enum E, std::size_t N, EnumStringCase Case = EnumStringCase::Sensitive>
+    class EnumStringMapper
+    {
+    public:
+        using pair_type = std::pair<std::string_view, E>;
+        using storage_t = std::array<pair_type, N>;
+
+        constexpr explicit EnumStringMapper(storage_t mapping) : mapping_{mapping}
+        {
+            std::array<underlying_t, N> values{};
+            for(std::size_t pos = 0; pos < N; ++pos)
+            {
+                if(mapping_[pos].first.empty())
+                    throw std::invalid_argument("EnumStringMapper: empty name");
+                values[pos] = static_cast<underlying_t>(mapping_[pos].second);
+            }
+            if(!by_enum_.build(values))
+                throw std::invalid_argument("EnumStringMapper: duplicate enum");
+            build_name_hash();
+        }
+
+        [[nodiscard]] constexpr std::optional<E> from_string(std::string_view name) const
+        {
+            const auto pos = position_of(name);
+            if(pos == N)
+                return std::nullopt;
+            return mapping_[pos].second;
+        }
+
+        [[nodiscard]] constexpr E from_string_or(std::string_view name, E fallback) const
+        {
+            if(auto v = from_string(name))
+                return *v;
+            return fallback;
+        }
+
+        // Stored name of e, or an empty view if e is not mapped
+        [[nodiscard]] constexpr std::string_view to_string(E e) const
+        {
+            if(auto pos = by_enum_.find(static_cast<underlying_t>(e)))
+                return mapping_[*pos].first;
+            return {};
+        }
+
+        // Parses a stream of tokens. out must be at least as long as tokens; tokens without a
+        // mapping are written as fallback and counted in the result.
+        constexpr BulkConversion
+          from_strings(std::span<const std::string_view> tokens, std::span<E> out, E fallback) const
+        {
+            return parse(tokens, out, fallback, {});
+        }
+
+        // As above, and sets bit (i % 64) of valid[i / 64] when tokens[i] has a mapping.
+        // valid must hold at least (tokens.size() + 63) / 64 words.
+        constexpr BulkConversion from_strings(std::span<const std::string_view> tokens,
+                                              std::span<E> out,
+                                              E fallback,
+                                              std::span<std::uint64_t> valid) const
+        {
+            return parse(tokens, out, fallback, valid);
+        }
+
+        // Expose mapping for iteration or tests
+        [[nodiscard]] constexpr storage_t const & data() const
+        {
+            return mapping_;
+        }
+
+    private:
+        using underlying_t = std::underlying_type_t<E>;
+
+        // Bucket seed marking a bucket with a single name: the slot is stored directly
+        static constexpr std::uint32_t direct = 0x80000000u;
+        static constexpr std::uint32_t max_seed = 1u << 20;
+
+        [[nodiscard]] static constexpr std::size_t bucket_of(std::uint64_t h)
+        {
+            return static_cast<std::size_t>((h >> 32) % N);
+        }
+
+        [[nodiscard]] constexpr std::size_t position_of(std::string_view name) const
+        {
+            if constexpr(N == 0)
+            {
+                return 0;
+            }
+            else
+            {
+                const auto h = detail::name_hash<Case>(name);
+                const auto seed = seeds_[bucket_of(h)];
+                const auto slot = (seed & direct) != 0
+                                    ? static_cast<std::size_t>(seed & ~direct)
+                                    : static_cast<std::size_t>(detail::displace(h, seed) % N);
+                const auto pos = slots_[slot];
+                return detail::name_equal<Case>(mapping_[pos].first, name) ? pos : N;
+            }
+        }
+
+        // Hash and displace: buckets are placed largest first; each multi-name bucket gets the
+        // first seed that sends all of its names to distinct free slots, and single-name
+        // buckets then take the remaining slots directly.
+        constexpr void build_name_hash()
+        {
+            if constexpr(N > 0)
+            {
+                std::array<std::uint64_t, N> hashes{};
+                for(std::size_t pos = 0; pos < N; ++pos)
+                    hashes[pos] = detail::name_hash<Case>(mapping_[pos].first);
+                reject_duplicate_names(hashes);
+
+                // Group positions by bucket (counting sort)
+                std::array<std::size_t, N + 1> start{};
+                for(auto h : hashes)
+                    ++start[bucket_of(h) + 1];
+                for(std::size_t b = 0; b < N; ++b)
+                    start[b + 1] += start[b];
+                std::array<std::size_t, N> members{};
+                std::array<std::size_t, N> fill{};
+                for(std::size_t pos = 0; pos < N; ++pos)
+                {
+                    const auto b = bucket_of(hashes[pos]);
+                    members[start[b] + fill[b]++] = pos;
+                }
+
+                std::array<std::size_t, N> order{};
+                for(std::size_t b = 0; b < N; ++b)
+                    order[b] = b;
+                std::sort(order.begin(), order.end(), [&start](std::size_t a, std::size_t b) {
+                    return start[a + 1] - start[a] > start[b + 1] - start[b];
+                });
+
+                std::array<bool, N> taken{};
+                std::array<std::size_t, N> trial{};
+                std::size_t next_free = 0;
+                for(auto b : order)
+                {
+                    const auto first = start[b];
+                    const auto size = start[b + 1] - first;
+                    if(size == 0)
+                        break;
+                    if(size == 1)
+                    {
+                        while(taken[next_free])
+                            ++next_free;
+                        taken[next_free] = true;
+                        slots_[next_free] = static_cast<std::uint32_t>(members[first]);
+                        seeds_[b] = direct | static_cast<std::uint32_t>(next_free);
+                        continue;
+                    }
+                    seeds_[b] = place_bucket(hashes, members, first, size, taken, trial);
+                }
+            }
+        }
+
+        constexpr std::uint32_t place_bucket(std::array<std::uint64_t, N> const & hashes,
+                                             std::array<std::size_t, N> const & members,
+                                             std::size_t first,
+                                             std::size_t size,
+                                             std::array<bool, N> & taken,
+                                             std::array<std::size_t, N> & trial)
+        {
+            for(std::uint32_t seed = 0; seed < max_seed; ++seed)
+            {
+                bool fits = true;
+                for(std::size_t i = 0; i < size && fits; ++i)
+                {
+                    const auto h = hashes[members[first + i]];
+                    trial[i] = static_cast<std::size_t>(detail::displace(h, seed) % N);
+                    fits = !taken[trial[i]];
+                    for(std::size_t j = 0; j < i && fits; ++j)
+                        fits = trial[j] != trial[i];
+                }
+                if(!fits)
+                    continue;
+                for(std::size_t i = 0; i < size; ++i)
+                {
+                    taken[trial[i]] = true;
+                    slots_[trial[i]] = static_cast<std::uint32_t>(members[first + i]);
+                }
+                return seed;
+            }
+            throw std::logic_error("EnumStringMapper: no perfect hash seed found");
+        }
+
+        constexpr void reject_duplicate_names(std::array<std::uint64_t, N> const & hashes) const
+        {
+            std::array<std::size_t, N> by_hash{};
+            for(std::size_t pos = 0; pos < N; ++pos)
+                by_hash[pos] = pos;
+            std::sort(by_hash.begin(), by_hash.end(), [&hashes](std::size_t a, std::size_t b) {
+                return hashes[a] < hashes[b];
+            });
+            for(std::size_t i = 0; i < N; ++i)
+            {
+                const auto name = mapping_[by_hash[i]].first;
+                for(std::size_t j = i + 1; j < N && hashes[by_hash[j]] == hashes[by_hash[i]]; ++j)
+                    if(detail::name_equal<Case>(name, mapping_[by_hash[j]].first))
+                        throw std::invalid_argument("EnumStringMapper: duplicate name");
+            }
+        }
+
+        constexpr BulkConversion parse(std::span<const std::string_view> tokens,
+                                       std::span<E> out,
+                                       E fallback,
+                                       std::span<std::uint64_t> valid) const
+        {
+            if(out.size() < tokens.size())
+                throw std::invalid_argument("EnumStringMapper: output span is shorter than input");
+            if(!valid.empty() && valid.size() < (tokens.size() + 63) / 64)
+                throw std::invalid_argument("EnumStringMapper: validity mask is too short");
+
+            BulkConversion result;
+            std::uint64_t word = 0;
+            for(std::size_t i = 0; i < tokens.size(); ++i)
+            {
+                const auto pos = position_of(tokens[i]);
+                const bool found = pos < N;
+                if constexpr(N == 0)
+                    out[i] = fallback;
+                else
+                    out[i] = found ? mapping_[pos].second : fallback;
+                word |= std::uint64_t{found} << (i % 64);
+
+                if(!found)
+                {
+                    if(result.invalid == 0)
+                        result.first_invalid = i;
+                    ++result.invalid;
+                }
+                if(i % 64 == 63 || i + 1 == tokens.size())
+                {
+                    if(!valid.empty())
+                        valid[i / 64] = word;
+                    word = 0;
+                }
+            }
+            return result;
+        }
+
+        storage_t mapping_;
+        std::array<std::uint32_t, N> seeds_{};   // per bucket: seed, or direct | slot
+        std::array<std::uint32_t, N> slots_{};   // per slot: position in mapping_
+        detail::KeyPositionTable<underlying_t, N> by_enum_{};
+    };
+
+    template<Enum E, EnumStringCase Case = EnumStringCase::Sensitive, std::size_t N>
+    [[nodiscard]] constexpr auto
+      make_enum_string_mapper(const std::array<std::pair<std::string_view, E>, N> & a)
+    {
+        return EnumStringMapper<E, N, Case>{a};
+    }
+
+    // Brace initialization: make_enum_string_mapper<E>({{"Name", E::Value}, ...})
+    template<Enum E, EnumStringCase Case = EnumStringCase::Sensitive, std::size_t N>
+    [[nodiscard]] constexpr auto
+      make_enum_string_mapper(const std::pair<std::string_view, E> (&a)[N])
+    {
+        return EnumStringMapper<E, N, Case>(std::to_array(a));
+    }
+
+}   // namespace lbnl
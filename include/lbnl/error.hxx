@@ -0,0 +1,668 @@
+// error.hxx
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace lbnl
+{
+    namespace detail
+    {
+        enum class ErrorArgumentKind : std::uint8_t
+        {
+            Signed,
+            Unsigned,
+            Floating,
+            Boolean,
+            Character,
+            Text
+        };
+
+        template<typename T>
+        concept ErrorScalar = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+        template<typename T>
+        concept ErrorText = !ErrorScalar<T> && std::convertible_to<const T &, std::string_view>;
+
+        template<typename T>
+        concept ErrorArgument = ErrorScalar<T> || ErrorText<T>;
+
+        inline constexpr std::size_t malformed_error_format =
+          std::numeric_limits<std::size_t>::max();
+
+        // Number of {} placeholders in an error format ({{ and }} are escapes), or
+        // malformed_error_format for any other use of braces
+        constexpr std::size_t count_error_placeholders(std::string_view format) noexcept
+        {
+            std::size_t count = 0;
+            for(std::size_t pos = 0; pos < format.size(); ++pos)
+            {
+                const bool hasNext = pos + 1 < format.size();
+                if(format[pos] == '{' && hasNext && format[pos + 1] == '}')
+                {
+                    ++count;
+                    ++pos;
+                }
+                else if((format[pos] == '{' || format[pos] == '}') && hasNext
+                        && format[pos + 1] == format[pos])
+                {
+                    ++pos;
+                }
+                else if(format[pos] == '{' || format[pos] == '}')
+                {
+                    return malformed_error_format;
+                }
+            }
+            return count;
+        }
+
+        // Deliberately not constexpr: reaching it from the consteval format check is the
+        // compile error reported for a format that does not match its arguments
+        inline void error_format_does_not_match_arguments()
+        {}
+    }   // namespace detail
+
+    //
+    // Format string of an Error, checked at compile time: it must be a constant (in practice a
+    // string literal, which also guarantees it outlives every Error) with one {} per argument.
+    //
+    template<typename... Args>
+    class BasicErrorFormat
+    {
+    public:
+        template<typename S>
+            requires std::convertible_to<const S &, std::string_view>
+        consteval BasicErrorFormat(const S & text) : m_text(text)
+        {
+            if(detail::count_error_placeholders(m_text) != sizeof...(Args))
+            {
+                detail::error_format_does_not_match_arguments();
+            }
+        }
+
+        [[nodiscard]] constexpr std::string_view get() const noexcept
+        {
+            return m_text;
+        }
+
+    private:
+        std::string_view m_text;
+    };
+
+    // Keeps the format out of template argument deduction, so Args come from the arguments
+    template<typename... Args>
+    using ErrorFormat = BasicErrorFormat<std::type_identity_t<Args>...>;
+
+    namespace detail
+    {
+        template<ErrorScalar T>
+        constexpr std::pair<std::uint64_t, ErrorArgumentKind> capture_error_scalar(T value) noexcept
+        {
+            if constexpr(std::is_enum_v<T>)
+            {
+                return capture_error_scalar(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else if constexpr(std::is_same_v<T, bool>)
+            {
+                return {value ? 1u : 0u, ErrorArgumentKind::Boolean};
+            }
+            else if constexpr(std::is_same_v<T, char>)
+            {
+                return {static_cast<unsigned char>(value), ErrorArgumentKind::Character};
+            }
+            else if constexpr(std::is_floating_point_v<T>)
+            {
+                return {std::bit_cast<std::uint64_t>(static_cast<double>(value)),
+                        ErrorArgumentKind::Floating};
+            }
+            else if constexpr(std::is_signed_v<T>)
+            {
+                return {std::bit_cast<std::uint64_t>(static_cast<std::int64_t>(value)),
+                        ErrorArgumentKind::Signed};
+            }
+            else
+            {
+                return {static_cast<std::uint64_t>(value), ErrorArgumentKind::Unsigned};
+            }
+        }
+
+        template<ErrorText T>
+        std::string_view error_text_view(const T & text) noexcept
+        {
+            if constexpr(std::is_pointer_v<T>)
+            {
+                return text != nullptr ? std::string_view(text) : std::string_view();
+            }
+            else
+            {
+                return std::string_view(text);
+            }
+        }
+
+        // Text is copied into a record as a 32-bit length followed by the characters
+        inline std::string_view stored_error_text(std::uint64_t payload) noexcept
+        {
+            const auto * text =
+              reinterpret_cast<const char *>(static_cast<std::uintptr_t>(payload));
+            std::uint32_t size = 0;
+            std::memcpy(&size, text, sizeof(size));
+            return {text + sizeof(size), size};
+        }
+
+        inline void
+          append_error_argument(std::string & out, std::uint64_t payload, ErrorArgumentKind kind)
+        {
+            char buffer[32];
+            std::to_chars_result result{buffer, std::errc{}};
+            switch(kind)
+            {
+                case ErrorArgumentKind::Signed:
+                    result = std::to_chars(
+                      buffer, buffer + sizeof(buffer), std::bit_cast<std::int64_t>(payload));
+                    break;
+                case ErrorArgumentKind::Unsigned:
+                    result = std::to_chars(buffer, buffer + sizeof(buffer), payload);
+                    break;
+                case ErrorArgumentKind::Floating:
+                    result = std::to_chars(
+                      buffer, buffer + sizeof(buffer), std::bit_cast<double>(payload));
+                    break;
+                case ErrorArgumentKind::Boolean:
+                    out += payload != 0 ? "true" : "false";
+                    return;
+                case ErrorArgumentKind::Character:
+                    out += static_cast<char>(payload);
+                    return;
+                case ErrorArgumentKind::Text:
+                    out += stored_error_text(payload);
+                    return;
+            }
+            out.append(buffer, result.ptr);
+        }
+
+        // Appends format with its placeholders replaced by the captured arguments
+        inline void append_error_format(std::string & out,
+                                        std::string_view format,
+                                        const std::uint64_t * payload,
+                                        const ErrorArgumentKind * kinds)
+        {
+            std::size_t argument = 0;
+            std::size_t literalStart = 0;
+            for(std::size_t pos = 0; pos + 1 < format.size(); ++pos)
+            {
+                if(format[pos] == '{' || format[pos] == '}')
+                {
+                    out.append(format.substr(literalStart, pos - literalStart));
+                    if(format[pos + 1] == '}' && format[pos] == '{')
+                    {
+                        append_error_argument(out, payload[argument], kinds[argument]);
+                        ++argument;
+                    }
+                    else
+                    {
+                        out += format[pos];   // {{ or }}
+                    }
+                    literalStart = ++pos + 1;
+                }
+            }
+            out.append(format.substr((std::min)(literalStart, format.size())));
+        }
+
+        struct ErrorRecord;
+
+        // Number of error blocks currently allocated, across all threads
+        inline std::atomic<std::size_t> & error_block_counter() noexcept
+        {
+            static std::atomic<std::size_t> count{0};
+            return count;
+        }
+
+        [[nodiscard]] inline std::size_t error_block_count() noexcept
+        {
+            return error_block_counter().load(std::memory_order_relaxed);
+        }
+
+        // A block of the error arena. Records are bump-allocated and never freed one by one:
+        // the block goes away when neither its arena nor any record handle refers to it.
+        // Blocks refer to each other through the previous frames of their records; the arena
+        // keeps that graph acyclic (see ErrorArena::allocate), so counting references frees it.
+        struct ErrorBlock
+        {
+            std::atomic<std::size_t> references{1};
+            ErrorRecord * records{nullptr};
+            std::size_t used{0};
+            std::size_t capacity{0};
+            const void * arena{nullptr};   // arena that bump-allocates here; null when private
+
+            [[nodiscard]] std::byte * data() noexcept
+            {
+                return reinterpret_cast<std::byte *>(this + 1);
+            }
+        };
+
+        // One message frame in the arena: the format, its captured arguments and copied text,
+        // and the next older frame. Layout: the record, std::uint64_t payload[count],
+        // ErrorArgumentKind kinds[count], then the text.
+        struct ErrorRecord
+        {
+            ErrorBlock * block;
+            ErrorRecord * nextInBlock;
+            const ErrorRecord * previous;   // holds a reference on previous->block
+            const char * format;
+            std::uint32_t formatSize;
+            std::uint32_t count;
+
+            [[nodiscard]] const std::uint64_t * payload() const noexcept
+            {
+                return reinterpret_cast<const std::uint64_t *>(this + 1);
+            }
+
+            [[nodiscard]] const ErrorArgumentKind * kinds() const noexcept
+            {
+                return reinterpret_cast<const ErrorArgumentKind *>(payload() + count);
+            }
+        };
+
+        inline void release_error_block(ErrorBlock * block) noexcept
+        {
+            if(block->references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                return;
+            }
+            for(const auto * record = block->records; record != nullptr;
+                record = record->nextInBlock)
+            {
+                if(record->previous != nullptr && record->previous->block != block)
+                {
+                    release_error_block(record->previous->block);
+                }
+            }
+            block->~ErrorBlock();
+            ::operator delete(block);
+            error_block_counter().fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        inline void retain_error_record(const ErrorRecord * record) noexcept
+        {
+            if(record != nullptr)
+            {
+                record->block->references.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        inline void release_error_record(const ErrorRecord * record) noexcept
+        {
+            if(record != nullptr)
+            {
+                release_error_block(record->block);
+            }
+        }
+
+        //
+        // Per-thread bump allocator for error records. Allocating is a pointer increment and one
+        // reference count increment. A record may outlive its block's turn as the current block,
+        // the arena and the thread, and may be released on any thread.
+        //
+        class ErrorArena
+        {
+        public:
+            static constexpr std::size_t block_capacity = 8192;
+
+            ErrorArena() = default;
+            ErrorArena(const ErrorArena &) = delete;
+            ErrorArena & operator=(const ErrorArena &) = delete;
+
+            ~ErrorArena()
+            {
+                if(m_block != nullptr)
+                {
+                    release_error_block(m_block);
+                }
+            }
+
+            //! Storage for bytes (a multiple of 8) in a block that already counts one reference
+            //! for the caller. previous is the block of the frame the new record extends, if any.
+            //!
+            //! Only this arena adds records to its current block, and such a record may refer
+            //! only to blocks of this arena, which are older and no longer written. A record
+            //! extending a frame from another thread's arena (or from a private block) gets a
+            //! private block instead: otherwise that block could also come to refer to this one,
+            //! and the two would keep each other alive.
+            [[nodiscard]] std::pair<std::byte *, ErrorBlock *>
+              allocate(std::size_t bytes, const ErrorBlock * previous = nullptr)
+            {
+                if(bytes > block_capacity / 4 || (previous != nullptr && previous->arena != this))
+                {
+                    // A block of its own, owned by the caller alone
+                    auto * block = newBlock(bytes, nullptr);
+                    block->used = bytes;
+                    return {block->data(), block};
+                }
+                if(m_block == nullptr || m_block->capacity - m_block->used < bytes)
+                {
+                    if(m_block != nullptr)
+                    {
+                        release_error_block(m_block);
+                    }
+                    m_block = newBlock(block_capacity, this);
+                }
+                m_block->references.fetch_add(1, std::memory_order_relaxed);
+                auto * storage = m_block->data() + m_block->used;
+                m_block->used += bytes;
+                return {storage, m_block};
+            }
+
+        private:
+            static ErrorBlock * newBlock(std::size_t capacity, const ErrorArena * arena)
+            {
+                auto * block = ::new(::operator new(sizeof(ErrorBlock) + capacity)) ErrorBlock();
+                block->capacity = capacity;
+                block->arena = arena;
+                error_block_counter().fetch_add(1, std::memory_order_relaxed);
+                return block;
+            }
+
+            ErrorBlock * m_block{nullptr};
+        };
+
+        inline ErrorArena & error_arena()
+        {
+            thread_local ErrorArena arena;
+            return arena;
+        }
+
+        template<ErrorArgument T>
+        std::size_t error_text_bytes(const T & argument) noexcept
+        {
+            if constexpr(ErrorText<T>)
+            {
+                return sizeof(std::uint32_t) + error_text_view(argument).size();
+            }
+            else
+            {
+                return 0;
+            }
+        }
+
+        template<ErrorArgument T>
+        void store_error_argument(const T & argument,
+                                  std::uint64_t & payload,
+                                  ErrorArgumentKind & kind,
+                                  std::byte *& text) noexcept
+        {
+            if constexpr(ErrorText<T>)
+            {
+                const auto view = error_text_view(argument);
+                const auto size = static_cast<std::uint32_t>(view.size());
+                std::memcpy(text, &size, sizeof(size));
+                if(size != 0)
+                {
+                    std::memcpy(text + sizeof(size), view.data(), size);
+                }
+                payload = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(text));
+                kind = ErrorArgumentKind::Text;
+                text += sizeof(size) + size;
+            }
+            else
+            {
+                std::tie(payload, kind) = capture_error_scalar(argument);
+            }
+        }
+
+        //! Builds a record in the calling thread's arena. The record takes over the reference
+        //! held on previous; the returned record carries one reference for the caller.
+        template<ErrorArgument... Args>
+        const ErrorRecord * make_error_record(std::string_view format,
+                                              const ErrorRecord * previous,
+                                              const Args &... args)
+        {
+            constexpr std::size_t count = sizeof...(Args);
+            constexpr std::size_t alignment = alignof(ErrorRecord);
+            const std::size_t unaligned =
+              sizeof(ErrorRecord) + count * (sizeof(std::uint64_t) + sizeof(ErrorArgumentKind))
+              + (error_text_bytes(args) + ... + std::size_t{0});
+            const std::size_t bytes = (unaligned + alignment - 1) & ~(alignment - 1);
+
+            auto [storage, block] =
+              error_arena().allocate(bytes, previous != nullptr ? previous->block : nullptr);
+            auto * record = ::new(storage) ErrorRecord{block,
+                                                       block->records,
+                                                       previous,
+                                                       format.data(),
+                                                       static_cast<std::uint32_t>(format.size()),
+                                                       static_cast<std::uint32_t>(count)};
+            block->records = record;
+
+            [[maybe_unused]] auto * payload = reinterpret_cast<std::uint64_t *>(record + 1);
+            [[maybe_unused]] auto * kinds = reinterpret_cast<ErrorArgumentKind *>(payload + count);
+            [[maybe_unused]] auto * text = reinterpret_cast<std::byte *>(kinds + count);
+            [[maybe_unused]] std::size_t index = 0;
+            ((store_error_argument(args, payload[index], kinds[index], text), ++index), ...);
+
+            // A frame in the same block as the one it extends needs no reference of its own
+            if(previous != nullptr && previous->block == block)
+            {
+                release_error_block(block);
+            }
+            return record;
+        }
+    }   // namespace detail
+
+    //
+    // Error: an error code plus a message that is formatted only when asked for, meant as the E
+    // of ExpectedExt<T, E> on hot error paths.
+    //
+    // Constructing an Error captures the format (a compile-time checked literal with {}
+    // placeholders) and its arguments; no string is built. Up to inline_arguments numbers,
+    // enums, bools or chars are stored in the Error itself, so such an error costs a few stores.
+    // Text arguments, longer argument lists and context frames go to a record bump-allocated
+    // in a thread-local arena. Copies share records through a reference count; errors may be
+    // passed to and destroyed on other threads.
+    //
+    //   return lbnl::Unexpected(lbnl::Error(Parse::BadValue, "row {}: bad value '{}'", row, cell));
+    //   ...
+    //   result.transform_error(lbnl::with_context("reading {}", path));
+    //   error.message();   // "reading data.csv: row 12: bad value 'x'"
+    //
+    class Error
+    {
+    public:
+        static constexpr std::size_t inline_arguments = 2;
+
+        //! Code 0 and an empty message
+        Error() noexcept = default;
+
+        template<typename Code, typename... Args>
+            requires(std::integral<Code> || std::is_enum_v<Code>)
+                    && (detail::ErrorArgument<Args> && ...)
+        Error(Code code, ErrorFormat<Args...> format, const Args &... args) :
+            m_code(static_cast<int>(code))
+        {
+            if constexpr(sizeof...(Args) <= inline_arguments && (detail::ErrorScalar<Args> && ...))
+            {
+                m_format = format.get().data();
+                m_formatSize = static_cast<std::uint32_t>(format.get().size());
+                [[maybe_unused]] std::size_t index = 0;
+                ((std::tie(m_payload[index], m_kinds[index]) = detail::capture_error_scalar(args),
+                  ++index),
+                 ...);
+            }
+            else
+            {
+                m_headInline = false;
+                m_record = detail::make_error_record(format.get(), nullptr, args...);
+            }
+        }
+
+        Error(const Error & other) noexcept :
+            m_code(other.m_code),
+            m_formatSize(other.m_formatSize),
+            m_format(other.m_format),
+            m_payload{other.m_payload[0], other.m_payload[1]},
+            m_kinds{other.m_kinds[0], other.m_kinds[1]},
+            m_headInline(other.m_headInline),
+            m_record(other.m_record)
+        {
+            detail::retain_error_record(m_record);
+        }
+
+        Error(Error && other) noexcept :
+            m_code(other.m_code),
+            m_formatSize(other.m_formatSize),
+            m_format(other.m_format),
+            m_payload{other.m_payload[0], other.m_payload[1]},
+            m_kinds{other.m_kinds[0], other.m_kinds[1]},
+            m_headInline(other.m_headInline),
+            m_record(std::exchange(other.m_record, nullptr))
+        {}
+
+        Error & operator=(const Error & other) noexcept
+        {
+            if(this != &other)
+            {
+                Error copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        Error & operator=(Error && other) noexcept
+        {
+            Error moved(std::move(other));
+            swap(moved);
+            return *this;
+        }
+
+        ~Error()
+        {
+            detail::release_error_record(m_record);
+        }
+
+        void swap(Error & other) noexcept
+        {
+            std::swap(m_code, other.m_code);
+            std::swap(m_formatSize, other.m_formatSize);
+            std::swap(m_format, other.m_format);
+            std::swap(m_payload, other.m_payload);
+            std::swap(m_kinds, other.m_kinds);
+            std::swap(m_headInline, other.m_headInline);
+            std::swap(m_record, other.m_record);
+        }
+
+        [[nodiscard]] int code() const noexcept
+        {
+            return m_code;
+        }
+
+        template<typename Code>
+            requires std::is_enum_v<Code>
+        [[nodiscard]] Code code_as() const noexcept
+        {
+            return static_cast<Code>(m_code);
+        }
+
+        //! Format of the original error, without context
+        [[nodiscard]] std::string_view format() const noexcept
+        {
+            if(m_headInline)
+            {
+                return {m_format, m_formatSize};
+            }
+            const auto * head = m_record;
+            while(head->previous != nullptr)
+            {
+                head = head->previous;
+            }
+            return {head->format, head->formatSize};
+        }
+
+        //! Number of frames added by with_context
+        [[nodiscard]] std::size_t context_depth() const noexcept
+        {
+            std::size_t depth = 0;
+            for(const auto * record = m_record; record != nullptr; record = record->previous)
+            {
+                ++depth;
+            }
+            return m_headInline ? depth : depth - 1;
+        }
+
+        //! Formats the message, outermost context first: "context: ...: error"
+        [[nodiscard]] std::string message() const
+        {
+            std::string out;
+            append_message(out);
+            return out;
+        }
+
+        //! Formats the message at the end of out, e.g. to reuse one buffer across many errors
+        void append_message(std::string & out) const
+        {
+            for(const auto * record = m_record; record != nullptr; record = record->previous)
+            {
+                detail::append_error_format(
+                  out, {record->format, record->formatSize}, record->payload(), record->kinds());
+                if(record->previous != nullptr || m_headInline)
+                {
+                    out += ": ";
+                }
+            }
+            if(m_headInline)
+            {
+                detail::append_error_format(out, {m_format, m_formatSize}, m_payload, m_kinds);
+            }
+        }
+
+        //! Adds an outer context frame, e.g. "while reading {}". Costs one arena record.
+        template<typename... Args>
+            requires(detail::ErrorArgument<Args> && ...)
+        [[nodiscard]] Error with_context(ErrorFormat<Args...> format, const Args &... args) const &
+        {
+            return Error(*this).with_context(format, args...);
+        }
+
+        template<typename... Args>
+            requires(detail::ErrorArgument<Args> && ...)
+        [[nodiscard]] Error with_context(ErrorFormat<Args...> format, const Args &... args) &&
+        {
+            m_record = detail::make_error_record(format.get(), m_record, args...);
+            return std::move(*this);
+        }
+
+    private:
+        int m_code{0};
+        std::uint32_t m_formatSize{0};
+        const char * m_format{""};
+        std::uint64_t m_payload[inline_arguments]{};
+        detail::ErrorArgumentKind m_kinds[inline_arguments]{};
+        bool m_headInline{true};
+        const detail::ErrorRecord * m_record{nullptr};   // newest frame first
+    };
+
+    //! Function object for transform_error that adds a context frame to an Error. The arguments
+    //! are referenced, not copied, so use it within the expression that creates it:
+    //!
+    //!   parse(row).transform_error(lbnl::with_context("reading {} line {}", path, line));
+    template<typename... Args>
+        requires(detail::ErrorArgument<Args> && ...)
+    [[nodiscard]] auto with_context(ErrorFormat<Args...> format, const Args &... args)
+    {
+        return [format, &args...](Error error) {
+            return std::move(error).with_context(format, args...);
+        };
+    }
+
+}   // namespace lbnl
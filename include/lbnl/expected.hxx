@@ -1,10 +1,13 @@
 // cpp
 #pragma once
 
-#include <variant>
-#include <type_traits>
+#include <exception>
 #include <functional>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include <variant>
 
 namespace lbnl
 {
@@ -26,6 +29,17 @@ namespace lbnl
     template<typename E>
     Unexpected(E) -> Unexpected<E>;
 
+    //
+    // Tag selecting the ExpectedExt constructor that builds the error in place.
+    // The value counterpart is std::in_place. Similar to C++23's std::unexpect.
+    //
+    struct unexpect_t
+    {
+        explicit unexpect_t() = default;
+    };
+
+    inline constexpr unexpect_t unexpect{};
+
     // Forward declaration
     template<typename T, typename E>
     class ExpectedExt;
@@ -41,9 +55,52 @@ namespace lbnl
     struct is_expected_ext<ExpectedExt<T, E>> : std::true_type
     {};
 
+    //
+    // Thrown by ExpectedExt::value() on an error result and by error() on a value result.
+    // Matches std::bad_expected_access in spirit; the error itself is not copied into it.
+    // Derives from std::bad_variant_access, which these accessors threw when ExpectedExt was
+    // built on std::variant, so existing handlers keep catching it.
+    //
+    class BadExpectedAccess : public std::bad_variant_access
+    {
+    public:
+        [[nodiscard]] const char * what() const noexcept override
+        {
+            return "lbnl::ExpectedExt: bad access";
+        }
+    };
+
+    namespace detail
+    {
+        // Triviality of ExpectedExt's special members, given the alternatives it stores
+        // (T and E, or only E for ExpectedExt<void, E>).
+        template<typename... Ts>
+        concept expected_trivially_copy_constructible = (std::is_trivially_copy_constructible_v<Ts> && ...);
+
+        template<typename... Ts>
+        concept expected_trivially_move_constructible = (std::is_trivially_move_constructible_v<Ts> && ...);
+
+        template<typename... Ts>
+        concept expected_trivially_destructible = (std::is_trivially_destructible_v<Ts> && ...);
+
+        template<typename... Ts>
+        concept expected_trivially_copy_assignable =
+          expected_trivially_copy_constructible<Ts...> && expected_trivially_destructible<Ts...>
+          && (std::is_trivially_copy_assignable_v<Ts> && ...);
+
+        template<typename... Ts>
+        concept expected_trivially_move_assignable =
+          expected_trivially_move_constructible<Ts...> && expected_trivially_destructible<Ts...>
+          && (std::is_trivially_move_assignable_v<Ts> && ...);
+    }   // namespace detail
+
     //
     // ExpectedExt<T, E>: like std::expected<T, E> in C++23
     //
+    // The value or error lives in a union next to a bool discriminator. When T and E are
+    // trivially copyable, so is ExpectedExt, and a small result such as
+    // ExpectedExt<double, ErrorCode> is returned in registers like a plain struct.
+    //
     template<typename T, typename E>
     class ExpectedExt
     {
@@ -51,25 +108,152 @@ namespace lbnl
         using value_type = T;
         using error_type = E;
 
-        // defaulted special members
         constexpr ExpectedExt() = delete;
-        constexpr ExpectedExt(const ExpectedExt &) = default;
-        constexpr ExpectedExt(ExpectedExt &&) = default;
-        constexpr ExpectedExt & operator=(const ExpectedExt &) = default;
-        constexpr ExpectedExt & operator=(ExpectedExt &&) = default;
-        ~ExpectedExt() = default;
+
+        // Copy and move are trivial when T and E are, and otherwise copy the active member.
+        constexpr ExpectedExt(const ExpectedExt &)
+            requires detail::expected_trivially_copy_constructible<T, E>
+        = default;
+
+        constexpr ExpectedExt(const ExpectedExt & other)
+            requires(!detail::expected_trivially_copy_constructible<T, E> && std::is_copy_constructible_v<T>
+                     && std::is_copy_constructible_v<E>)
+            : m_hasValue(other.m_hasValue)
+        {
+            if(m_hasValue)
+            {
+                std::construct_at(std::addressof(m_value), other.m_value);
+            }
+            else
+            {
+                std::construct_at(std::addressof(m_error), other.m_error);
+            }
+        }
+
+        constexpr ExpectedExt(ExpectedExt &&)
+            requires detail::expected_trivially_move_constructible<T, E>
+        = default;
+
+        constexpr ExpectedExt(ExpectedExt && other) noexcept(
+          std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E>)
+            requires(!detail::expected_trivially_move_constructible<T, E> && std::is_move_constructible_v<T>
+                     && std::is_move_constructible_v<E>)
+            : m_hasValue(other.m_hasValue)
+        {
+            if(m_hasValue)
+            {
+                std::construct_at(std::addressof(m_value), std::move(other.m_value));
+            }
+            else
+            {
+                std::construct_at(std::addressof(m_error), std::move(other.m_error));
+            }
+        }
+
+        constexpr ExpectedExt & operator=(const ExpectedExt &)
+            requires detail::expected_trivially_copy_assignable<T, E>
+        = default;
+
+        constexpr ExpectedExt & operator=(const ExpectedExt & other)
+            requires(!detail::expected_trivially_copy_assignable<T, E> && std::is_copy_constructible_v<T>
+                     && std::is_copy_constructible_v<E> && std::is_copy_assignable_v<T>
+                     && std::is_copy_assignable_v<E>)
+        {
+            if(this != &other)
+            {
+                if(other.m_hasValue)
+                {
+                    assignValue(other.m_value);
+                }
+                else
+                {
+                    assignError(other.m_error);
+                }
+            }
+            return *this;
+        }
+
+        constexpr ExpectedExt & operator=(ExpectedExt &&)
+            requires detail::expected_trivially_move_assignable<T, E>
+        = default;
+
+        constexpr ExpectedExt & operator=(ExpectedExt && other) noexcept(
+          std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>
+          && std::is_nothrow_move_constructible_v<E> && std::is_nothrow_move_assignable_v<E>)
+            requires(!detail::expected_trivially_move_assignable<T, E> && std::is_move_constructible_v<T>
+                     && std::is_move_constructible_v<E> && std::is_move_assignable_v<T>
+                     && std::is_move_assignable_v<E>)
+        {
+            if(this != &other)
+            {
+                if(other.m_hasValue)
+                {
+                    assignValue(std::move(other.m_value));
+                }
+                else
+                {
+                    assignError(std::move(other.m_error));
+                }
+            }
+            return *this;
+        }
+
+        constexpr ~ExpectedExt()
+            requires detail::expected_trivially_destructible<T, E>
+        = default;
+
+        constexpr ~ExpectedExt()
+        {
+            destroy();
+        }
 
         // Construct from value (implicit)
-        constexpr ExpectedExt(T val) : m_data(ValueBox{std::move(val)})
+        constexpr ExpectedExt(T val) : m_value(std::move(val)), m_hasValue(true)
         {}
 
         // Construct from Unexpected wrapper (implicit) - disambiguates errors
-        constexpr ExpectedExt(Unexpected<E> err) : m_data(ErrorBox{std::move(err.error)})
+        constexpr ExpectedExt(Unexpected<E> err) : m_error(std::move(err.error)), m_hasValue(false)
+        {}
+
+        // Build the value in place from constructor arguments, with no temporary T
+        template<typename... Args>
+            requires std::is_constructible_v<T, Args...>
+        constexpr explicit ExpectedExt(std::in_place_t, Args &&... args) :
+            m_value(std::forward<Args>(args)...), m_hasValue(true)
+        {}
+
+        template<typename U, typename... Args>
+            requires std::is_constructible_v<T, std::initializer_list<U> &, Args...>
+        constexpr explicit ExpectedExt(std::in_place_t, std::initializer_list<U> list, Args &&... args) :
+            m_value(list, std::forward<Args>(args)...), m_hasValue(true)
         {}
 
+        // Build the error in place from constructor arguments
+        template<typename... Args>
+            requires std::is_constructible_v<E, Args...>
+        constexpr explicit ExpectedExt(unexpect_t, Args &&... args) :
+            m_error(std::forward<Args>(args)...), m_hasValue(false)
+        {}
+
+        //! Replaces the contents with a value built in place. If building it throws, the previous
+        //! contents are kept.
+        template<typename... Args>
+            requires std::is_constructible_v<T, Args...>
+        constexpr T & emplace(Args &&... args)
+        {
+            return emplaceValue(std::forward<Args>(args)...);
+        }
+
+        template<typename U, typename... Args>
+            requires std::is_constructible_v<T, std::initializer_list<U> &, Args...>
+        constexpr T & emplace(std::initializer_list<U> list, Args &&... args)
+        {
+            return emplaceValue(list, std::forward<Args>(args)...);
+        }
+
         [[nodiscard]] constexpr bool has_value() const noexcept
         {
-            return std::holds_alternative<ValueBox>(m_data);
+            return m_hasValue;
         }
 
         [[nodiscard]] constexpr explicit operator bool() const noexcept
@@ -77,157 +261,732 @@ namespace lbnl
             return has_value();
         }
 
-        [[nodiscard]] constexpr const T & value() const
+        //! Throws BadExpectedAccess if this holds an error.
+        [[nodiscard]] constexpr const T & value() const &
+        {
+            checkValue();
+            return m_value;
+        }
+
+        [[nodiscard]] constexpr T & value() &
         {
-            return std::get<ValueBox>(m_data).data;
+            checkValue();
+            return m_value;
         }
 
-        [[nodiscard]] constexpr T & value()
+        //! Moves the value out of an expiring result.
+        [[nodiscard]] constexpr T && value() &&
         {
-            return std::get<ValueBox>(m_data).data;
+            checkValue();
+            return std::move(m_value);
         }
 
-        //! Member access on the contained value, matching std::expected.
+        //! Unchecked access for hot paths that already tested has_value(). Undefined on an error.
+        [[nodiscard]] constexpr const T & value_unchecked() const & noexcept
+        {
+            return m_value;
+        }
+
+        [[nodiscard]] constexpr T & value_unchecked() & noexcept
+        {
+            return m_value;
+        }
+
+        [[nodiscard]] constexpr T && value_unchecked() && noexcept
+        {
+            return std::move(m_value);
+        }
+
+        //! Member access on the contained value. Throws BadExpectedAccess if this holds an error.
         [[nodiscard]] constexpr const T * operator->() const
         {
-            return &value();
+            checkValue();
+            return std::addressof(m_value);
         }
 
         [[nodiscard]] constexpr T * operator->()
         {
-            return &value();
+            checkValue();
+            return std::addressof(m_value);
+        }
+
+        //! Dereference to the contained value. Throws BadExpectedAccess if this holds an error.
+        [[nodiscard]] constexpr const T & operator*() const &
+        {
+            checkValue();
+            return m_value;
+        }
+
+        [[nodiscard]] constexpr T & operator*() &
+        {
+            checkValue();
+            return m_value;
+        }
+
+        [[nodiscard]] constexpr T && operator*() &&
+        {
+            checkValue();
+            return std::move(m_value);
+        }
+
+        //! Throws BadExpectedAccess if this holds a value.
+        [[nodiscard]] constexpr const E & error() const &
+        {
+            checkError();
+            return m_error;
+        }
+
+        [[nodiscard]] constexpr E & error() &
+        {
+            checkError();
+            return m_error;
         }
 
-        //! Dereference to the contained value, matching std::expected.
-        [[nodiscard]] constexpr const T & operator*() const
+        [[nodiscard]] constexpr E && error() &&
         {
-            return value();
+            checkError();
+            return std::move(m_error);
         }
 
-        [[nodiscard]] constexpr T & operator*()
+        //! Unchecked access for hot paths that already tested has_value(). Undefined on a value.
+        [[nodiscard]] constexpr const E & error_unchecked() const & noexcept
         {
-            return value();
+            return m_error;
         }
 
-        [[nodiscard]] constexpr const E & error() const
+        [[nodiscard]] constexpr E & error_unchecked() & noexcept
         {
-            return std::get<ErrorBox>(m_data).data;
+            return m_error;
         }
 
-        [[nodiscard]] constexpr E & error()
+        [[nodiscard]] constexpr E && error_unchecked() && noexcept
         {
-            return std::get<ErrorBox>(m_data).data;
+            return std::move(m_error);
         }
 
         //! Returns the contained value or the provided alternative
         template<typename U>
-        [[nodiscard]] constexpr T value_or(U && alt) const
+        [[nodiscard]] constexpr T value_or(U && alt) const &
         {
-            return has_value() ? value() : static_cast<T>(std::forward<U>(alt));
+            return has_value() ? m_value : static_cast<T>(std::forward<U>(alt));
         }
 
+        //! Moves the contained value out instead of copying it
+        template<typename U>
+        [[nodiscard]] constexpr T value_or(U && alt) &&
+        {
+            return has_value() ? std::move(m_value) : static_cast<T>(std::forward<U>(alt));
+        }
+
+        //
+        // Monadic operations. The const & overloads pass the value or error to func as const &
+        // and copy whatever is carried into the result. The && overloads, picked for temporaries
+        // and std::move'd results, pass it as an rvalue and move it, so a chain on a temporary
+        // never copies the payload.
+        //
+
         //! Chains an operation on success. The function must return ExpectedExt<U, E>.
         //! For plain-value transforms, use transform() instead (matches C++23 semantics).
         template<typename Func>
-        [[nodiscard]] constexpr auto and_then(Func && func) const
+        [[nodiscard]] constexpr auto and_then(Func && func) const &
+        {
+            return andThen(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto and_then(Func && func) &&
+        {
+            return andThen(std::move(*this), std::forward<Func>(func));
+        }
+
+        //! Fallback handler if there's an error
+        template<typename Func>
+        [[nodiscard]] constexpr auto or_else(Func && func) const &
+        {
+            return orElse(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto or_else(Func && func) &&
+        {
+            return orElse(std::move(*this), std::forward<Func>(func));
+        }
+
+        //! Transforms the success value. The function returns a plain value (not ExpectedExt).
+        //! Matches C++23 std::expected::transform.
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform(Func && func) const &
+        {
+            return transformValue(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform(Func && func) &&
+        {
+            return transformValue(std::move(*this), std::forward<Func>(func));
+        }
+
+        //! Transforms the error value. Matches C++23 std::expected::transform_error.
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform_error(Func && func) const &
+        {
+            return transformError(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform_error(Func && func) &&
+        {
+            return transformError(std::move(*this), std::forward<Func>(func));
+        }
+
+        //
+        // Equality, mirroring std::expected. Defined as hidden friends so they are
+        // found by ADL only for ExpectedExt arguments. C++20 synthesizes operator!=
+        // and the reversed forms (value == expected, Unexpected == expected) from
+        // these. std::expected intentionally has NO ordering operators (an
+        // value-or-error has no natural order), so none are provided here.
+        //
+        [[nodiscard]] friend constexpr bool operator==(const ExpectedExt & lhs, const ExpectedExt & rhs)
         {
-            using Raw = std::invoke_result_t<Func, const T &>;
+            if(lhs.has_value() != rhs.has_value())
+            {
+                return false;
+            }
+            return lhs.has_value() ? (lhs.m_value == rhs.m_value) : (lhs.m_error == rhs.m_error);
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const ExpectedExt & lhs, const T & val)
+        {
+            return lhs.has_value() && lhs.m_value == val;
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const ExpectedExt & lhs, const Unexpected<E> & unex)
+        {
+            return !lhs.has_value() && lhs.m_error == unex.error;
+        }
+
+    private:
+        constexpr void checkValue() const
+        {
+            if(!m_hasValue)
+            {
+                throw BadExpectedAccess();
+            }
+        }
+
+        constexpr void checkError() const
+        {
+            if(m_hasValue)
+            {
+                throw BadExpectedAccess();
+            }
+        }
+
+        // Shared bodies of the const & and && monadic overloads. Self is const ExpectedExt & or
+        // ExpectedExt, and std::forward<Self>(self).m_value has the matching value category.
+        template<typename Self, typename Func>
+        static constexpr auto andThen(Self && self, Func && func)
+        {
+            using ValueRef = decltype((std::forward<Self>(self).m_value));
+            using Raw = std::remove_cvref_t<std::invoke_result_t<Func, ValueRef>>;
             static_assert(is_expected_ext<Raw>::value,
                           "and_then requires a function returning ExpectedExt; "
                           "use transform() for plain values");
 
             using U = typename Raw::value_type;
             using Ret = ExpectedExt<U, E>;
-            if(!has_value())
+            if(!self.has_value())
             {
-                return Ret(Unexpected<E>(error()));
+                return Ret(unexpect, std::forward<Self>(self).m_error);
             }
-            return std::invoke(std::forward<Func>(func), value());
+            return Ret(std::invoke(std::forward<Func>(func), std::forward<Self>(self).m_value));
         }
 
-        //! Fallback handler if there's an error
-        template<typename Func>
-        [[nodiscard]] constexpr auto or_else(Func && func) const
+        template<typename Self, typename Func>
+        static constexpr auto orElse(Self && self, Func && func)
+        {
+            using ErrorRef = decltype((std::forward<Self>(self).m_error));
+            using Ret = std::remove_cvref_t<std::invoke_result_t<Func, ErrorRef>>;
+            if(self.has_value())
+            {
+                return Ret(std::forward<Self>(self));
+            }
+            return Ret(std::invoke(std::forward<Func>(func), std::forward<Self>(self).m_error));
+        }
+
+        template<typename Self, typename Func>
+        static constexpr auto transformValue(Self && self, Func && func)
         {
-            if(has_value())
+            using ValueRef = decltype((std::forward<Self>(self).m_value));
+            using U = std::remove_cvref_t<std::invoke_result_t<Func, ValueRef>>;
+            if(!self.has_value())
+            {
+                return ExpectedExt<U, E>(unexpect, std::forward<Self>(self).m_error);
+            }
+            if constexpr(std::is_void_v<U>)
             {
-                return *this;
+                std::invoke(std::forward<Func>(func), std::forward<Self>(self).m_value);
+                return ExpectedExt<void, E>();
             }
             else
             {
-                return std::invoke(std::forward<Func>(func), error());
+                return ExpectedExt<U, E>(
+                  std::in_place, std::invoke(std::forward<Func>(func), std::forward<Self>(self).m_value));
             }
         }
 
-        //! Transforms the success value. The function returns a plain value (not ExpectedExt).
-        //! Matches C++23 std::expected::transform.
-        template<typename Func>
-        [[nodiscard]] constexpr auto transform(Func && func) const
+        template<typename Self, typename Func>
+        static constexpr auto transformError(Self && self, Func && func)
         {
-            using U = std::remove_cvref_t<std::invoke_result_t<Func, const T &>>;
+            using ErrorRef = decltype((std::forward<Self>(self).m_error));
+            using E2 = std::remove_cvref_t<std::invoke_result_t<Func, ErrorRef>>;
+            if(self.has_value())
+            {
+                return ExpectedExt<T, E2>(std::in_place, std::forward<Self>(self).m_value);
+            }
+            return ExpectedExt<T, E2>(
+              unexpect, std::invoke(std::forward<Func>(func), std::forward<Self>(self).m_error));
+        }
 
-            if(has_value())
+        constexpr void destroy() noexcept
+        {
+            if(m_hasValue)
             {
-                return ExpectedExt<U, E>(std::invoke(std::forward<Func>(func), value()));
+                std::destroy_at(std::addressof(m_value));
             }
             else
             {
-                return ExpectedExt<U, E>(Unexpected<E>(error()));
+                std::destroy_at(std::addressof(m_error));
             }
         }
 
-        //! Transforms the error value. Matches C++23 std::expected::transform_error.
-        template<typename Func>
-        [[nodiscard]] constexpr auto transform_error(Func && func) const
+        // Switches the active member from Old to New. If building New throws, the object keeps
+        // its Old state: New is built in a temporary first when its move cannot throw, otherwise
+        // Old is moved aside and put back.
+        template<typename New, typename Old, typename... Args>
+        static constexpr void reinit(New & newMember, Old & oldMember, Args &&... args)
+        {
+            if constexpr(std::is_nothrow_constructible_v<New, Args...>)
+            {
+                std::destroy_at(std::addressof(oldMember));
+                std::construct_at(std::addressof(newMember), std::forward<Args>(args)...);
+            }
+            else if constexpr(std::is_nothrow_move_constructible_v<New>)
+            {
+                New tmp(std::forward<Args>(args)...);
+                std::destroy_at(std::addressof(oldMember));
+                std::construct_at(std::addressof(newMember), std::move(tmp));
+            }
+            else
+            {
+                Old saved(std::move(oldMember));
+                std::destroy_at(std::addressof(oldMember));
+                try
+                {
+                    std::construct_at(std::addressof(newMember), std::forward<Args>(args)...);
+                }
+                catch(...)
+                {
+                    std::construct_at(std::addressof(oldMember), std::move(saved));
+                    throw;
+                }
+            }
+        }
+
+        template<typename... Args>
+        constexpr T & emplaceValue(Args &&... args)
         {
-            using E2 = std::remove_cvref_t<std::invoke_result_t<Func, const E &>>;
+            if(m_hasValue)
+            {
+                reinit(m_value, m_value, std::forward<Args>(args)...);
+            }
+            else
+            {
+                reinit(m_value, m_error, std::forward<Args>(args)...);
+                m_hasValue = true;
+            }
+            return m_value;
+        }
 
-            if(has_value())
+        template<typename U>
+        constexpr void assignValue(U && val)
+        {
+            if(m_hasValue)
             {
-                return ExpectedExt<T, E2>(value());
+                m_value = std::forward<U>(val);
             }
             else
             {
-                return ExpectedExt<T, E2>(Unexpected<E2>(std::invoke(std::forward<Func>(func), error())));
+                reinit(m_value, m_error, std::forward<U>(val));
+                m_hasValue = true;
+            }
+        }
+
+        template<typename G>
+        constexpr void assignError(G && err)
+        {
+            if(!m_hasValue)
+            {
+                m_error = std::forward<G>(err);
+            }
+            else
+            {
+                reinit(m_error, m_value, std::forward<G>(err));
+                m_hasValue = false;
+            }
+        }
+
+        union
+        {
+            T m_value;
+            E m_error;
+        };
+        bool m_hasValue;
+    };
+
+    //
+    // ExpectedExt<void, E>: success carries no value, for status-only operations.
+    // Like std::expected<void, E>: default-constructed means success. Stores only E and the
+    // discriminator, and is trivially copyable when E is.
+    //
+    template<typename E>
+    class ExpectedExt<void, E>
+    {
+    public:
+        using value_type = void;
+        using error_type = E;
+
+        constexpr ExpectedExt() noexcept : m_hasValue(true)
+        {}
+
+        constexpr explicit ExpectedExt(std::in_place_t) noexcept : m_hasValue(true)
+        {}
+
+        constexpr ExpectedExt(const ExpectedExt &)
+            requires detail::expected_trivially_copy_constructible<E>
+        = default;
+
+        constexpr ExpectedExt(const ExpectedExt & other)
+            requires(!detail::expected_trivially_copy_constructible<E> && std::is_copy_constructible_v<E>)
+            : m_hasValue(other.m_hasValue)
+        {
+            if(!m_hasValue)
+            {
+                std::construct_at(std::addressof(m_error), other.m_error);
+            }
+        }
+
+        constexpr ExpectedExt(ExpectedExt &&)
+            requires detail::expected_trivially_move_constructible<E>
+        = default;
+
+        constexpr ExpectedExt(ExpectedExt && other) noexcept(std::is_nothrow_move_constructible_v<E>)
+            requires(!detail::expected_trivially_move_constructible<E> && std::is_move_constructible_v<E>)
+            : m_hasValue(other.m_hasValue)
+        {
+            if(!m_hasValue)
+            {
+                std::construct_at(std::addressof(m_error), std::move(other.m_error));
             }
         }
 
+        constexpr ExpectedExt & operator=(const ExpectedExt &)
+            requires detail::expected_trivially_copy_assignable<E>
+        = default;
+
+        constexpr ExpectedExt & operator=(const ExpectedExt & other)
+            requires(!detail::expected_trivially_copy_assignable<E> && std::is_copy_constructible_v<E>
+                     && std::is_copy_assignable_v<E>)
+        {
+            if(this != &other)
+            {
+                if(other.m_hasValue)
+                {
+                    emplace();
+                }
+                else
+                {
+                    assignError(other.m_error);
+                }
+            }
+            return *this;
+        }
+
+        constexpr ExpectedExt & operator=(ExpectedExt &&)
+            requires detail::expected_trivially_move_assignable<E>
+        = default;
+
+        constexpr ExpectedExt & operator=(ExpectedExt && other) noexcept(
+          std::is_nothrow_move_constructible_v<E> && std::is_nothrow_move_assignable_v<E>)
+            requires(!detail::expected_trivially_move_assignable<E> && std::is_move_constructible_v<E>
+                     && std::is_move_assignable_v<E>)
+        {
+            if(this != &other)
+            {
+                if(other.m_hasValue)
+                {
+                    emplace();
+                }
+                else
+                {
+                    assignError(std::move(other.m_error));
+                }
+            }
+            return *this;
+        }
+
+        constexpr ~ExpectedExt()
+            requires detail::expected_trivially_destructible<E>
+        = default;
+
+        constexpr ~ExpectedExt()
+        {
+            if(!m_hasValue)
+            {
+                std::destroy_at(std::addressof(m_error));
+            }
+        }
+
+        // Construct from Unexpected wrapper (implicit)
+        constexpr ExpectedExt(Unexpected<E> err) : m_error(std::move(err.error)), m_hasValue(false)
+        {}
+
+        // Build the error in place from constructor arguments
+        template<typename... Args>
+            requires std::is_constructible_v<E, Args...>
+        constexpr explicit ExpectedExt(unexpect_t, Args &&... args) :
+            m_error(std::forward<Args>(args)...), m_hasValue(false)
+        {}
+
+        //! Switches to success, destroying any error.
+        constexpr void emplace() noexcept
+        {
+            if(!m_hasValue)
+            {
+                std::destroy_at(std::addressof(m_error));
+                m_hasValue = true;
+            }
+        }
+
+        [[nodiscard]] constexpr bool has_value() const noexcept
+        {
+            return m_hasValue;
+        }
+
+        [[nodiscard]] constexpr explicit operator bool() const noexcept
+        {
+            return has_value();
+        }
+
+        //! Throws BadExpectedAccess if this holds an error; otherwise does nothing.
+        constexpr void value() const
+        {
+            if(!m_hasValue)
+            {
+                throw BadExpectedAccess();
+            }
+        }
+
+        //! Same as value()
+        constexpr void operator*() const
+        {
+            value();
+        }
+
+        //! Throws BadExpectedAccess if this holds success.
+        [[nodiscard]] constexpr const E & error() const &
+        {
+            checkError();
+            return m_error;
+        }
+
+        [[nodiscard]] constexpr E & error() &
+        {
+            checkError();
+            return m_error;
+        }
+
+        [[nodiscard]] constexpr E && error() &&
+        {
+            checkError();
+            return std::move(m_error);
+        }
+
+        //! Unchecked access for hot paths that already tested has_value(). Undefined on success.
+        [[nodiscard]] constexpr const E & error_unchecked() const & noexcept
+        {
+            return m_error;
+        }
+
+        [[nodiscard]] constexpr E & error_unchecked() & noexcept
+        {
+            return m_error;
+        }
+
+        [[nodiscard]] constexpr E && error_unchecked() && noexcept
+        {
+            return std::move(m_error);
+        }
+
         //
-        // Equality, mirroring std::expected. Defined as hidden friends so they are
-        // found by ADL only for ExpectedExt arguments. C++20 synthesizes operator!=
-        // and the reversed forms (value == expected, Unexpected == expected) from
-        // these. std::expected intentionally has NO ordering operators (an
-        // value-or-error has no natural order), so none are provided here.
+        // Monadic operations. Functions applied to the success state take no arguments.
         //
+
+        //! Chains an operation on success. The function takes no arguments and must return
+        //! ExpectedExt<U, E>.
+        template<typename Func>
+        [[nodiscard]] constexpr auto and_then(Func && func) const &
+        {
+            return andThen(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto and_then(Func && func) &&
+        {
+            return andThen(std::move(*this), std::forward<Func>(func));
+        }
+
+        //! Fallback handler if there's an error
+        template<typename Func>
+        [[nodiscard]] constexpr auto or_else(Func && func) const &
+        {
+            return orElse(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto or_else(Func && func) &&
+        {
+            return orElse(std::move(*this), std::forward<Func>(func));
+        }
+
+        //! Runs func on success; its result (possibly void) becomes the new value.
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform(Func && func) const &
+        {
+            return transformValue(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform(Func && func) &&
+        {
+            return transformValue(std::move(*this), std::forward<Func>(func));
+        }
+
+        //! Transforms the error value.
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform_error(Func && func) const &
+        {
+            return transformError(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform_error(Func && func) &&
+        {
+            return transformError(std::move(*this), std::forward<Func>(func));
+        }
+
         [[nodiscard]] friend constexpr bool operator==(const ExpectedExt & lhs, const ExpectedExt & rhs)
         {
             if(lhs.has_value() != rhs.has_value())
             {
                 return false;
             }
-            return lhs.has_value() ? (lhs.value() == rhs.value()) : (lhs.error() == rhs.error());
+            return lhs.has_value() || lhs.m_error == rhs.m_error;
         }
 
-        [[nodiscard]] friend constexpr bool operator==(const ExpectedExt & lhs, const T & val)
+        [[nodiscard]] friend constexpr bool operator==(const ExpectedExt & lhs, const Unexpected<E> & unex)
         {
-            return lhs.has_value() && lhs.value() == val;
+            return !lhs.has_value() && lhs.m_error == unex.error;
         }
 
-        [[nodiscard]] friend constexpr bool operator==(const ExpectedExt & lhs, const Unexpected<E> & unex)
+    private:
+        constexpr void checkError() const
         {
-            return !lhs.has_value() && lhs.error() == unex.error;
+            if(m_hasValue)
+            {
+                throw BadExpectedAccess();
+            }
         }
 
-    private:
-        struct ValueBox
+        template<typename Self, typename Func>
+        static constexpr auto andThen(Self && self, Func && func)
         {
-            T data;
-        };
-        struct ErrorBox
+            using Raw = std::remove_cvref_t<std::invoke_result_t<Func>>;
+            static_assert(is_expected_ext<Raw>::value,
+                          "and_then requires a function returning ExpectedExt; "
+                          "use transform() for plain values");
+
+            using Ret = ExpectedExt<typename Raw::value_type, E>;
+            if(!self.has_value())
+            {
+                return Ret(unexpect, std::forward<Self>(self).m_error);
+            }
+            return Ret(std::invoke(std::forward<Func>(func)));
+        }
+
+        template<typename Self, typename Func>
+        static constexpr auto orElse(Self && self, Func && func)
+        {
+            using ErrorRef = decltype((std::forward<Self>(self).m_error));
+            using Ret = std::remove_cvref_t<std::invoke_result_t<Func, ErrorRef>>;
+            if(self.has_value())
+            {
+                return Ret();
+            }
+            return Ret(std::invoke(std::forward<Func>(func), std::forward<Self>(self).m_error));
+        }
+
+        template<typename Self, typename Func>
+        static constexpr auto transformValue(Self && self, Func && func)
         {
-            E data;
+            using U = std::remove_cvref_t<std::invoke_result_t<Func>>;
+            if(!self.has_value())
+            {
+                return ExpectedExt<U, E>(unexpect, std::forward<Self>(self).m_error);
+            }
+            if constexpr(std::is_void_v<U>)
+            {
+                std::invoke(std::forward<Func>(func));
+                return ExpectedExt<void, E>();
+            }
+            else
+            {
+                return ExpectedExt<U, E>(std::in_place, std::invoke(std::forward<Func>(func)));
+            }
+        }
+
+        template<typename Self, typename Func>
+        static constexpr auto transformError(Self && self, Func && func)
+        {
+            using ErrorRef = decltype((std::forward<Self>(self).m_error));
+            using E2 = std::remove_cvref_t<std::invoke_result_t<Func, ErrorRef>>;
+            if(self.has_value())
+            {
+                return ExpectedExt<void, E2>();
+            }
+            return ExpectedExt<void, E2>(
+              unexpect, std::invoke(std::forward<Func>(func), std::forward<Self>(self).m_error));
+        }
+
+        template<typename G>
+        constexpr void assignError(G && err)
+        {
+            if(!m_hasValue)
+            {
+                m_error = std::forward<G>(err);
+            }
+            else
+            {
+                std::construct_at(std::addressof(m_error), std::forward<G>(err));
+                m_hasValue = false;
+            }
+        }
+
+        union
+        {
+            E m_error;
         };
-        std::variant<ValueBox, ErrorBox> m_data;
+        bool m_hasValue;
     };
 
     //
@@ -239,6 +998,14 @@ namespace lbnl
         return ExpectedExt<T, E>(std::move(value));
     }
 
+    //! Success for ExpectedExt<void, E>: make_expected<void, E>()
+    template<typename T, typename E>
+        requires std::is_void_v<T>
+    [[nodiscard]] constexpr ExpectedExt<T, E> make_expected()
+    {
+        return ExpectedExt<T, E>();
+    }
+
     template<typename T, typename E>
     [[nodiscard]] constexpr ExpectedExt<T, E> make_unexpected(E error)
     {
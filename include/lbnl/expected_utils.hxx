@@ -0,0 +1,213 @@
+// expected_utils.hxx
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithm/element_forwarding.hxx"
+#include "detail/parallel_for.hxx"
+#include "expected.hxx"
+
+namespace lbnl
+{
+    namespace detail
+    {
+        template<typename R>
+        using expected_element_t = std::remove_cvref_t<std::ranges::range_reference_t<R>>;
+
+        template<typename R>
+        concept ExpectedRange =
+          std::ranges::input_range<R> && is_expected_ext<expected_element_t<R>>::value;
+
+        template<typename Func, typename R>
+        using expected_invoke_t =
+          std::remove_cvref_t<std::invoke_result_t<Func &, std::ranges::range_reference_t<const R>>>;
+    }   // namespace detail
+
+    //! Collects a range of ExpectedExt<T, E> into ExpectedExt<std::vector<T>, E>. Stops at the
+    //! first error and returns it; elements after it are not read. For ExpectedExt<void, E>
+    //! elements the result is ExpectedExt<void, E>.
+    //! An owning range passed as an rvalue (e.g. std::move(results)) has its values moved out.
+    template<detail::ExpectedRange R>
+    [[nodiscard]] constexpr auto collect(R && range)
+    {
+        using Element = detail::expected_element_t<R>;
+        using T = typename Element::value_type;
+        using E = typename Element::error_type;
+
+        if constexpr(std::is_void_v<T>)
+        {
+            for(auto && element : range)
+            {
+                if(!element.has_value())
+                {
+                    return ExpectedExt<void, E>(unexpect,
+                                                detail::element_from<R>(element).error_unchecked());
+                }
+            }
+            return ExpectedExt<void, E>();
+        }
+        else
+        {
+            std::vector<T> values;
+            if constexpr(std::ranges::sized_range<R>)
+            {
+                values.reserve(std::ranges::size(range));
+            }
+
+            for(auto && element : range)
+            {
+                if(!element.has_value())
+                {
+                    return ExpectedExt<std::vector<T>, E>(
+                      unexpect, detail::element_from<R>(element).error_unchecked());
+                }
+                values.push_back(detail::element_from<R>(element).value_unchecked());
+            }
+            return ExpectedExt<std::vector<T>, E>(std::in_place, std::move(values));
+        }
+    }
+
+    //! Splits a range of ExpectedExt<T, E> into its values and its errors, each in input order.
+    //! When the range stores its elements (a forward range yielding references), the has_value()
+    //! flags are counted first so both vectors are allocated exactly once; the payloads are then
+    //! read in a single pass. Ranges that compute their elements are traversed once.
+    //! \return A pair of vectors: the values, then the errors.
+    template<detail::ExpectedRange R>
+        requires(!std::is_void_v<typename detail::expected_element_t<R>::value_type>)
+    [[nodiscard]] constexpr auto partition_results(R && range)
+    {
+        using Element = detail::expected_element_t<R>;
+        using T = typename Element::value_type;
+        using E = typename Element::error_type;
+
+        std::pair<std::vector<T>, std::vector<E>> result;
+        if constexpr(std::ranges::forward_range<R>
+                     && std::is_lvalue_reference_v<std::ranges::range_reference_t<R>>)
+        {
+            std::size_t valueCount = 0;
+            std::size_t errorCount = 0;
+            for(const auto & element : range)
+            {
+                element.has_value() ? ++valueCount : ++errorCount;
+            }
+            result.first.reserve(valueCount);
+            result.second.reserve(errorCount);
+        }
+
+        for(auto && element : range)
+        {
+            if(element.has_value())
+            {
+                result.first.push_back(detail::element_from<R>(element).value_unchecked());
+            }
+            else
+            {
+                result.second.push_back(detail::element_from<R>(element).error_unchecked());
+            }
+        }
+        return result;
+    }
+
+    //! Applies func, which returns ExpectedExt<U, E>, to every element on up to concurrency
+    //! threads (the calling thread included) and collects the values in input order.
+    //! Elements are claimed in input order; once any call fails, no new calls are started. The
+    //! error returned is the one at the lowest input position, so it is the same error a
+    //! sequential collect() would report. An exception thrown by func is rethrown after the
+    //! started calls finish.
+    template<std::ranges::forward_range R, typename Func>
+        requires is_expected_ext<detail::expected_invoke_t<Func, R>>::value
+    [[nodiscard]] auto transform_expected(const R & range, Func && func, std::size_t concurrency)
+    {
+        using Result = detail::expected_invoke_t<Func, R>;
+        using U = typename Result::value_type;
+        using E = typename Result::error_type;
+        using Slot = std::conditional_t<std::is_void_v<U>, bool, std::optional<U>>;
+
+        std::vector<std::ranges::iterator_t<const R>> pending;
+        for(auto iter = std::ranges::begin(range); iter != std::ranges::end(range); ++iter)
+        {
+            pending.push_back(iter);
+        }
+
+        const std::size_t total = pending.size();
+        std::vector<Slot> slots(total);
+
+        std::mutex failureMutex;
+        std::size_t failureIndex = total;
+        std::optional<E> failure;
+        std::exception_ptr exception;
+
+        auto fail = [&](std::size_t index, auto && record) {
+            std::lock_guard lock(failureMutex);
+            if(index < failureIndex)
+            {
+                failureIndex = index;
+                record();
+            }
+            return false;   // no new calls are started
+        };
+
+        detail::parallel_for(total, concurrency, [&](std::size_t index) {
+            try
+            {
+                auto result = std::invoke(func, *pending[index]);
+                if(!result.has_value())
+                {
+                    return fail(index, [&]() {
+                        failure.emplace(std::move(result).error_unchecked());
+                        exception = nullptr;
+                    });
+                }
+                if constexpr(!std::is_void_v<U>)
+                {
+                    slots[index].emplace(std::move(result).value_unchecked());
+                }
+                return true;
+            }
+            catch(...)
+            {
+                return fail(index, [&]() {
+                    failure.reset();
+                    exception = std::current_exception();
+                });
+            }
+        });
+
+        if(exception)
+        {
+            std::rethrow_exception(exception);
+        }
+
+        if constexpr(std::is_void_v<U>)
+        {
+            if(failure)
+            {
+                return ExpectedExt<void, E>(unexpect, std::move(*failure));
+            }
+            return ExpectedExt<void, E>();
+        }
+        else
+        {
+            if(failure)
+            {
+                return ExpectedExt<std::vector<U>, E>(unexpect, std::move(*failure));
+            }
+            std::vector<U> values;
+            values.reserve(total);
+            for(auto & slot : slots)
+            {
+                values.push_back(std::move(*slot));
+            }
+            return ExpectedExt<std::vector<U>, E>(std::in_place, std::move(values));
+        }
+    }
+
+}   // namespace lbnl
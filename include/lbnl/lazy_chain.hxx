@@ -0,0 +1,377 @@
+// lazy_chain.hxx
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expected.hxx"
+#include "optional.hxx"
+
+namespace lbnl
+{
+    namespace detail
+    {
+        template<typename F>
+        struct MapStage
+        {
+            F func;
+        };
+
+        template<typename F>
+        struct AndThenStage
+        {
+            F func;
+        };
+
+        template<typename Stage>
+        struct is_map_stage : std::false_type
+        {};
+
+        template<typename F>
+        struct is_map_stage<MapStage<F>> : std::true_type
+        {};
+
+        template<typename S>
+        concept OptionalChainSource = is_std_optional<S>::value || is_optional_ext<S>::value;
+
+        template<typename S>
+        concept ExpectedChainSource =
+          is_expected_ext<S>::value && !std::is_void_v<typename S::value_type>;
+
+        // Type of the value at the end of the chain. Input is how the current value is passed to
+        // the next stage (a reference, or a prvalue type for a freshly computed value).
+        template<typename Input, typename... Stages>
+        struct chain_value
+        {
+            using type = std::remove_cvref_t<Input>;
+        };
+
+        template<typename Input, typename F, typename... Rest>
+        struct chain_value<Input, MapStage<F>, Rest...> :
+            chain_value<std::invoke_result_t<F &, Input>, Rest...>
+        {};
+
+        template<typename Input, typename F, typename... Rest>
+        struct chain_value<Input, AndThenStage<F>, Rest...> :
+            chain_value<decltype(*std::declval<std::invoke_result_t<F &, Input>>()), Rest...>
+        {};
+
+        [[noreturn]] inline void unreachable()
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            __assume(false);
+#else
+            __builtin_unreachable();
+#endif
+        }
+    }   // namespace detail
+
+    //
+    // LazyChain: a deferred chain of map / and_then steps over an OptionalExt, std::optional or
+    // ExpectedExt. Each step only records its function; nothing runs and no intermediate
+    // OptionalExt / ExpectedExt is built until a terminal operation (value_or, value,
+    // operator*, collect) is called. The terminal then runs one test of the source, the
+    // functions as one nested call sequence (map results are passed straight on as
+    // temporaries), and one test per and_then step, which is the code one would write by hand:
+    //
+    //   if(opt) { if(auto r = g(f(*opt)); r) { return h(*r); } }
+    //   return fallback;
+    //
+    // A chain built from an lvalue refers to it (like a view) and must not outlive it. A chain
+    // built from an rvalue owns its source and moves it into the first function.
+    //
+    template<typename Source, typename... Stages>
+    class LazyChain
+    {
+        using SourceType = std::remove_cvref_t<Source>;
+        static constexpr bool isExpected = is_expected_ext<SourceType>::value;
+
+    public:
+        template<typename S>
+        constexpr LazyChain(S && source, std::tuple<Stages...> stages) :
+            m_source(std::forward<S>(source)),
+            m_stages(std::move(stages))
+        {}
+
+        //! Adds a step that transforms the value
+        template<typename Func>
+        [[nodiscard]] constexpr auto map(Func && func) const &
+        {
+            return append<detail::MapStage<std::decay_t<Func>>>(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto map(Func && func) &&
+        {
+            return append<detail::MapStage<std::decay_t<Func>>>(std::move(*this),
+                                                                 std::forward<Func>(func));
+        }
+
+        // C++23-like synonym for map
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform(Func && func) const &
+        {
+            return map(std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto transform(Func && func) &&
+        {
+            return std::move(*this).map(std::forward<Func>(func));
+        }
+
+        //! Adds a step whose function returns an optional (or, for an ExpectedExt source, an
+        //! ExpectedExt); an empty result ends the chain
+        template<typename Func>
+        [[nodiscard]] constexpr auto and_then(Func && func) const &
+        {
+            return append<detail::AndThenStage<std::decay_t<Func>>>(*this,
+                                                                     std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        [[nodiscard]] constexpr auto and_then(Func && func) &&
+        {
+            return append<detail::AndThenStage<std::decay_t<Func>>>(std::move(*this),
+                                                                     std::forward<Func>(func));
+        }
+
+        //! Runs the chain; returns the fallback if the source or any and_then step is empty
+        template<typename U>
+        [[nodiscard]] constexpr auto value_or(U && fallback) const &
+        {
+            return valueOr(*this, std::forward<U>(fallback));
+        }
+
+        template<typename U>
+        [[nodiscard]] constexpr auto value_or(U && fallback) &&
+        {
+            return valueOr(std::move(*this), std::forward<U>(fallback));
+        }
+
+        //! Runs the chain; throws std::bad_optional_access (or BadExpectedAccess for an
+        //! ExpectedExt source) if it ends empty
+        [[nodiscard]] constexpr auto value() const &
+        {
+            return checkedValue(*this);
+        }
+
+        [[nodiscard]] constexpr auto value() &&
+        {
+            return checkedValue(std::move(*this));
+        }
+
+        //! Runs the chain (undefined behavior if it ends empty)
+        [[nodiscard]] constexpr auto operator*() const &
+        {
+            return uncheckedValue(*this);
+        }
+
+        [[nodiscard]] constexpr auto operator*() &&
+        {
+            return uncheckedValue(std::move(*this));
+        }
+
+        //! Runs the chain and returns its result as OptionalExt<U> (ExpectedExt<U, E> for an
+        //! ExpectedExt source)
+        [[nodiscard]] constexpr auto collect() const &
+        {
+            return collectResult(*this);
+        }
+
+        [[nodiscard]] constexpr auto collect() &&
+        {
+            return collectResult(std::move(*this));
+        }
+
+    private:
+        template<typename S, typename... Ts>
+        friend class LazyChain;
+
+        template<typename Src>
+        static constexpr decltype(auto) unwrap(Src && source)
+        {
+            if constexpr(isExpected)
+            {
+                return std::forward<Src>(source).value_unchecked();
+            }
+            else
+            {
+                return *std::forward<Src>(source);
+            }
+        }
+
+        template<typename Self>
+        using source_ref_t = decltype((std::declval<Self>().m_source));
+
+        template<typename Self>
+        using result_t = typename detail::chain_value<
+          decltype(unwrap(std::declval<source_ref_t<Self>>())),
+          Stages...>::type;
+
+        template<typename Stage, typename Self, typename Func>
+        static constexpr auto append(Self && self, Func && func)
+        {
+            return LazyChain<Source, Stages..., Stage>(
+              std::forward<Self>(self).m_source,
+              std::tuple_cat(std::forward<Self>(self).m_stages,
+                             std::tuple<Stage>(Stage{std::forward<Func>(func)})));
+        }
+
+        // Runs the stages from index I on. produce() yields the current value: a reference, or
+        // the prvalue of a pending map call, so a chain of maps becomes h(g(f(value))).
+        // onValue(produce) and onEmpty(error...) build the terminal's result.
+        template<std::size_t I,
+                 typename StageTuple,
+                 typename Produce,
+                 typename OnValue,
+                 typename OnEmpty>
+        static constexpr auto
+          run(StageTuple & stages, Produce && produce, OnValue & onValue, OnEmpty & onEmpty)
+        {
+            if constexpr(I == sizeof...(Stages))
+            {
+                return onValue(produce);
+            }
+            else
+            {
+                auto & stage = std::get<I>(stages);
+                if constexpr(detail::is_map_stage<std::remove_cvref_t<decltype(stage)>>::value)
+                {
+                    auto next = [&]() -> decltype(auto) {
+                        return std::invoke(stage.func, produce());
+                    };
+                    return run<I + 1>(stages, next, onValue, onEmpty);
+                }
+                else
+                {
+                    auto result = std::invoke(stage.func, produce());
+                    if(!result.has_value())
+                    {
+                        if constexpr(isExpected)
+                        {
+                            return onEmpty(std::move(result).error_unchecked());
+                        }
+                        else
+                        {
+                            return onEmpty();
+                        }
+                    }
+                    auto next = [&]() -> decltype(auto) { return *std::move(result); };
+                    return run<I + 1>(stages, next, onValue, onEmpty);
+                }
+            }
+        }
+
+        template<typename Self, typename OnValue, typename OnEmpty>
+        static constexpr auto evaluate(Self && self, OnValue onValue, OnEmpty onEmpty)
+        {
+            auto && source = std::forward<Self>(self).m_source;
+            if(!source.has_value())
+            {
+                if constexpr(isExpected)
+                {
+                    return onEmpty(std::forward<decltype(source)>(source).error_unchecked());
+                }
+                else
+                {
+                    return onEmpty();
+                }
+            }
+            auto produce = [&]() -> decltype(auto) {
+                return unwrap(std::forward<decltype(source)>(source));
+            };
+            return run<0>(self.m_stages, produce, onValue, onEmpty);
+        }
+
+        template<typename Self, typename U>
+        static constexpr auto valueOr(Self && self, U && fallback)
+        {
+            using R = result_t<Self>;
+            return evaluate(
+              std::forward<Self>(self),
+              [](auto & produce) -> R { return produce(); },
+              [&fallback](auto &&...) -> R { return static_cast<R>(std::forward<U>(fallback)); });
+        }
+
+        template<typename Self>
+        static constexpr auto checkedValue(Self && self)
+        {
+            using R = result_t<Self>;
+            return evaluate(
+              std::forward<Self>(self),
+              [](auto & produce) -> R { return produce(); },
+              [](auto &&...) -> R {
+                  if constexpr(isExpected)
+                  {
+                      throw BadExpectedAccess();
+                  }
+                  else
+                  {
+                      throw std::bad_optional_access();
+                  }
+              });
+        }
+
+        template<typename Self>
+        static constexpr auto uncheckedValue(Self && self)
+        {
+            using R = result_t<Self>;
+            return evaluate(
+              std::forward<Self>(self),
+              [](auto & produce) -> R { return produce(); },
+              [](auto &&...) -> R { detail::unreachable(); });
+        }
+
+        template<typename Self>
+        static constexpr auto collectResult(Self && self)
+        {
+            using R = result_t<Self>;
+            if constexpr(isExpected)
+            {
+                using Ret = ExpectedExt<R, typename SourceType::error_type>;
+                return evaluate(
+                  std::forward<Self>(self),
+                  [](auto & produce) -> Ret { return Ret(std::in_place, produce()); },
+                  [](auto && error) -> Ret {
+                      return Ret(unexpect, std::forward<decltype(error)>(error));
+                  });
+            }
+            else
+            {
+                using Ret = OptionalExt<R>;
+                return evaluate(
+                  std::forward<Self>(self),
+                  [](auto & produce) -> Ret {
+                      return Ret(std::optional<R>(std::in_place, produce()));
+                  },
+                  []() -> Ret { return Ret(std::nullopt); });
+            }
+        }
+
+        Source m_source;
+        std::tuple<Stages...> m_stages;
+    };
+
+    //! Starts a lazy chain over an OptionalExt, std::optional or ExpectedExt. An lvalue source
+    //! is referenced, an rvalue source is moved into the chain.
+    template<typename S>
+        requires detail::OptionalChainSource<std::remove_cvref_t<S>>
+                 || detail::ExpectedChainSource<std::remove_cvref_t<S>>
+    [[nodiscard]] constexpr auto lazy(S && source)
+    {
+        if constexpr(std::is_lvalue_reference_v<S>)
+        {
+            return LazyChain<const std::remove_cvref_t<S> &>(source, std::tuple<>());
+        }
+        else
+        {
+            return LazyChain<std::remove_cvref_t<S>>(std::move(source), std::tuple<>());
+        }
+    }
+
+}   // namespace lbnl
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <optional>
 #include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace lbnl
@@ -17,6 +22,33 @@ namespace lbnl
           { m.end() } -> std::same_as<typename Map::const_iterator>;
       };
 
+    //
+    // Concept for containers that accept lookups with keys of another type
+    // (std::map with std::less<>, std::unordered_map with transparent hash and equality).
+    //
+    template<typename Map>
+    concept TransparentLookup =
+      requires { typename Map::key_compare::is_transparent; }
+      || requires {
+             typename Map::hasher::is_transparent;
+             typename Map::key_equal::is_transparent;
+         };
+
+    //
+    // Transparent hash for string keys: std::string, std::string_view and const char *
+    // all hash the same way, so lookups need no temporary std::string.
+    // Pair with std::equal_to<> as the key equality.
+    //
+    struct TransparentStringHash
+    {
+        using is_transparent = void;
+
+        [[nodiscard]] std::size_t operator()(std::string_view str) const noexcept
+        {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
     //
     // Returns an optional value if the key exists in the map.
     //
@@ -30,6 +62,24 @@ namespace lbnl
         return std::nullopt;
     }
 
+    //
+    // Heterogeneous overload: looks up with a key of another type (e.g. std::string_view in a
+    // std::string-keyed map) without building a key_type. Only for containers with transparent
+    // comparison or hashing.
+    //
+    template<AssociativeContainer Map, typename K>
+        requires TransparentLookup<Map>
+                 && (!std::same_as<std::remove_cvref_t<K>, typename Map::key_type>)
+                 && requires(const Map& m, const K& key) { m.find(key); }
+    [[nodiscard]] constexpr auto map_lookup_by_key(const Map& m, const K& key)
+      -> std::optional<typename Map::mapped_type>
+    {
+        auto it = m.find(key);
+        if (it != m.end())
+            return it->second;
+        return std::nullopt;
+    }
+
     //
     // Returns an optional key if a given value exists in the map.
     // Note: This performs a linear search through all map entries.
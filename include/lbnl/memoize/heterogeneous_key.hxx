@@ -0,0 +1,25 @@
+// memoize/heterogeneous_key.hxx
+#pragma once
+
+#include <type_traits>
+
+namespace lbnl
+{
+    //
+    // True when Hash and KeyEqual both accept keys of other types (C++20 heterogeneous lookup).
+    //
+    template<typename Hash, typename KeyEqual>
+    concept TransparentHashing = requires {
+        typename Hash::is_transparent;
+        typename KeyEqual::is_transparent;
+    };
+
+    //
+    // Lookup key type other than Key that a transparent Hash/KeyEqual pair can find directly.
+    //
+    template<typename K, typename Key, typename Hash, typename KeyEqual>
+    concept HeterogeneousKey = TransparentHashing<Hash, KeyEqual>
+                               && !std::is_same_v<std::remove_cvref_t<K>, Key>
+                               && std::is_constructible_v<Key, const K &>;
+
+}   // namespace lbnl
@@ -0,0 +1,204 @@
+// memoize/inline_lazy_evaluator.hxx
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "heterogeneous_key.hxx"
+
+namespace lbnl
+{
+    //
+    // InlineLazyEvaluator: LazyEvaluator variant for caches with many small values.
+    // The generator is a template parameter (no std::function, no indirect call) and each value
+    // lives inside its map node next to a one-byte state word, so a miss allocates only the node:
+    // no promise, no shared future state. Threads asking for a key that is being computed block
+    // on std::atomic::wait until the computing thread publishes the value.
+    //
+    // If the generator throws, the exception reaches the caller that ran it, the slot returns to
+    // empty and one of the waiting threads retries the computation.
+    //
+    template<typename Key,
+             typename Value,
+             typename Generator,
+             typename Hash = std::hash<Key>,
+             typename KeyEqual = std::equal_to<Key>>
+        requires std::is_invocable_r_v<Value, Generator &, const Key &>
+    class InlineLazyEvaluator
+    {
+    public:
+        explicit InlineLazyEvaluator(Generator generator) : m_Generator(std::move(generator))
+        {}
+
+        const Value & operator()(const Key & key)
+        {
+            return get(key);
+        }
+
+        template<typename K>
+            requires HeterogeneousKey<K, Key, Hash, KeyEqual>
+        const Value & operator()(const K & key)
+        {
+            return getImpl(key);
+        }
+
+        //! Returns the cached value, computing it on the calling thread if needed.
+        const Value & get(const Key & key)
+        {
+            return getImpl(key);
+        }
+
+        template<typename K>
+            requires HeterogeneousKey<K, Key, Hash, KeyEqual>
+        const Value & get(const K & key)
+        {
+            return getImpl(key);
+        }
+
+        //! Returns the value if it is already computed, nullptr otherwise. Never blocks.
+        [[nodiscard]] const Value * try_get(const Key & key) const
+        {
+            std::shared_lock readLock(m_Mutex, std::try_to_lock);
+            if(!readLock.owns_lock())
+            {
+                return nullptr;
+            }
+            auto iter = m_Cache.find(key);
+            if(iter == m_Cache.end() || iter->second.state.load(std::memory_order_acquire) != Ready)
+            {
+                return nullptr;
+            }
+            return &iter->second.value();
+        }
+
+    private:
+        enum State : std::uint8_t
+        {
+            Empty,
+            Computing,
+            Ready
+        };
+
+        //! Map node payload: state word plus raw storage for the value.
+        struct Slot
+        {
+            std::atomic<std::uint8_t> state{Empty};
+            alignas(Value) unsigned char storage[sizeof(Value)];
+
+            Slot() = default;
+            Slot(const Slot &) = delete;
+            Slot & operator=(const Slot &) = delete;
+
+            ~Slot()
+            {
+                if(state.load(std::memory_order_relaxed) == Ready)
+                {
+                    value().~Value();
+                }
+            }
+
+            [[nodiscard]] const Value & value() const noexcept
+            {
+                return *std::launder(reinterpret_cast<const Value *>(storage));
+            }
+
+            [[nodiscard]] Value & value() noexcept
+            {
+                return *std::launder(reinterpret_cast<Value *>(storage));
+            }
+        };
+
+        template<typename K>
+        const Value & getImpl(const K & key)
+        {
+            auto [stored, slot] = findOrInsert(key);
+
+            for(;;)
+            {
+                auto current = slot->state.load(std::memory_order_acquire);
+                if(current == Ready)
+                {
+                    return slot->value();
+                }
+
+                if(current == Empty)
+                {
+                    std::uint8_t expected = Empty;
+                    if(slot->state.compare_exchange_strong(expected, Computing, std::memory_order_acquire))
+                    {
+                        return compute(*stored, *slot);
+                    }
+                    continue;
+                }
+
+                slot->state.wait(Computing, std::memory_order_acquire);
+            }
+        }
+
+        //! Runs the generator (no lock held) and publishes the value to waiters.
+        const Value & compute(const Key & key, Slot & slot)
+        {
+            try
+            {
+                ::new(static_cast<void *>(slot.storage)) Value(std::invoke(m_Generator, key));
+            }
+            catch(...)
+            {
+                slot.state.store(Empty, std::memory_order_release);
+                slot.state.notify_all();
+                throw;
+            }
+            slot.state.store(Ready, std::memory_order_release);
+            slot.state.notify_all();
+            return slot.value();
+        }
+
+        //! Returns the stored key and its slot, inserting an empty slot on a miss.
+        //! Nodes never move, so both pointers stay valid for the evaluator's lifetime.
+        template<typename K>
+        std::pair<const Key *, Slot *> findOrInsert(const K & key)
+        {
+            {
+                std::shared_lock readLock(m_Mutex);
+                auto iter = m_Cache.find(key);
+                if(iter != m_Cache.end())
+                {
+                    return {&iter->first, &iter->second};
+                }
+            }
+
+            std::unique_lock writeLock(m_Mutex);
+            auto iter = m_Cache.find(key);
+            if(iter == m_Cache.end())
+            {
+                iter = m_Cache.try_emplace(Key(key)).first;
+            }
+            return {&iter->first, &iter->second};
+        }
+
+        Generator m_Generator;
+        std::unordered_map<Key, Slot, Hash, KeyEqual> m_Cache;
+        mutable std::shared_mutex m_Mutex;
+    };
+
+    //! Builds an InlineLazyEvaluator, deducing the generator type and the value type from it:
+    //!   auto cache = lbnl::make_inline_lazy_evaluator<int>([](int key) { return key * 2.0; });
+    template<typename Key,
+             typename Hash = std::hash<Key>,
+             typename KeyEqual = std::equal_to<Key>,
+             typename Generator>
+    [[nodiscard]] auto make_inline_lazy_evaluator(Generator && generator)
+    {
+        using Value = std::remove_cvref_t<std::invoke_result_t<Generator &, const Key &>>;
+        return InlineLazyEvaluator<Key, Value, std::decay_t<Generator>, Hash, KeyEqual>(
+          std::forward<Generator>(generator));
+    }
+
+}   // namespace lbnl
@@ -0,0 +1,935 @@
+// memoize/lazy_evaluator.hxx
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../detail/parallel_for.hxx"
+#include "heterogeneous_key.hxx"
+
+namespace lbnl
+{
+    template<typename Key, typename Value, typename Hash, typename KeyEqual, std::size_t Slots>
+    class FrontCache;
+
+    //! Hash and KeyEqual default to std::hash<Key> and std::equal_to<Key>. When both are
+    //! transparent (e.g. TransparentStringHash from map_utils.hxx with std::equal_to<>), get,
+    //! try_get and get_for also accept any type Key can be built from, and the Key is only
+    //! constructed when a miss inserts a new entry.
+    //!
+    //! Entries can be erased, invalidated or given a time to live. Entries removed from the
+    //! cache are retired rather than destroyed, so references returned by get() stay valid
+    //! until the owner calls release_retired() or the evaluator is destroyed. Long-running
+    //! services call release_retired() at quiescent points to bound memory.
+    template<typename Key,
+             typename Value,
+             typename Hash = std::hash<Key>,
+             typename KeyEqual = std::equal_to<Key>>
+    class LazyEvaluator
+    {
+    public:
+        using Generator = std::function<Value(const Key &)>;
+
+        //! Unit of work handed to an executor by get_async() and refresh-ahead.
+        using Task = std::function<void()>;
+
+        using Clock = std::chrono::steady_clock;
+
+        //! Returns how long a freshly computed entry stays valid.
+        using TtlPolicy = std::function<Clock::duration(const Key &, const Value &)>;
+
+        explicit LazyEvaluator(Generator generator) : m_Generator(std::move(generator))
+        {}
+
+        //
+        // Pin: while it is alive, release_retired() keeps the entries removed after it was
+        // taken, so references obtained under it stay valid even if another thread releases
+        // retired entries. get_async() tasks and get_for() waits hold one internally. Pins are
+        // cheap (two atomic operations) but hold back release_retired(), so keep them short.
+        //
+        class Pin
+        {
+        public:
+            Pin(Pin && other) noexcept :
+                m_Owner(std::exchange(other.m_Owner, nullptr)),
+                m_Epoch(other.m_Epoch)
+            {}
+
+            Pin(const Pin &) = delete;
+            Pin & operator=(const Pin &) = delete;
+            Pin & operator=(Pin &&) = delete;
+
+            ~Pin()
+            {
+                if(m_Owner != nullptr)
+                {
+                    m_Owner->leaveEpoch(m_Epoch);
+                }
+            }
+
+        private:
+            friend class LazyEvaluator;
+
+            explicit Pin(const LazyEvaluator & owner) : m_Owner(&owner), m_Epoch(owner.enterEpoch())
+            {}
+
+            const LazyEvaluator * m_Owner;
+            std::uint64_t m_Epoch;
+        };
+
+        [[nodiscard]] Pin pin() const
+        {
+            return Pin(*this);
+        }
+
+        const Value & operator()(const Key & key)
+        {
+            return get(key);
+        }
+
+        template<typename K>
+            requires HeterogeneousKey<K, Key, Hash, KeyEqual>
+        const Value & operator()(const K & key)
+        {
+            return getImpl(key);
+        }
+
+        //! Returns the cached value, computing it on the calling thread if needed.
+        //! Concurrent callers asking for a key that is being computed wait for that result.
+        const Value & get(const Key & key)
+        {
+            return getImpl(key);
+        }
+
+        //! Heterogeneous lookup, e.g. a std::string_view into a std::string-keyed evaluator.
+        template<typename K>
+            requires HeterogeneousKey<K, Key, Hash, KeyEqual>
+        const Value & get(const K & key)
+        {
+            return getImpl(key);
+        }
+
+        //! Like get(), but on a miss the value is produced by make() instead of the generator.
+        //! Useful when the key does not carry everything needed to compute the value.
+        //! The single-computation guarantee is the same: only one make() runs per key.
+        template<typename K, typename Make>
+            requires(std::is_same_v<K, Key> || HeterogeneousKey<K, Key, Hash, KeyEqual>)
+                    && std::is_invocable_r_v<Value, Make &>
+        const Value & get_with(const K & key, Make && make)
+        {
+            return getImpl(key, [&make](const Key &) { return std::invoke(make); });
+        }
+
+        //! Starts computing the value on the given executor and returns immediately.
+        //! The executor is any callable accepting a Task; it decides where the generator runs.
+        //! If the key is already cached or in flight, the existing result is returned and
+        //! nothing is submitted.
+        template<typename Executor>
+            requires std::invocable<Executor &, Task>
+        [[nodiscard]] std::shared_future<Value> get_async(const Key & key, Executor && executor)
+        {
+            auto section = pin();
+            auto lookup = findOrInsert(key);
+            if(lookup.refresh)
+            {
+                scheduleRefresh(key);
+            }
+            if(lookup.promise)
+            {
+                // Whoever claims the slot first completes it: the task, or the catch below if
+                // the executor throws. An executor may queue the task and still throw, and the
+                // task must then leave the released slot alone.
+                // The pin keeps the entry alive until the task is done with it.
+                struct Pending
+                {
+                    std::promise<Value> promise;
+                    Pin section;
+                    std::atomic<bool> claimed{false};
+                };
+                auto pending =
+                  std::make_shared<Pending>(std::move(*lookup.promise), std::move(section));
+                Entry * entry = lookup.entry;
+                try
+                {
+                    std::invoke(executor, Task{[this, key, entry, pending]() {
+                                    if(!pending->claimed.exchange(true, std::memory_order_acq_rel))
+                                    {
+                                        fulfill(key, *entry, pending->promise);
+                                    }
+                                }});
+                }
+                catch(...)
+                {
+                    // Executor refused the task; release the slot so waiters do not hang.
+                    if(!pending->claimed.exchange(true, std::memory_order_acq_rel))
+                    {
+                        fail(key, *entry, pending->promise, std::current_exception());
+                    }
+                    throw;
+                }
+            }
+            return lookup.future;
+        }
+
+        //! Returns the value if it is already computed, nullptr otherwise.
+        //! Never blocks and never starts a computation.
+        [[nodiscard]] const Value * try_get(const Key & key) const
+        {
+            return tryGetImpl(key);
+        }
+
+        template<typename K>
+            requires HeterogeneousKey<K, Key, Hash, KeyEqual>
+        [[nodiscard]] const Value * try_get(const K & key) const
+        {
+            return tryGetImpl(key);
+        }
+
+        //! Waits at most timeout for a value that is cached or being computed by another caller.
+        //! Returns nullptr if the key is unknown, the value is not ready in time, the computation
+        //! failed, or the entry was removed during the wait. Never throws the generator's error.
+        //! Does not start a computation; pair it with get_async() for that.
+        template<typename Rep, typename Period>
+        [[nodiscard]] const Value * get_for(const Key & key,
+                                            const std::chrono::duration<Rep, Period> & timeout) const
+        {
+            return getForImpl(key, timeout);
+        }
+
+        template<typename K, typename Rep, typename Period>
+            requires HeterogeneousKey<K, Key, Hash, KeyEqual>
+        [[nodiscard]] const Value * get_for(const K & key,
+                                            const std::chrono::duration<Rep, Period> & timeout) const
+        {
+            return getForImpl(key, timeout);
+        }
+
+        //! Calls func(key, value) for every entry whose value is computed and not stale.
+        //! In-flight entries are skipped. The read lock is held during the walk, so func must
+        //! not call back into this evaluator.
+        template<typename Func>
+            requires std::invocable<Func &, const Key &, const Value &>
+        void for_each_computed(Func && func) const
+        {
+            std::shared_lock readLock(m_Mutex);
+            for(const auto & [key, entry] : m_Cache)
+            {
+                if(entry.ready() && !entry.stale())
+                {
+                    std::invoke(func, key, entry.future.get());
+                }
+            }
+        }
+
+        //! Outcome of prewarm().
+        struct PrewarmReport
+        {
+            //! Keys computed by this call.
+            std::size_t computed{0};
+            //! Keys that were already cached or being computed elsewhere.
+            std::size_t skipped{0};
+            //! Keys whose generator threw, with the exception it threw.
+            std::vector<std::pair<Key, std::exception_ptr>> failures;
+        };
+
+        //! Called as progress(done, total) after each key; calls are serialized.
+        using PrewarmProgress = std::function<void(std::size_t, std::size_t)>;
+
+        //! Fills the cache for keys on up to concurrency worker threads and waits for them.
+        //! Keys that are already cached or in flight are skipped. A failing key does not stop
+        //! the others; it is reported and left uncached so a later request retries it.
+        template<std::ranges::forward_range Keys>
+            requires std::is_same_v<std::remove_cvref_t<std::ranges::range_reference_t<Keys>>, Key>
+                     || HeterogeneousKey<std::remove_cvref_t<std::ranges::range_reference_t<Keys>>,
+                                         Key,
+                                         Hash,
+                                         KeyEqual>
+        PrewarmReport prewarm(const Keys & keys, std::size_t concurrency, PrewarmProgress progress = {})
+        {
+            std::vector<std::ranges::iterator_t<const Keys>> pending;
+            for(auto iter = std::ranges::begin(keys); iter != std::ranges::end(keys); ++iter)
+            {
+                pending.push_back(iter);
+            }
+
+            PrewarmReport report;
+            std::mutex reportMutex;
+            std::atomic<std::size_t> computed{0};
+            std::atomic<std::size_t> skipped{0};
+            std::size_t done = 0;
+            const std::size_t total = pending.size();
+
+            detail::parallel_for(total, concurrency, [&](std::size_t index) {
+                const auto & key = *pending[index];
+                const auto section = pin();
+                auto lookup = findOrInsert(key);
+                if(lookup.refresh)
+                {
+                    scheduleRefresh(Key(key));
+                }
+
+                std::exception_ptr error;
+                if(lookup.promise)
+                {
+                    fulfill(*lookup.stored, *lookup.entry, *lookup.promise);
+                    try
+                    {
+                        (void)lookup.future.get();
+                        ++computed;
+                    }
+                    catch(...)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+                else
+                {
+                    ++skipped;
+                }
+
+                if(error || progress)
+                {
+                    std::lock_guard lock(reportMutex);
+                    if(error)
+                    {
+                        report.failures.emplace_back(Key(key), std::move(error));
+                    }
+                    if(progress)
+                    {
+                        progress(++done, total);
+                    }
+                }
+            });
+
+            report.computed = computed;
+            report.skipped = skipped;
+            return report;
+        }
+
+        //! Every entry computed from now on expires ttl after it was computed.
+        void set_ttl(Clock::duration ttl)
+        {
+            set_ttl(TtlPolicy{[ttl](const Key &, const Value &) { return ttl; }});
+        }
+
+        //! Per-entry time to live: policy(key, value) is asked once, when the value is computed.
+        //! Return Clock::duration::max() for entries that never expire.
+        void set_ttl(TtlPolicy policy)
+        {
+            std::unique_lock writeLock(m_Mutex);
+            m_TtlPolicy = std::move(policy);
+        }
+
+        //! Refresh-ahead mode: a stale entry keeps being served while a single background
+        //! recomputation, submitted to executor, replaces it. Without this mode a stale entry is
+        //! recomputed by the next caller, who waits for it.
+        //! The evaluator must outlive every task submitted to the executor.
+        template<typename Executor>
+            requires std::invocable<Executor &, Task>
+        void enable_refresh_ahead(Executor executor)
+        {
+            std::unique_lock writeLock(m_Mutex);
+            m_RefreshExecutor = [executor = std::move(executor)](Task task) mutable {
+                std::invoke(executor, std::move(task));
+            };
+        }
+
+        //! Removes key from the cache; the next request recomputes it.
+        //! Returns false if the key was not cached.
+        bool erase(const Key & key)
+        {
+            std::unique_lock writeLock(m_Mutex);
+            auto iter = m_Cache.find(key);
+            if(iter == m_Cache.end())
+            {
+                return false;
+            }
+            retire(iter);
+            return true;
+        }
+
+        //! Removes every entry.
+        void clear()
+        {
+            std::unique_lock writeLock(m_Mutex);
+            while(!m_Cache.empty())
+            {
+                retire(m_Cache.begin());
+            }
+        }
+
+        //! Marks key stale. It is recomputed on the next request, or refreshed in the
+        //! background while still being served in refresh-ahead mode.
+        //! Returns false if the key was not cached.
+        bool invalidate(const Key & key)
+        {
+            std::shared_lock readLock(m_Mutex);
+            auto iter = m_Cache.find(key);
+            if(iter == m_Cache.end())
+            {
+                return false;
+            }
+            iter->second.expiry.store(alreadyExpired, std::memory_order_release);
+            m_Generation.fetch_add(1, std::memory_order_acq_rel);
+            return true;
+        }
+
+        //! Marks every entry whose key satisfies pred stale. Returns the number of entries marked.
+        template<typename Predicate>
+            requires std::predicate<Predicate &, const Key &>
+        std::size_t invalidate_if(Predicate pred)
+        {
+            std::shared_lock readLock(m_Mutex);
+            std::size_t count = 0;
+            for(auto & [key, entry] : m_Cache)
+            {
+                if(std::invoke(pred, key))
+                {
+                    entry.expiry.store(alreadyExpired, std::memory_order_release);
+                    ++count;
+                }
+            }
+            if(count > 0)
+            {
+                m_Generation.fetch_add(1, std::memory_order_acq_rel);
+            }
+            return count;
+        }
+
+        //! Frees removed entries. Call it at a quiescent point, where no reference obtained
+        //! from get() to a removed value is still in use, e.g. between simulation steps.
+        //! Entries a live Pin can still reach are kept for a later call.
+        //! Returns the number of entries freed.
+        std::size_t release_retired()
+        {
+            std::unique_lock writeLock(m_Mutex);
+            const auto count = reclaim(2);
+            if(count > 0)
+            {
+                m_Generation.fetch_add(1, std::memory_order_acq_rel);
+            }
+            return count;
+        }
+
+    private:
+        template<typename, typename, typename, typename, std::size_t>
+        friend class FrontCache;
+
+        using Tick = Clock::rep;
+        static constexpr Tick neverExpires = Clock::duration::max().count();
+        static constexpr Tick alreadyExpired = Clock::duration::min().count();
+
+        //! Map payload. Lives in the map node, so its address is stable while the node is
+        //! cached or retired.
+        struct Entry
+        {
+            explicit Entry(std::shared_future<Value> fut) : future(std::move(fut))
+            {}
+
+            [[nodiscard]] bool ready() const
+            {
+                return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }
+
+            [[nodiscard]] bool stale() const
+            {
+                const auto until = expiry.load(std::memory_order_acquire);
+                return until != neverExpires && until <= Clock::now().time_since_epoch().count();
+            }
+
+            std::shared_future<Value> future;
+            //! Clock tick at which the entry becomes stale.
+            std::atomic<Tick> expiry{neverExpires};
+            //! Set while a refresh-ahead recomputation is pending.
+            std::atomic<bool> refreshing{false};
+        };
+
+        using Cache = std::unordered_map<Key, Entry, Hash, KeyEqual>;
+
+        struct Lookup
+        {
+            std::shared_future<Value> future;
+            //! Set when this caller inserted the in-flight slot and must fulfill it.
+            std::optional<std::promise<Value>> promise;
+            //! The slot serving the request.
+            Entry * entry{nullptr};
+            //! The stored key of a new slot; set together with promise.
+            const Key * stored{nullptr};
+            //! Set when this caller must schedule a refresh-ahead recomputation.
+            bool refresh{false};
+        };
+
+        template<typename K>
+        const Value & getImpl(const K & key)
+        {
+            return getImpl(key, m_Generator);
+        }
+
+        //! make(const Key &) computes the value on a miss.
+        template<typename K, typename Make>
+        const Value & getImpl(const K & key, Make && make)
+        {
+            // The entry is used outside the lock while the value is computed
+            const auto section = pin();
+            auto lookup = findOrInsert(key);
+            if(lookup.refresh)
+            {
+                scheduleRefresh(Key(key));
+            }
+            if(lookup.promise)
+            {
+                fulfill(*lookup.stored, *lookup.entry, *lookup.promise, make);
+            }
+            return lookup.future.get();
+        }
+
+        //! get() that also reports the expiry tick of the entry it served, for FrontCache.
+        const Value & getTracked(const Key & key, Tick & expiry)
+        {
+            const auto section = pin();
+            auto lookup = findOrInsert(key);
+            if(lookup.refresh)
+            {
+                scheduleRefresh(key);
+            }
+            if(lookup.promise)
+            {
+                fulfill(*lookup.stored, *lookup.entry, *lookup.promise);
+            }
+            const Value & value = lookup.future.get();
+            expiry = lookup.entry->expiry.load(std::memory_order_acquire);
+            return value;
+        }
+
+        //! A stale entry may still be served in refresh-ahead mode once its value is ready.
+        [[nodiscard]] bool servable(const Entry & entry) const
+        {
+            return !entry.stale() || (m_RefreshExecutor && entry.ready());
+        }
+
+        template<typename K>
+        [[nodiscard]] const Value * tryGetImpl(const K & key) const
+        {
+            std::shared_lock readLock(m_Mutex, std::try_to_lock);
+            if(!readLock.owns_lock())
+            {
+                return nullptr;
+            }
+            auto iter = m_Cache.find(key);
+            if(iter == m_Cache.end() || !iter->second.ready() || !servable(iter->second))
+            {
+                return nullptr;
+            }
+            return &iter->second.future.get();
+        }
+
+        template<typename K, typename Rep, typename Period>
+        [[nodiscard]] const Value * getForImpl(const K & key,
+                                               const std::chrono::duration<Rep, Period> & timeout) const
+        {
+            // The pin keeps the entry from being freed, and its address from being reused,
+            // while this call waits without the lock
+            const auto section = pin();
+            std::shared_future<Value> future;
+            const Entry * entry = nullptr;
+            {
+                std::shared_lock readLock(m_Mutex);
+                auto iter = m_Cache.find(key);
+                if(iter == m_Cache.end() || !servable(iter->second))
+                {
+                    return nullptr;
+                }
+                future = iter->second.future;
+                entry = &iter->second;
+            }
+
+            if(future.wait_for(timeout) != std::future_status::ready)
+            {
+                return nullptr;
+            }
+
+            // Hand out the value of the cached entry, not of the local copy of its future
+            std::shared_lock readLock(m_Mutex);
+            auto iter = m_Cache.find(key);
+            if(iter == m_Cache.end() || &iter->second != entry)
+            {
+                return nullptr;   // failed, erased or replaced while waiting
+            }
+            try
+            {
+                return &iter->second.future.get();
+            }
+            catch(...)
+            {
+                return nullptr;
+            }
+        }
+
+        //! Serves an existing entry if it is fresh, or stale but refreshable. The first caller to
+        //! see a stale entry in refresh-ahead mode is asked to schedule the refresh.
+        [[nodiscard]] std::optional<Lookup> serve(Entry & entry) const
+        {
+            Lookup lookup;
+            lookup.future = entry.future;
+            lookup.entry = &entry;
+            if(!entry.stale())
+            {
+                return lookup;
+            }
+            if(m_RefreshExecutor && entry.ready())
+            {
+                lookup.refresh = !entry.refreshing.exchange(true, std::memory_order_acq_rel);
+                return lookup;
+            }
+            return std::nullopt;
+        }
+
+        //! Returns the future for key. When this caller inserted the in-flight slot, the promise
+        //! it must fulfill is returned as well. The Key is only constructed on insertion.
+        template<typename K>
+        Lookup findOrInsert(const K & key)
+        {
+            // Fast path: check if already computed (shared/read lock)
+            {
+                std::shared_lock readLock(m_Mutex);
+                auto iter = m_Cache.find(key);
+                if(iter != m_Cache.end())
+                {
+                    if(auto served = serve(iter->second))
+                    {
+                        return std::move(*served);
+                    }
+                }
+            }
+
+            // Slow path: need to compute (exclusive/write lock)
+            std::unique_lock writeLock(m_Mutex);
+
+            // Double-check after acquiring write lock; a stale entry is replaced
+            auto iter = m_Cache.find(key);
+            if(iter != m_Cache.end())
+            {
+                if(auto served = serve(iter->second))
+                {
+                    return std::move(*served);
+                }
+                retire(iter);
+            }
+
+            // Create promise/future, insert future into cache
+            std::promise<Value> prom;
+            auto fut = prom.get_future().share();
+            auto [inserted, _] = m_Cache.try_emplace(Key(key), fut);
+
+            return {std::move(fut), std::move(prom), &inserted->second, &inserted->first};
+        }
+
+        //! Moves the node out of the cache; release_retired() frees it later. Never frees
+        //! anything itself, since callers may hold references into older retired nodes.
+        //! Called with the write lock held.
+        void retire(typename Cache::iterator iter)
+        {
+            m_Retired.push_back({m_Cache.extract(iter), m_Epoch.load()});
+            m_Generation.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        //! Registers a reader in the current epoch and returns that epoch.
+        [[nodiscard]] std::uint64_t enterEpoch() const noexcept
+        {
+            for(;;)
+            {
+                const auto epoch = m_Epoch.load();
+                m_Readers[epoch % 3].fetch_add(1);
+                // The epoch may have moved on before the reader was counted; count it again
+                if(m_Epoch.load() == epoch)
+                {
+                    return epoch;
+                }
+                m_Readers[epoch % 3].fetch_sub(1);
+            }
+        }
+
+        void leaveEpoch(std::uint64_t epoch) const noexcept
+        {
+            m_Readers[epoch % 3].fetch_sub(1);
+        }
+
+        //! Advances the epoch up to steps times and frees the retired nodes no reader can reach.
+        //! Readers are only ever pinned in the current epoch or the one before, so the epoch can
+        //! advance once nobody is pinned in the one before. A node retired in epoch e was
+        //! unlinked before any reader of epoch e + 1 started, so it is unreachable once the
+        //! epoch reaches e + 2. Called with the write lock held, which makes this the only
+        //! writer of m_Epoch.
+        std::size_t reclaim(int steps)
+        {
+            auto epoch = m_Epoch.load();
+            for(int step = 0; step < steps && m_Readers[(epoch + 2) % 3].load() == 0; ++step)
+            {
+                m_Epoch.store(++epoch);
+            }
+            return std::erase_if(
+              m_Retired, [epoch](const Retired & retired) { return retired.epoch + 2 <= epoch; });
+        }
+
+        [[nodiscard]] Tick expiryFor(const Key & key, const Value & value) const
+        {
+            std::shared_lock readLock(m_Mutex);
+            if(!m_TtlPolicy)
+            {
+                return neverExpires;
+            }
+            const auto ttl = m_TtlPolicy(key, value);
+            if(ttl == Clock::duration::max())
+            {
+                return neverExpires;
+            }
+            return (Clock::now() + ttl).time_since_epoch().count();
+        }
+
+        //! Runs the generator without holding the lock and publishes the result.
+        void fulfill(const Key & key, Entry & entry, std::promise<Value> & prom)
+        {
+            fulfill(key, entry, prom, m_Generator);
+        }
+
+        template<typename Make>
+        void fulfill(const Key & key, Entry & entry, std::promise<Value> & prom, Make & make)
+        {
+            try
+            {
+                Value value = std::invoke(make, key);
+                // Keep an invalidation that arrived during the computation.
+                auto expected = neverExpires;
+                entry.expiry.compare_exchange_strong(expected, expiryFor(key, value));
+                prom.set_value(std::move(value));
+            }
+            catch(...)
+            {
+                fail(key, entry, prom, std::current_exception());
+            }
+        }
+
+        //! Drops the failed slot so a later request retries, then wakes waiters with the error.
+        void fail(const Key & key, Entry & entry, std::promise<Value> & prom, std::exception_ptr error)
+        {
+            {
+                std::unique_lock writeLock(m_Mutex);
+                // Erase by iterator: key may refer to the stored key itself.
+                auto iter = m_Cache.find(key);
+                if(iter != m_Cache.end() && &iter->second == &entry)
+                {
+                    m_Cache.erase(iter);
+                }
+            }
+            prom.set_exception(std::move(error));
+        }
+
+        void scheduleRefresh(Key key)
+        {
+            std::function<void(Task)> executor;
+            {
+                std::shared_lock readLock(m_Mutex);
+                executor = m_RefreshExecutor;
+            }
+            try
+            {
+                executor(Task{[this, key]() { refresh(key); }});
+            }
+            catch(...)
+            {
+                // Executor refused the task; a later access asks again.
+                endRefresh(key);
+            }
+        }
+
+        //! Background recomputation for refresh-ahead. The stale entry stays in place until the
+        //! new value is ready, then it is retired and replaced.
+        void refresh(const Key & key)
+        {
+            std::promise<Value> prom;
+            auto fresh = prom.get_future().share();
+            Tick expiry = neverExpires;
+            try
+            {
+                Value value = m_Generator(key);
+                expiry = expiryFor(key, value);
+                prom.set_value(std::move(value));
+            }
+            catch(...)
+            {
+                // Keep serving the stale value; a later access retries the refresh.
+                endRefresh(key);
+                return;
+            }
+
+            std::unique_lock writeLock(m_Mutex);
+            auto iter = m_Cache.find(key);
+            if(iter == m_Cache.end() || !iter->second.refreshing.load(std::memory_order_acquire))
+            {
+                return;   // erased or replaced while refreshing
+            }
+            retire(iter);
+            auto [inserted, _] = m_Cache.try_emplace(key, std::move(fresh));
+            inserted->second.expiry.store(expiry, std::memory_order_release);
+        }
+
+        void endRefresh(const Key & key)
+        {
+            std::shared_lock readLock(m_Mutex);
+            if(auto iter = m_Cache.find(key); iter != m_Cache.end())
+            {
+                iter->second.refreshing.store(false, std::memory_order_release);
+            }
+        }
+
+        struct Retired
+        {
+            typename Cache::node_type node;
+            std::uint64_t epoch;
+        };
+
+        Generator m_Generator;
+        Cache m_Cache;
+        std::vector<Retired> m_Retired;
+        TtlPolicy m_TtlPolicy;
+        std::function<void(Task)> m_RefreshExecutor;
+        mutable std::shared_mutex m_Mutex;
+        //! Bumped whenever an entry is retired, invalidated or freed, so that FrontCache copies
+        //! can tell they may be out of date. Kept on its own cache line: it is read on every
+        //! front-cache hit but rarely written.
+        alignas(64) std::atomic<std::uint64_t> m_Generation{0};
+        //! Reclamation epoch and the number of readers pinned in each of the last three epochs.
+        alignas(64) mutable std::atomic<std::uint64_t> m_Epoch{0};
+        mutable std::array<std::atomic<std::size_t>, 3> m_Readers{};
+    };
+
+    //! Hit and miss counts of one FrontCache.
+    struct FrontCacheStats
+    {
+        std::uint64_t hits{0};
+        std::uint64_t misses{0};
+
+        [[nodiscard]] double hit_rate() const noexcept
+        {
+            const auto total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+        }
+    };
+
+    //
+    // FrontCache: small direct-mapped cache owned by one thread, in front of a shared
+    // LazyEvaluator. A hit compares the key in the local slot and reads one rarely written
+    // counter of the evaluator, so repeated lookups on the same thread do not touch the shared
+    // table or its lock. Misses go to the evaluator and the result is remembered in the slot
+    // the key hashes to.
+    //
+    // Local copies are dropped whenever the evaluator erases, invalidates, refreshes or frees
+    // any entry, and an entry with a time to live is not served past its expiry.
+    //
+    // Not thread-safe: create one per thread, e.g. as a local of the worker function.
+    // The evaluator must outlive it.
+    //
+    template<typename Key,
+             typename Value,
+             typename Hash = std::hash<Key>,
+             typename KeyEqual = std::equal_to<Key>,
+             std::size_t Slots = 64>
+    class FrontCache
+    {
+        static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+
+    public:
+        using Evaluator = LazyEvaluator<Key, Value, Hash, KeyEqual>;
+
+        explicit FrontCache(Evaluator & shared) :
+            m_Shared(shared), m_Hash(shared.m_Cache.hash_function()), m_Equal(shared.m_Cache.key_eq())
+        {}
+
+        const Value & operator()(const Key & key)
+        {
+            return get(key);
+        }
+
+        //! Same result as the evaluator's get(); served locally when this thread saw it last.
+        const Value & get(const Key & key)
+        {
+            const auto hash = m_Hash(key);
+            auto & slot = m_Slots[hash & (Slots - 1)];
+            const auto generation = m_Shared.m_Generation.load(std::memory_order_acquire);
+
+            if(slot.value != nullptr && slot.hash == hash && slot.generation == generation
+               && m_Equal(*slot.key, key) && fresh(slot.expiry))
+            {
+                ++m_Stats.hits;
+                return *slot.value;
+            }
+
+            ++m_Stats.misses;
+            typename Evaluator::Tick expiry{};
+            const Value & value = m_Shared.getTracked(key, expiry);
+            slot.key = key;
+            slot.hash = hash;
+            slot.value = &value;
+            slot.generation = generation;
+            slot.expiry = expiry;
+            return value;
+        }
+
+        //! Forgets every local copy; the evaluator is not touched.
+        void clear() noexcept
+        {
+            for(auto & slot : m_Slots)
+            {
+                slot.value = nullptr;
+            }
+        }
+
+        [[nodiscard]] const FrontCacheStats & stats() const noexcept
+        {
+            return m_Stats;
+        }
+
+        void reset_stats() noexcept
+        {
+            m_Stats = {};
+        }
+
+    private:
+        struct Slot
+        {
+            std::optional<Key> key;
+            std::size_t hash{0};
+            const Value * value{nullptr};
+            std::uint64_t generation{0};
+            typename Evaluator::Tick expiry{Evaluator::neverExpires};
+        };
+
+        static bool fresh(typename Evaluator::Tick expiry)
+        {
+            return expiry == Evaluator::neverExpires
+                   || Evaluator::Clock::now().time_since_epoch().count() < expiry;
+        }
+
+        Evaluator & m_Shared;
+        Hash m_Hash;
+        KeyEqual m_Equal;
+        std::array<Slot, Slots> m_Slots{};
+        FrontCacheStats m_Stats;
+    };
+
+}   // namespace lbnl
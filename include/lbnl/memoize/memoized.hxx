@@ -0,0 +1,236 @@
+// memoize/memoized.hxx
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "lazy_evaluator.hxx"
+
+namespace lbnl
+{
+    namespace detail
+    {
+        //! Mixes value into seed (the boost::hash_combine recipe).
+        [[nodiscard]] constexpr std::size_t hashCombine(std::size_t seed, std::size_t value) noexcept
+        {
+            return seed ^ (value + static_cast<std::size_t>(0x9e3779b97f4a7c15ULL) + (seed << 6) + (seed >> 2));
+        }
+
+        template<typename T>
+        struct is_tuple : std::false_type
+        {};
+
+        template<typename... Ts>
+        struct is_tuple<std::tuple<Ts...>> : std::true_type
+        {};
+
+        template<typename... Ts>
+        struct type_list
+        {};
+
+        //! Decayed parameter types of a callable with a single, non-template call signature.
+        template<typename F>
+        struct callable_args : callable_args<decltype(&F::operator())>
+        {};
+
+        template<typename R, typename... Args>
+        struct callable_args<R (*)(Args...)>
+        {
+            using type = type_list<std::decay_t<Args>...>;
+        };
+
+        template<typename R, typename... Args>
+        struct callable_args<R (*)(Args...) noexcept> : callable_args<R (*)(Args...)>
+        {};
+
+        template<typename C, typename R, typename... Args>
+        struct callable_args<R (C::*)(Args...)> : callable_args<R (*)(Args...)>
+        {};
+
+        template<typename C, typename R, typename... Args>
+        struct callable_args<R (C::*)(Args...) const> : callable_args<R (*)(Args...)>
+        {};
+
+        template<typename C, typename R, typename... Args>
+        struct callable_args<R (C::*)(Args...) noexcept> : callable_args<R (*)(Args...)>
+        {};
+
+        template<typename C, typename R, typename... Args>
+        struct callable_args<R (C::*)(Args...) const noexcept> : callable_args<R (*)(Args...)>
+        {};
+
+        //! Default projection: all arguments, decayed, form the key.
+        struct ForwardAsTuple
+        {
+            template<typename... Args>
+            [[nodiscard]] auto operator()(const Args &... args) const
+            {
+                return std::tuple<Args...>(args...);
+            }
+        };
+    }   // namespace detail
+
+    //
+    // Hash for std::tuple keys: combines std::hash of every element.
+    //
+    struct TupleHash
+    {
+        template<typename... Ts>
+        [[nodiscard]] std::size_t operator()(const std::tuple<Ts...> & tuple) const
+        {
+            std::size_t seed = sizeof...(Ts);
+            std::apply(
+              [&seed](const auto &... elements) {
+                  ((seed = detail::hashCombine(seed, std::hash<std::decay_t<decltype(elements)>>{}(elements))),
+                   ...);
+              },
+              tuple);
+            return seed;
+        }
+    };
+
+    //
+    // Memoized: callable cache returned by memoize(). Copies share the same cache, so a
+    // returned reference stays valid while any copy is alive. Entries removed through cache()
+    // are only freed by LazyEvaluator::release_retired(), which CacheView does not expose.
+    //
+    template<typename Func, typename Projection, typename... Args>
+    class Memoized
+    {
+    public:
+        using Key = std::remove_cvref_t<std::invoke_result_t<const Projection &, const Args &...>>;
+        using Value = std::remove_cvref_t<std::invoke_result_t<Func &, const Args &...>>;
+        using Hash = std::conditional_t<detail::is_tuple<Key>::value, TupleHash, std::hash<Key>>;
+        using Cache = LazyEvaluator<Key, Value, Hash>;
+
+        Memoized(Func func, Projection projection) :
+            m_State(std::make_shared<State>(std::move(func), std::move(projection)))
+        {}
+
+        //! Returns the cached result for these arguments, calling the function on a miss.
+        const Value & operator()(const Args &... args) const
+        {
+            State & state = *m_State;
+            return state.cache.get_with(std::invoke(state.projection, args...),
+                                        [&state, &args...]() { return std::invoke(state.func, args...); });
+        }
+
+        //
+        // Maintenance view of the shared cache returned by cache(). Values are only computed
+        // through operator(), since a projected key may not carry the arguments needed to call
+        // the function, so the members that compute from a key alone are not offered.
+        //
+        class CacheView
+        {
+        public:
+            [[nodiscard]] const Value * try_get(const Key & key) const
+            {
+                return m_Cache->try_get(key);
+            }
+
+            template<typename F>
+                requires std::invocable<F &, const Key &, const Value &>
+            void for_each_computed(F && func) const
+            {
+                m_Cache->for_each_computed(std::forward<F>(func));
+            }
+
+            bool erase(const Key & key) const
+            {
+                return m_Cache->erase(key);
+            }
+
+            void clear() const
+            {
+                m_Cache->clear();
+            }
+
+            bool invalidate(const Key & key) const
+            {
+                return m_Cache->invalidate(key);
+            }
+
+            template<typename Predicate>
+                requires std::predicate<Predicate &, const Key &>
+            std::size_t invalidate_if(Predicate pred) const
+            {
+                return m_Cache->invalidate_if(std::move(pred));
+            }
+
+            void set_ttl(typename Cache::Clock::duration ttl) const
+            {
+                m_Cache->set_ttl(ttl);
+            }
+
+            void set_ttl(typename Cache::TtlPolicy policy) const
+            {
+                m_Cache->set_ttl(std::move(policy));
+            }
+
+        private:
+            friend class Memoized;
+
+            explicit CacheView(Cache & cache) noexcept : m_Cache(&cache)
+            {}
+
+            Cache * m_Cache;
+        };
+
+        //! The shared cache, for erase(), invalidate(), set_ttl() and lookups without computing.
+        [[nodiscard]] CacheView cache() const noexcept
+        {
+            return CacheView(m_State->cache);
+        }
+
+    private:
+        struct State
+        {
+            State(Func f, Projection p) : func(std::move(f)), projection(std::move(p))
+            {}
+
+            Func func;
+            Projection projection;
+            // Misses are always served through get_with, so no generator is needed.
+            Cache cache{nullptr};
+        };
+
+        std::shared_ptr<State> m_State;
+    };
+
+    namespace detail
+    {
+        template<typename Func, typename Projection, typename... Args>
+        [[nodiscard]] auto makeMemoized(Func func, Projection projection, type_list<Args...>)
+        {
+            return Memoized<Func, Projection, Args...>(std::move(func), std::move(projection));
+        }
+    }   // namespace detail
+
+    //! Wraps a function of any number of arguments in a thread-safe cache keyed on the tuple of
+    //! its decayed arguments:
+    //!   auto area = lbnl::memoize([](int zone, double height, std::string name) { ... });
+    //!   const double & a = area(3, 2.5, "north");
+    //! The function must have a single non-template call operator so its arguments can be deduced.
+    template<typename Func>
+    [[nodiscard]] auto memoize(Func func)
+    {
+        using Args = typename detail::callable_args<Func>::type;
+        return detail::makeMemoized(std::move(func), detail::ForwardAsTuple{}, Args{});
+    }
+
+    //! As above, but projection(args...) builds the key, so arguments that do not affect the
+    //! result can be left out. The result for the first call with a given key is reused for every
+    //! later call that projects to the same key.
+    template<typename Func, typename Projection>
+    [[nodiscard]] auto memoize(Func func, Projection projection)
+    {
+        using Args = typename detail::callable_args<Func>::type;
+        return detail::makeMemoized(std::move(func), std::move(projection), Args{});
+    }
+
+}   // namespace lbnl
@@ -1,6 +1,7 @@
 // optional.hxx
 #pragma once
 #include <compare>
+#include <memory>
 #include <optional>
 #include <variant>
 #include <type_traits>
@@ -59,17 +60,23 @@ namespace lbnl
         }
 
         //! Access the contained value (undefined behavior if empty)
-        [[nodiscard]] constexpr const T & operator*() const noexcept
+        [[nodiscard]] constexpr const T & operator*() const & noexcept
         {
             return *m_opt;
         }
 
         //! Access the contained value (undefined behavior if empty)
-        [[nodiscard]] constexpr T & operator*() noexcept
+        [[nodiscard]] constexpr T & operator*() & noexcept
         {
             return *m_opt;
         }
 
+        //! Move the contained value out of an expiring OptionalExt (undefined behavior if empty)
+        [[nodiscard]] constexpr T && operator*() && noexcept
+        {
+            return std::move(*m_opt);
+        }
+
         //! Access member of the contained value (undefined behavior if empty)
         [[nodiscard]] constexpr const T * operator->() const noexcept
         {
@@ -82,6 +89,12 @@ namespace lbnl
             return m_opt.operator->();
         }
 
+        //
+        // Monadic operations. The const & overloads pass the value to func as const T & and copy
+        // it where it is carried over; the && overloads (temporaries, std::move) pass T && and
+        // move it, so a chain on a temporary does not copy the payload.
+        //
+
         //! Applies a function if this optional contains a value.
         //! The function may return:
         //! - a plain value,
@@ -89,26 +102,15 @@ namespace lbnl
         //! - an OptionalExt,
         //! - or void.
         template<typename Func>
-        constexpr auto and_then(Func && func) const
+        constexpr auto and_then(Func && func) const &
         {
-            using Raw = std::invoke_result_t<Func, const T &>;
-            using RR = std::remove_cvref_t<Raw>;
-
-            if(!m_opt)
-            {
-                return detail::to_ext_empty<RR>();
-            }
+            return andThen(*this, std::forward<Func>(func));
+        }
 
-            if constexpr(std::is_void_v<RR>)
-            {
-                std::invoke(std::forward<Func>(func), *m_opt);
-                return OptionalExt<std::monostate>(std::monostate{});
-            }
-            else
-            {
-                auto r = std::invoke(std::forward<Func>(func), *m_opt);
-                return detail::to_ext_from(std::move(r));
-            }
+        template<typename Func>
+        constexpr auto and_then(Func && func) &&
+        {
+            return andThen(std::move(*this), std::forward<Func>(func));
         }
 
         //! Returns current value if present, otherwise calls fallback function.
@@ -116,65 +118,67 @@ namespace lbnl
         //! For void fallbacks: executes side effect and returns OptionalExt<std::monostate>.
         //! For value fallbacks: the function must return T or something convertible to T.
         template<typename Func>
-        constexpr auto or_else(Func && func) const
+        constexpr auto or_else(Func && func) const &
         {
-            using Result = std::invoke_result_t<Func>;
+            return orElse(*this, std::forward<Func>(func));
+        }
 
-            if constexpr(std::is_void_v<Result>)
-            {
-                if(!m_opt)
-                {
-                    std::invoke(std::forward<Func>(func));
-                }
-                return OptionalExt<std::monostate>(std::monostate{});
-            }
-            else
-            {
-                if(m_opt)
-                {
-                    return *this;
-                }
-                else
-                {
-                    return OptionalExt<T>(std::invoke(std::forward<Func>(func)));
-                }
-            }
+        template<typename Func>
+        constexpr auto or_else(Func && func) &&
+        {
+            return orElse(std::move(*this), std::forward<Func>(func));
         }
 
         //! Returns the contained value if present, or a fallback value otherwise.
         template<typename U>
-        [[nodiscard]] constexpr T value_or(U && fallback) const
+        [[nodiscard]] constexpr T value_or(U && fallback) const &
         {
             return m_opt.value_or(std::forward<U>(fallback));
         }
 
+        template<typename U>
+        [[nodiscard]] constexpr T value_or(U && fallback) &&
+        {
+            return std::move(m_opt).value_or(std::forward<U>(fallback));
+        }
+
         template<typename Func>
-        constexpr auto map(Func && func) const
+        constexpr auto map(Func && func) const &
         {
-            using U = std::invoke_result_t<Func, const T &>;
-            if(m_opt)
-            {
-                return OptionalExt<U>(std::invoke(std::forward<Func>(func), *m_opt));
-            }
-            else
-            {
-                return OptionalExt<U>(std::nullopt);
-            }
+            return mapValue(*this, std::forward<Func>(func));
+        }
+
+        template<typename Func>
+        constexpr auto map(Func && func) &&
+        {
+            return mapValue(std::move(*this), std::forward<Func>(func));
         }
 
         // C++23-like synonym for map
         template<typename Func>
-        constexpr auto transform(Func && func) const
+        constexpr auto transform(Func && func) const &
         {
             return map(std::forward<Func>(func));
         }
 
+        template<typename Func>
+        constexpr auto transform(Func && func) &&
+        {
+            return std::move(*this).map(std::forward<Func>(func));
+        }
+
         //! Access the underlying std::optional<T>
-        [[nodiscard]] constexpr const std::optional<T> & raw() const noexcept
+        [[nodiscard]] constexpr const std::optional<T> & raw() const & noexcept
         {
             return m_opt;
         }
 
+        //! Take the underlying std::optional<T> out of an expiring OptionalExt
+        [[nodiscard]] constexpr std::optional<T> raw() &&
+        {
+            return std::move(m_opt);
+        }
+
         //
         // Comparisons, mirroring std::optional. Hidden friends found by ADL.
         // C++20 synthesizes operator!=, the reversed forms (nullopt == opt,
@@ -229,9 +233,235 @@ namespace lbnl
         }
 
     private:
+        // Shared bodies of the const & and && overloads. Self is const OptionalExt & or
+        // OptionalExt, and forwardValue(std::forward<Self>(self)) is const T & or T && to match.
+        template<typename Self>
+        static constexpr decltype(auto) forwardValue(Self && self)
+        {
+            return *std::forward<Self>(self).m_opt;
+        }
+
+        template<typename Self, typename Func>
+        static constexpr auto andThen(Self && self, Func && func)
+        {
+            using Raw = std::invoke_result_t<Func, decltype(forwardValue(std::forward<Self>(self)))>;
+            using RR = std::remove_cvref_t<Raw>;
+
+            if(!self.m_opt)
+            {
+                return detail::to_ext_empty<RR>();
+            }
+
+            if constexpr(std::is_void_v<RR>)
+            {
+                std::invoke(std::forward<Func>(func), forwardValue(std::forward<Self>(self)));
+                return OptionalExt<std::monostate>(std::monostate{});
+            }
+            else
+            {
+                return detail::to_ext_from(
+                  std::invoke(std::forward<Func>(func), forwardValue(std::forward<Self>(self))));
+            }
+        }
+
+        template<typename Self, typename Func>
+        static constexpr auto orElse(Self && self, Func && func)
+        {
+            using Result = std::invoke_result_t<Func>;
+
+            if constexpr(std::is_void_v<Result>)
+            {
+                if(!self.m_opt)
+                {
+                    std::invoke(std::forward<Func>(func));
+                }
+                return OptionalExt<std::monostate>(std::monostate{});
+            }
+            else
+            {
+                if(self.m_opt)
+                {
+                    return OptionalExt<T>(std::forward<Self>(self));
+                }
+                return OptionalExt<T>(std::invoke(std::forward<Func>(func)));
+            }
+        }
+
+        template<typename Self, typename Func>
+        static constexpr auto mapValue(Self && self, Func && func)
+        {
+            using U = std::remove_cvref_t<std::invoke_result_t<Func, decltype(forwardValue(std::forward<Self>(self)))>>;
+            if(self.m_opt)
+            {
+                return OptionalExt<U>(
+                  std::invoke(std::forward<Func>(func), forwardValue(std::forward<Self>(self))));
+            }
+            return OptionalExt<U>(std::nullopt);
+        }
+
         std::optional<T> m_opt;
     };
 
+    //
+    // OptionalExt<T &>: an optional reference. It holds a pointer to an object owned elsewhere,
+    // so wrapping and chaining never copy that object. The object must outlive the OptionalExt.
+    // Build one from a reference, a pointer (null means empty) or with extend_ref().
+    //
+    template<typename T>
+    class OptionalExt<T &>
+    {
+    public:
+        using value_type = T &;
+
+        explicit constexpr OptionalExt(std::nullopt_t) noexcept
+        {}
+
+        explicit constexpr OptionalExt(T & ref) noexcept : m_ptr(std::addressof(ref))
+        {}
+
+        explicit constexpr OptionalExt(T * ptr) noexcept : m_ptr(ptr)
+        {}
+
+        // No binding to temporaries
+        OptionalExt(T &&) = delete;
+
+        //! Converts e.g. OptionalExt<X &> to OptionalExt<const X &>
+        template<typename U>
+            requires(!std::is_same_v<U, T>) && std::is_convertible_v<U *, T *>
+        constexpr OptionalExt(const OptionalExt<U &> & other) noexcept : m_ptr(other.raw())
+        {}
+
+        [[nodiscard]] constexpr bool has_value() const noexcept
+        {
+            return m_ptr != nullptr;
+        }
+
+        [[nodiscard]] constexpr explicit operator bool() const noexcept
+        {
+            return has_value();
+        }
+
+        //! Access the referenced object (undefined behavior if empty)
+        [[nodiscard]] constexpr T & operator*() const noexcept
+        {
+            return *m_ptr;
+        }
+
+        [[nodiscard]] constexpr T * operator->() const noexcept
+        {
+            return m_ptr;
+        }
+
+        //! Applies func to the referenced object if there is one. The function may return a plain
+        //! value, a std::optional, an OptionalExt (including another OptionalExt<U &>) or void.
+        template<typename Func>
+        constexpr auto and_then(Func && func) const
+        {
+            using RR = std::remove_cvref_t<std::invoke_result_t<Func, T &>>;
+
+            if(!m_ptr)
+            {
+                return detail::to_ext_empty<RR>();
+            }
+
+            if constexpr(std::is_void_v<RR>)
+            {
+                std::invoke(std::forward<Func>(func), *m_ptr);
+                return OptionalExt<std::monostate>(std::monostate{});
+            }
+            else
+            {
+                return detail::to_ext_from(std::invoke(std::forward<Func>(func), *m_ptr));
+            }
+        }
+
+        //! Returns this reference if present, otherwise calls the fallback. A void fallback is run
+        //! for its side effect and gives OptionalExt<std::monostate>; otherwise it must return an
+        //! lvalue T & (or an OptionalExt<T &>) referring to an object that outlives the result.
+        template<typename Func>
+        constexpr auto or_else(Func && func) const
+        {
+            using Result = std::invoke_result_t<Func>;
+
+            if constexpr(std::is_void_v<Result>)
+            {
+                if(!m_ptr)
+                {
+                    std::invoke(std::forward<Func>(func));
+                }
+                return OptionalExt<std::monostate>(std::monostate{});
+            }
+            else if constexpr(is_optional_ext<std::remove_cvref_t<Result>>::value)
+            {
+                return m_ptr ? *this : OptionalExt(std::invoke(std::forward<Func>(func)));
+            }
+            else
+            {
+                static_assert(std::is_lvalue_reference_v<Result>,
+                              "or_else on OptionalExt<T &> needs a fallback returning T & or void");
+                return m_ptr ? *this : OptionalExt(std::invoke(std::forward<Func>(func)));
+            }
+        }
+
+        //! Copy of the referenced object, or the fallback
+        template<typename U>
+        [[nodiscard]] constexpr std::remove_cv_t<T> value_or(U && fallback) const
+        {
+            return m_ptr ? *m_ptr : static_cast<std::remove_cv_t<T>>(std::forward<U>(fallback));
+        }
+
+        template<typename Func>
+        constexpr auto map(Func && func) const
+        {
+            using U = std::remove_cvref_t<std::invoke_result_t<Func, T &>>;
+            if(m_ptr)
+            {
+                return OptionalExt<U>(std::invoke(std::forward<Func>(func), *m_ptr));
+            }
+            return OptionalExt<U>(std::nullopt);
+        }
+
+        // C++23-like synonym for map
+        template<typename Func>
+        constexpr auto transform(Func && func) const
+        {
+            return map(std::forward<Func>(func));
+        }
+
+        //! Pointer to the referenced object, or nullptr
+        [[nodiscard]] constexpr T * raw() const noexcept
+        {
+            return m_ptr;
+        }
+
+        //
+        // Comparisons compare the referenced objects, not their addresses.
+        //
+        [[nodiscard]] friend constexpr bool operator==(const OptionalExt & lhs, const OptionalExt & rhs)
+            requires std::equality_comparable<T>
+        {
+            if(lhs.has_value() != rhs.has_value())
+            {
+                return false;
+            }
+            return !lhs.has_value() || (*lhs == *rhs);
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const OptionalExt & lhs, std::nullopt_t) noexcept
+        {
+            return !lhs.has_value();
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const OptionalExt & lhs, const std::remove_cv_t<T> & val)
+            requires std::equality_comparable<T>
+        {
+            return lhs.has_value() && (*lhs == val);
+        }
+
+    private:
+        T * m_ptr{nullptr};
+    };
+
     // Trait to detect lbnl::OptionalExt<T>
     template<typename T>
     struct is_optional_ext : std::false_type
@@ -298,6 +528,36 @@ namespace lbnl
         return OptionalExt<T>(opt);
     }
 
+    // Rvalue overload: moves the value instead of copying it.
+    template<typename T>
+    [[nodiscard]] constexpr auto extend(std::optional<T> && opt)
+    {
+        return OptionalExt<T>(std::move(opt));
+    }
+
+    // Reference adapters: wrap the contained value of a std::optional, or a pointer (null means
+    // empty), as OptionalExt<T &> without copying it.
+    template<typename T>
+    [[nodiscard]] constexpr auto extend_ref(std::optional<T> & opt) noexcept
+    {
+        return OptionalExt<T &>(opt ? std::addressof(*opt) : nullptr);
+    }
+
+    template<typename T>
+    [[nodiscard]] constexpr auto extend_ref(const std::optional<T> & opt) noexcept
+    {
+        return OptionalExt<const T &>(opt ? std::addressof(*opt) : nullptr);
+    }
+
+    template<typename T>
+    void extend_ref(const std::optional<T> &&) = delete;
+
+    template<typename T>
+    [[nodiscard]] constexpr auto extend_ref(T * ptr) noexcept
+    {
+        return OptionalExt<T &>(ptr);
+    }
+
     // Variant helper
     template<typename T, typename Variant>
     constexpr bool is_in_variant_v = false;
@@ -0,0 +1,664 @@
+// optional_column.hxx
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "optional_utils.hxx"
+
+namespace lbnl
+{
+    //
+    // OptionalColumn<T>: a nullable column in Arrow layout. The values live in one contiguous
+    // buffer and whether each one is present lives in a packed validity bitmap (bit i of word
+    // i / 64, least significant bit first). Null slots hold T{}.
+    //
+    // Compared with std::vector<std::optional<T>> there is no per-element flag and padding, so
+    // a column of doubles takes 8 bytes plus one bit per element. The bulk operations work a
+    // bitmap word at a time: all-valid words run a tight loop over the values that the compiler
+    // vectorizes, all-null words are skipped, and only mixed words look at single bits.
+    //
+    // Elements are read through proxy references with has_value(), operator* and value_or(),
+    // so a column is also a random-access range accepted by average_optional and
+    // optional_stats.
+    //
+    template<typename T>
+        requires std::default_initializable<T> && std::copyable<T>
+    class OptionalColumn
+    {
+        // values() hands out a span over the value buffer, which std::vector<bool> cannot provide
+        static_assert(!std::same_as<T, bool>,
+                      "OptionalColumn<bool> is not supported; use OptionalColumn<std::uint8_t>");
+
+        static constexpr std::size_t bitsPerWord = 64;
+
+    public:
+        using value_type = std::optional<T>;
+        using size_type = std::size_t;
+
+        //! Read-only view of one slot
+        class const_reference
+        {
+        public:
+            [[nodiscard]] bool has_value() const noexcept
+            {
+                return m_column->has_value(m_index);
+            }
+
+            [[nodiscard]] explicit operator bool() const noexcept
+            {
+                return has_value();
+            }
+
+            //! Undefined behavior if the slot is null (it reads the placeholder T{})
+            [[nodiscard]] const T & operator*() const noexcept
+            {
+                return m_column->m_values[m_index];
+            }
+
+            [[nodiscard]] const T * operator->() const noexcept
+            {
+                return std::addressof(m_column->m_values[m_index]);
+            }
+
+            //! Throws std::bad_optional_access if the slot is null
+            [[nodiscard]] const T & value() const
+            {
+                if(!has_value())
+                {
+                    throw std::bad_optional_access();
+                }
+                return **this;
+            }
+
+            template<typename U>
+            [[nodiscard]] T value_or(U && fallback) const
+            {
+                return has_value() ? **this : static_cast<T>(std::forward<U>(fallback));
+            }
+
+            operator std::optional<T>() const
+            {
+                return has_value() ? std::optional<T>(**this) : std::nullopt;
+            }
+
+            [[nodiscard]] friend bool operator==(const const_reference & lhs,
+                                                 std::nullopt_t) noexcept
+            {
+                return !lhs.has_value();
+            }
+
+            [[nodiscard]] friend bool operator==(const const_reference & lhs, const T & value)
+            {
+                return lhs.has_value() && *lhs == value;
+            }
+
+        private:
+            friend class OptionalColumn;
+
+            const_reference(const OptionalColumn * column, std::size_t index) noexcept :
+                m_column(column),
+                m_index(index)
+            {}
+
+            const OptionalColumn * m_column;
+            std::size_t m_index;
+        };
+
+        //! Writable view of one slot: assign a T to set it, std::nullopt to clear it
+        class reference : public const_reference
+        {
+        public:
+            reference & operator=(const T & value)
+            {
+                column().set(this->m_index, value);
+                return *this;
+            }
+
+            reference & operator=(std::nullopt_t)
+            {
+                column().reset(this->m_index);
+                return *this;
+            }
+
+            reference & operator=(const std::optional<T> & value)
+            {
+                return value ? (*this = *value) : (*this = std::nullopt);
+            }
+
+            // Assigning one slot to another copies the slot's contents, not the proxy
+            reference & operator=(const const_reference & other)
+            {
+                return *this = static_cast<std::optional<T>>(other);
+            }
+
+            reference & operator=(const reference & other)
+            {
+                return *this = static_cast<const const_reference &>(other);
+            }
+
+        private:
+            friend class OptionalColumn;
+
+            reference(OptionalColumn * column, std::size_t index) noexcept :
+                const_reference(column, index)
+            {}
+
+            [[nodiscard]] OptionalColumn & column() const noexcept
+            {
+                return const_cast<OptionalColumn &>(*this->m_column);
+            }
+        };
+
+        class const_iterator
+        {
+        public:
+            using iterator_concept = std::random_access_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::optional<T>;
+            using difference_type = std::ptrdiff_t;
+            using reference = const_reference;
+
+            const_iterator() = default;
+
+            [[nodiscard]] const_reference operator*() const noexcept
+            {
+                return {m_column, m_index};
+            }
+
+            [[nodiscard]] const_reference operator[](difference_type offset) const noexcept
+            {
+                return *(*this + offset);
+            }
+
+            const_iterator & operator++() noexcept
+            {
+                ++m_index;
+                return *this;
+            }
+
+            const_iterator operator++(int) noexcept
+            {
+                auto copy = *this;
+                ++m_index;
+                return copy;
+            }
+
+            const_iterator & operator--() noexcept
+            {
+                --m_index;
+                return *this;
+            }
+
+            const_iterator operator--(int) noexcept
+            {
+                auto copy = *this;
+                --m_index;
+                return copy;
+            }
+
+            const_iterator & operator+=(difference_type offset) noexcept
+            {
+                m_index = static_cast<std::size_t>(static_cast<difference_type>(m_index) + offset);
+                return *this;
+            }
+
+            const_iterator & operator-=(difference_type offset) noexcept
+            {
+                return *this += -offset;
+            }
+
+            [[nodiscard]] friend const_iterator operator+(const_iterator iter,
+                                                          difference_type offset) noexcept
+            {
+                return iter += offset;
+            }
+
+            [[nodiscard]] friend const_iterator operator+(difference_type offset,
+                                                          const_iterator iter) noexcept
+            {
+                return iter += offset;
+            }
+
+            [[nodiscard]] friend const_iterator operator-(const_iterator iter,
+                                                          difference_type offset) noexcept
+            {
+                return iter -= offset;
+            }
+
+            [[nodiscard]] friend difference_type operator-(const const_iterator & lhs,
+                                                           const const_iterator & rhs) noexcept
+            {
+                return static_cast<difference_type>(lhs.m_index)
+                       - static_cast<difference_type>(rhs.m_index);
+            }
+
+            [[nodiscard]] friend bool operator==(const const_iterator & lhs,
+                                                 const const_iterator & rhs) noexcept
+            {
+                return lhs.m_index == rhs.m_index;
+            }
+
+            [[nodiscard]] friend auto operator<=>(const const_iterator & lhs,
+                                                  const const_iterator & rhs) noexcept
+            {
+                return lhs.m_index <=> rhs.m_index;
+            }
+
+        private:
+            friend class OptionalColumn;
+
+            const_iterator(const OptionalColumn * column, std::size_t index) noexcept :
+                m_column(column),
+                m_index(index)
+            {}
+
+            const OptionalColumn * m_column{nullptr};
+            std::size_t m_index{0};
+        };
+
+        using iterator = const_iterator;
+
+        OptionalColumn() = default;
+
+        //! size null slots
+        explicit OptionalColumn(std::size_t size) :
+            m_values(size),
+            m_validity(wordCount(size)),
+            m_size(size)
+        {}
+
+        //! size slots all holding value
+        OptionalColumn(std::size_t size, const T & value) :
+            m_values(size, value),
+            m_validity(wordCount(size), ~std::uint64_t{0}),
+            m_size(size)
+        {
+            clearTail();
+        }
+
+        OptionalColumn(std::initializer_list<std::optional<T>> values)
+        {
+            assign(values);
+        }
+
+        explicit OptionalColumn(const std::vector<std::optional<T>> & values)
+        {
+            assign(values);
+        }
+
+        //! Builds a column from values and a validity bitmap in the layout described above.
+        //! Values in null slots are replaced by T{}.
+        OptionalColumn(std::vector<T> values, std::vector<std::uint64_t> validity) :
+            m_values(std::move(values)),
+            m_validity(std::move(validity)),
+            m_size(m_values.size())
+        {
+            m_validity.resize(wordCount(m_size));
+            clearTail();
+            resetNullSlots();
+        }
+
+        [[nodiscard]] std::vector<std::optional<T>> to_optionals() const
+        {
+            std::vector<std::optional<T>> result(m_size);
+            forEachValid([&](std::size_t index) { result[index].emplace(m_values[index]); });
+            return result;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        void reserve(std::size_t capacity)
+        {
+            m_values.reserve(capacity);
+            m_validity.reserve(wordCount(capacity));
+        }
+
+        void clear() noexcept
+        {
+            m_values.clear();
+            m_validity.clear();
+            m_size = 0;
+        }
+
+        void push_back(const T & value)
+        {
+            m_values.push_back(value);
+            growBitmap();
+            setBit(m_size - 1);
+        }
+
+        void push_back(std::nullopt_t)
+        {
+            m_values.emplace_back();
+            growBitmap();
+        }
+
+        void push_back(const std::optional<T> & value)
+        {
+            value ? push_back(*value) : push_back(std::nullopt);
+        }
+
+        [[nodiscard]] bool has_value(std::size_t index) const noexcept
+        {
+            return ((m_validity[index / bitsPerWord] >> (index % bitsPerWord)) & 1u) != 0;
+        }
+
+        void set(std::size_t index, const T & value)
+        {
+            m_values[index] = value;
+            setBit(index);
+        }
+
+        //! Nulls the slot and puts T{} back in its place
+        void reset(std::size_t index)
+        {
+            m_values[index] = T{};
+            m_validity[index / bitsPerWord] &= ~(std::uint64_t{1} << (index % bitsPerWord));
+        }
+
+        [[nodiscard]] const_reference operator[](std::size_t index) const noexcept
+        {
+            return {this, index};
+        }
+
+        [[nodiscard]] reference operator[](std::size_t index) noexcept
+        {
+            return {this, index};
+        }
+
+        [[nodiscard]] const_iterator begin() const noexcept
+        {
+            return {this, 0};
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept
+        {
+            return {this, m_size};
+        }
+
+        //! Zero-copy access to the value buffer. Null slots hold T{}.
+        [[nodiscard]] std::span<const T> values() const noexcept
+        {
+            return m_values;
+        }
+
+        //! Mutable value buffer. Writing to it does not change which slots are valid.
+        [[nodiscard]] std::span<T> values() noexcept
+        {
+            return m_values;
+        }
+
+        //! The validity bitmap, one bit per slot; bits past size() are zero
+        [[nodiscard]] std::span<const std::uint64_t> validity() const noexcept
+        {
+            return m_validity;
+        }
+
+        [[nodiscard]] std::size_t count_valid() const noexcept
+        {
+            std::size_t count = 0;
+            for(const auto word : m_validity)
+            {
+                count += static_cast<std::size_t>(std::popcount(word));
+            }
+            return count;
+        }
+
+        //! Applies func to every valid value. The result has the same validity bitmap.
+        template<typename Func>
+        [[nodiscard]] auto map(Func && func) const
+        {
+            using U = std::remove_cvref_t<std::invoke_result_t<Func &, const T &>>;
+            std::vector<U> values(m_size);
+            forEachValid(
+              [&](std::size_t index) { values[index] = std::invoke(func, m_values[index]); });
+            return OptionalColumn<U>(std::move(values), m_validity);
+        }
+
+        // C++23-like synonym for map
+        template<typename Func>
+        [[nodiscard]] auto transform(Func && func) const
+        {
+            return map(std::forward<Func>(func));
+        }
+
+        //! func returns an optional (std::optional, OptionalExt, CompactOptional...): a slot is
+        //! valid in the result if it was valid here and func returned a value for it.
+        template<typename Func>
+            requires OptionalLike<std::remove_cvref_t<std::invoke_result_t<Func &, const T &>>>
+        [[nodiscard]] auto and_then(Func && func) const
+        {
+            using Result = std::remove_cvref_t<std::invoke_result_t<Func &, const T &>>;
+            using U = std::remove_cvref_t<decltype(*std::declval<const Result &>())>;
+            OptionalColumn<U> result(m_size);
+            forEachValid([&](std::size_t index) {
+                const Result value = std::invoke(func, m_values[index]);
+                if(value.has_value())
+                {
+                    result.set(index, *value);
+                }
+            });
+            return result;
+        }
+
+        //! Fills every null slot with fallback(), giving a column without nulls.
+        template<typename Func>
+        [[nodiscard]] OptionalColumn or_else(Func && fallback) const
+        {
+            OptionalColumn result(*this);
+            for(std::size_t word = 0; word < m_validity.size(); ++word)
+            {
+                auto missing = ~m_validity[word] & tailMask(word);
+                while(missing != 0)
+                {
+                    result.set(lowestSlot(word, missing), static_cast<T>(std::invoke(fallback)));
+                    missing &= missing - 1;
+                }
+            }
+            return result;
+        }
+
+        //! Nulls out the valid values for which pred is false. Positions are kept.
+        template<typename Pred>
+        [[nodiscard]] OptionalColumn filter(Pred && pred) const
+        {
+            OptionalColumn result(*this);
+            for(std::size_t word = 0; word < m_validity.size(); ++word)
+            {
+                const auto bits = m_validity[word];
+                if(bits == 0)
+                {
+                    continue;
+                }
+                const auto base = word * bitsPerWord;
+                const auto count = (std::min)(bitsPerWord, m_size - base);
+                std::uint64_t keep = 0;
+                for(std::size_t bit = 0; bit < count; ++bit)
+                {
+                    keep |= std::uint64_t{std::invoke(pred, m_values[base + bit]) ? 1u : 0u} << bit;
+                }
+                result.m_validity[word] = bits & keep;
+                for(auto dropped = bits & ~keep; dropped != 0; dropped &= dropped - 1)
+                {
+                    result.m_values[lowestSlot(word, dropped)] = T{};
+                }
+            }
+            return result;
+        }
+
+        //! The values with every null slot replaced by fallback
+        template<typename U>
+        [[nodiscard]] std::vector<T> value_or(U && fallback) const
+        {
+            const T replacement = static_cast<T>(std::forward<U>(fallback));
+            std::vector<T> result(m_values);
+            for(std::size_t word = 0; word < m_validity.size(); ++word)
+            {
+                auto missing = ~m_validity[word] & tailMask(word);
+                for(; missing != 0; missing &= missing - 1)
+                {
+                    result[lowestSlot(word, missing)] = replacement;
+                }
+            }
+            return result;
+        }
+
+        //! Average of the valid values, with the block kernel and summation modes of
+        //! average_optional. Nulls are masked with a branchless select on their validity bit.
+        [[nodiscard]] std::optional<T> average(Summation summation = Summation::Pairwise) const
+            requires std::is_arithmetic_v<T>
+        {
+            detail::OptionalBlock<T> block{};
+            detail::SumAccumulator<T> sum(summation);
+            static_assert(detail::optional_block % bitsPerWord == 0);
+            constexpr std::size_t wordsPerBlock = detail::optional_block / bitsPerWord;
+
+            for(std::size_t first = 0; first < m_validity.size(); first += wordsPerBlock)
+            {
+                block.fill(T{});
+                const auto last = (std::min)(first + wordsPerBlock, m_validity.size());
+                for(std::size_t word = first; word < last; ++word)
+                {
+                    const auto bits = m_validity[word];
+                    const auto base = word * bitsPerWord;
+                    const auto count = (std::min)(bitsPerWord, m_size - base);
+                    T * out = block.data() + (base - first * bitsPerWord);
+                    for(std::size_t bit = 0; bit < count; ++bit)
+                    {
+                        out[bit] = ((bits >> bit) & 1u) != 0 ? m_values[base + bit] : T{};
+                    }
+                }
+                sum.add_block(block);
+            }
+            return detail::average_of(detail::PartialSum<T>{sum.total(), count_valid()});
+        }
+
+        [[nodiscard]] friend bool operator==(const OptionalColumn & lhs, const OptionalColumn & rhs)
+        {
+            if(lhs.m_validity != rhs.m_validity || lhs.m_size != rhs.m_size)
+            {
+                return false;
+            }
+            bool equal = true;
+            lhs.forEachValid([&](std::size_t index) {
+                equal = equal && lhs.m_values[index] == rhs.m_values[index];
+            });
+            return equal;
+        }
+
+    private:
+        template<typename U>
+            requires std::default_initializable<U> && std::copyable<U>
+        friend class OptionalColumn;
+
+        [[nodiscard]] static constexpr std::size_t wordCount(std::size_t size) noexcept
+        {
+            return (size + bitsPerWord - 1) / bitsPerWord;
+        }
+
+        // Slot of the lowest set bit in bits, which is bitmap word number word
+        [[nodiscard]] static std::size_t lowestSlot(std::size_t word, std::uint64_t bits) noexcept
+        {
+            return word * bitsPerWord + static_cast<std::size_t>(std::countr_zero(bits));
+        }
+
+        // Mask of the bits of word that correspond to slots (all ones except in the last word)
+        [[nodiscard]] std::uint64_t tailMask(std::size_t word) const noexcept
+        {
+            const auto used = m_size - word * bitsPerWord;
+            return used >= bitsPerWord ? ~std::uint64_t{0} : (std::uint64_t{1} << used) - 1;
+        }
+
+        void clearTail() noexcept
+        {
+            if(!m_validity.empty())
+            {
+                m_validity.back() &= tailMask(m_validity.size() - 1);
+            }
+        }
+
+        void resetNullSlots()
+        {
+            for(std::size_t word = 0; word < m_validity.size(); ++word)
+            {
+                for(auto nulls = ~m_validity[word] & tailMask(word); nulls != 0; nulls &= nulls - 1)
+                {
+                    m_values[lowestSlot(word, nulls)] = T{};
+                }
+            }
+        }
+
+        void growBitmap()
+        {
+            if(m_size % bitsPerWord == 0)
+            {
+                m_validity.push_back(0);
+            }
+            ++m_size;
+        }
+
+        void setBit(std::size_t index) noexcept
+        {
+            m_validity[index / bitsPerWord] |= std::uint64_t{1} << (index % bitsPerWord);
+        }
+
+        template<typename Range>
+        void assign(const Range & values)
+        {
+            reserve(std::size(values));
+            for(const auto & value : values)
+            {
+                push_back(value);
+            }
+        }
+
+        // Calls func(index) for every valid slot. Full words run without per-bit tests.
+        template<typename Func>
+        void forEachValid(Func && func) const
+        {
+            for(std::size_t word = 0; word < m_validity.size(); ++word)
+            {
+                const auto base = word * bitsPerWord;
+                auto bits = m_validity[word];
+                if(bits == ~std::uint64_t{0})
+                {
+                    for(std::size_t bit = 0; bit < bitsPerWord; ++bit)
+                    {
+                        func(base + bit);
+                    }
+                    continue;
+                }
+                for(; bits != 0; bits &= bits - 1)
+                {
+                    func(lowestSlot(word, bits));
+                }
+            }
+        }
+
+        std::vector<T> m_values;
+        std::vector<std::uint64_t> m_validity;
+        std::size_t m_size{0};
+    };
+
+}   // namespace lbnl
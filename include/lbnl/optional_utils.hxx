@@ -1,42 +1,533 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <optional>
+#include <ranges>
+#include <type_traits>
 #include <vector>
 
+#include "detail/parallel_for.hxx"
+
 namespace lbnl
 {
+    // How average_optional adds up floating point values
+    enum class Summation
+    {
+        Simple,    // independent running sums; fastest, error grows with n
+        Kahan,     // compensated running sums; error does not grow with n
+        Pairwise   // blocks combined in a binary tree; error grows with log n
+    };
+
+    //! Anything with has_value() and operator*: std::optional, OptionalExt, CompactOptional, or
+    //! a proxy reference into bitmap-backed storage.
+    template<typename O>
+    concept OptionalLike = requires(const O & opt) {
+        { opt.has_value() } -> std::convertible_to<bool>;
+        *opt;
+    };
+
+    //! Result of optional_stats over the present values of a range
+    template<typename T>
+    struct OptionalStats
+    {
+        std::size_t count{0};
+        T sum{};
+        T mean{};
+        T min{};
+        T max{};
+        T variance{};   // population variance: mean squared deviation from mean
+    };
+
+    namespace detail
+    {
+        template<typename R>
+        using optional_element_t = std::remove_cvref_t<std::ranges::range_reference_t<R>>;
+
+        template<typename R>
+        using optional_value_t =
+          std::remove_cvref_t<decltype(*std::declval<const optional_element_t<R> &>())>;
+
+        template<typename R>
+        concept OptionalRange = std::ranges::input_range<R> && OptionalLike<optional_element_t<R>>;
+
+        // Elements are gathered into fixed-size blocks (empty entries as zero plus a presence
+        // byte) and every block is reduced over optional_lanes independent accumulators. The
+        // inner loops have no branches and a constant trip count, so the compiler turns them
+        // into SIMD code without -ffast-math.
+        inline constexpr std::size_t optional_lanes = 8;
+        inline constexpr std::size_t optional_block = 256;
+
+        template<typename T>
+        using OptionalBlock = std::array<T, optional_block>;
+        using PresenceBlock = std::array<unsigned char, optional_block>;
+
+        template<typename T, typename Iter, typename Sent>
+        constexpr void gather_block(Iter & iter,
+                                    const Sent & last,
+                                    OptionalBlock<T> & values,
+                                    PresenceBlock & present)
+        {
+            std::size_t n = 0;
+            for(; n < optional_block && iter != last; ++n, ++iter)
+            {
+                const auto & element = *iter;
+                const bool has = element.has_value();
+                present[n] = has ? 1 : 0;
+                values[n] = has ? static_cast<T>(*element) : T{};
+            }
+            for(; n < optional_block; ++n)
+            {
+                present[n] = 0;
+                values[n] = T{};
+            }
+        }
+
+        [[nodiscard]] constexpr std::size_t count_present(const PresenceBlock & present)
+        {
+            std::size_t count = 0;
+            for(const auto flag : present)
+            {
+                count += flag;
+            }
+            return count;
+        }
+
+        template<typename T>
+        [[nodiscard]] constexpr T fold_lanes(std::array<T, optional_lanes> lanes)
+        {
+            for(std::size_t width = optional_lanes / 2; width > 0; width /= 2)
+            {
+                for(std::size_t lane = 0; lane < width; ++lane)
+                {
+                    lanes[lane] += lanes[lane + width];
+                }
+            }
+            return lanes[0];
+        }
+
+        template<typename T>
+        [[nodiscard]] constexpr T block_sum(const OptionalBlock<T> & values)
+        {
+            std::array<T, optional_lanes> lanes{};
+            for(std::size_t i = 0; i < optional_block; i += optional_lanes)
+            {
+                for(std::size_t lane = 0; lane < optional_lanes; ++lane)
+                {
+                    lanes[lane] += values[i + lane];
+                }
+            }
+            return fold_lanes(lanes);
+        }
+
+        // Running total in the chosen Summation mode. Integers are summed exactly and ignore
+        // the mode. Note that -ffast-math may reorder away the Kahan compensation.
+        template<typename T>
+        class SumAccumulator
+        {
+        public:
+            constexpr explicit SumAccumulator(Summation summation) :
+                m_summation(std::floating_point<T> ? summation : Summation::Simple)
+            {}
+
+            constexpr void add_block(const OptionalBlock<T> & values)
+            {
+                if(m_summation == Summation::Pairwise)
+                {
+                    addPairwise(block_sum(values));
+                    return;
+                }
+                if(m_summation == Summation::Kahan)
+                {
+                    for(std::size_t i = 0; i < optional_block; i += optional_lanes)
+                    {
+                        for(std::size_t lane = 0; lane < optional_lanes; ++lane)
+                        {
+                            kahanAdd(m_sum[lane], m_compensation[lane], values[i + lane]);
+                        }
+                    }
+                    return;
+                }
+                for(std::size_t i = 0; i < optional_block; i += optional_lanes)
+                {
+                    for(std::size_t lane = 0; lane < optional_lanes; ++lane)
+                    {
+                        m_sum[lane] += values[i + lane];
+                    }
+                }
+            }
+
+            //! Adds the total of another accumulator (e.g. one chunk of a parallel reduction)
+            constexpr void add(T partial)
+            {
+                switch(m_summation)
+                {
+                    case Summation::Pairwise:
+                        addPairwise(partial);
+                        break;
+                    case Summation::Kahan:
+                        kahanAdd(m_sum[0], m_compensation[0], partial);
+                        break;
+                    case Summation::Simple:
+                        m_sum[0] += partial;
+                        break;
+                }
+            }
+
+            [[nodiscard]] constexpr T total() const
+            {
+                if(m_summation == Summation::Pairwise)
+                {
+                    T sum{};
+                    for(std::size_t level = 0; level < m_levels.size(); ++level)
+                    {
+                        if((m_blocks >> level) & 1u)
+                        {
+                            sum += m_levels[level];
+                        }
+                    }
+                    return sum;
+                }
+                if(m_summation == Summation::Kahan)
+                {
+                    T sum{};
+                    T compensation{};
+                    for(std::size_t lane = 0; lane < optional_lanes; ++lane)
+                    {
+                        kahanAdd(sum, compensation, m_sum[lane]);
+                        kahanAdd(sum, compensation, -m_compensation[lane]);
+                    }
+                    return sum;
+                }
+                return fold_lanes(m_sum);
+            }
+
+        private:
+            static constexpr void kahanAdd(T & sum, T & compensation, T value)
+            {
+                const T adjusted = value - compensation;
+                const T next = sum + adjusted;
+                compensation = (next - sum) - adjusted;
+                sum = next;
+            }
+
+            // Binary counter over block sums: level k holds the sum of 2^k blocks, so every
+            // value passes through at most log2(blocks) additions.
+            constexpr void addPairwise(T blockSum)
+            {
+                std::size_t level = 0;
+                for(auto carry = m_blocks; (carry & 1u) != 0; carry >>= 1u, ++level)
+                {
+                    blockSum = m_levels[level] + blockSum;
+                }
+                m_levels[level] = blockSum;
+                ++m_blocks;
+            }
+
+            Summation m_summation;
+            std::array<T, optional_lanes> m_sum{};
+            std::array<T, optional_lanes> m_compensation{};
+            std::array<T, 64> m_levels{};
+            std::uint64_t m_blocks{0};
+        };
+
+        template<typename T>
+        struct PartialSum
+        {
+            T sum{};
+            std::size_t count{0};
+        };
+
+        template<typename T, typename Iter, typename Sent>
+        [[nodiscard]] constexpr PartialSum<T>
+          sum_present(Iter iter, const Sent & last, Summation summation)
+        {
+            OptionalBlock<T> values{};
+            PresenceBlock present{};
+            SumAccumulator<T> sum(summation);
+            std::size_t count = 0;
+            while(iter != last)
+            {
+                gather_block(iter, last, values, present);
+                count += count_present(present);
+                sum.add_block(values);
+            }
+            return {sum.total(), count};
+        }
+
+        template<typename T>
+        [[nodiscard]] constexpr std::optional<T> average_of(const PartialSum<T> & partial)
+        {
+            if(partial.count == 0)
+            {
+                return std::nullopt;
+            }
+            return partial.sum / static_cast<T>(partial.count);
+        }
+
+        // Single-pass statistics: each block contributes its count, sum, min and max, and its
+        // sum of squared deviations from the block mean (computed while the block is in cache).
+        // Blocks are merged with Chan's update, which stays accurate where the textbook
+        // sum-of-squares formula cancels catastrophically.
+        template<std::floating_point T>
+        class StatsAccumulator
+        {
+        public:
+            constexpr void add_block(const OptionalBlock<T> & values,
+                                     const PresenceBlock & present)
+            {
+                const auto count = count_present(present);
+                if(count == 0)
+                {
+                    return;
+                }
+
+                const T sum = block_sum(values);
+                const T mean = sum / static_cast<T>(count);
+                std::array<T, optional_lanes> m2{};
+                std::array<T, optional_lanes> low;
+                std::array<T, optional_lanes> high;
+                low.fill(std::numeric_limits<T>::infinity());
+                high.fill(-std::numeric_limits<T>::infinity());
+                for(std::size_t i = 0; i < optional_block; i += optional_lanes)
+                {
+                    for(std::size_t lane = 0; lane < optional_lanes; ++lane)
+                    {
+                        const bool has = present[i + lane] != 0;
+                        const T value = values[i + lane];
+                        const T deviation = has ? value - mean : T{};
+                        m2[lane] += deviation * deviation;
+                        const T lowCandidate = has ? value : std::numeric_limits<T>::infinity();
+                        const T highCandidate =
+                          has ? value : -std::numeric_limits<T>::infinity();
+                        low[lane] = lowCandidate < low[lane] ? lowCandidate : low[lane];
+                        high[lane] = highCandidate > high[lane] ? highCandidate : high[lane];
+                    }
+                }
+
+                merge(count, sum, mean, fold_lanes(m2), *std::ranges::min_element(low),
+                      *std::ranges::max_element(high));
+            }
+
+            constexpr void merge(const StatsAccumulator & other)
+            {
+                if(other.m_count != 0)
+                {
+                    merge(other.m_count, other.m_sum.total(), other.m_mean, other.m_m2,
+                          other.m_min, other.m_max);
+                }
+            }
+
+            [[nodiscard]] constexpr std::optional<OptionalStats<T>> result() const
+            {
+                if(m_count == 0)
+                {
+                    return std::nullopt;
+                }
+                const T sum = m_sum.total();
+                const T count = static_cast<T>(m_count);
+                return OptionalStats<T>{m_count, sum, sum / count, m_min, m_max, m_m2 / count};
+            }
+
+        private:
+            constexpr void merge(std::size_t count, T sum, T mean, T m2, T low, T high)
+            {
+                const T na = static_cast<T>(m_count);
+                const T nb = static_cast<T>(count);
+                const T n = na + nb;
+                const T delta = mean - m_mean;
+                m_mean += delta * nb / n;
+                m_m2 += m2 + delta * delta * na * nb / n;
+                m_count += count;
+                m_sum.add(sum);
+                m_min = (std::min)(m_min, low);
+                m_max = (std::max)(m_max, high);
+            }
+
+            std::size_t m_count{0};
+            SumAccumulator<T> m_sum{Summation::Pairwise};
+            T m_mean{};
+            T m_m2{};
+            T m_min{std::numeric_limits<T>::infinity()};
+            T m_max{-std::numeric_limits<T>::infinity()};
+        };
+
+        template<typename T, typename Iter, typename Sent>
+        [[nodiscard]] constexpr StatsAccumulator<T> stats_present(Iter iter, const Sent & last)
+        {
+            OptionalBlock<T> values{};
+            PresenceBlock present{};
+            StatsAccumulator<T> stats;
+            while(iter != last)
+            {
+                gather_block(iter, last, values, present);
+                stats.add_block(values, present);
+            }
+            return stats;
+        }
+
+        // Splits range into chunks of whole blocks, one per requested thread, and runs
+        // func(first, last) on each using up to concurrency threads (the caller included).
+        // Chunk boundaries depend only on the size and concurrency, so the combined result is
+        // the same from run to run.
+        template<typename R, typename Func>
+        [[nodiscard]] auto reduce_chunks(const R & range, std::size_t concurrency, Func func)
+        {
+            using Iter = std::ranges::iterator_t<const R>;
+            using Result = std::invoke_result_t<Func &, Iter, Iter>;
+
+            const auto total = static_cast<std::size_t>(std::ranges::size(range));
+            const auto blocks =
+              (std::max)((total + optional_block - 1) / optional_block, std::size_t{1});
+            const auto chunkCount = (std::min)((std::max)(concurrency, std::size_t{1}), blocks);
+            const auto chunkSize = ((blocks + chunkCount - 1) / chunkCount) * optional_block;
+
+            std::vector<std::optional<Result>> results(chunkCount);
+            const Iter first = std::ranges::begin(range);
+
+            parallel_for(chunkCount, chunkCount, [&](std::size_t index) {
+                const auto begin = (std::min)(index * chunkSize, total);
+                const auto end = (std::min)(begin + chunkSize, total);
+                using Diff = std::iter_difference_t<Iter>;
+                results[index].emplace(
+                  func(first + static_cast<Diff>(begin), first + static_cast<Diff>(end)));
+            });
+            return results;
+        }
+    }   // namespace detail
+
+    //
+    // Computes the average of a range of optional values: std::optional, OptionalExt,
+    // CompactOptional, or any element satisfying OptionalLike.
+    // Ignores empty entries. Returns nullopt if all values are empty.
     //
-    // Computes the average of a vector of std::optional<T>.
-    // Ignores nullopt entries. Returns nullopt if all values are empty.
+    // For arithmetic T the values are reduced by a branchless, vectorizable block kernel.
+    // Floating point sums use the given Summation mode (pairwise by default).
     //
     // Requires:
-    // - T must support default construction, operator+=, and operator/ with scalar.
+    // - Other T must support default construction, operator+=, and operator/ with scalar.
     //
     // Note: For integer types T, this performs integer division which truncates
     // the result. For example, average of {1, 2} returns 1, not 1.5.
     // Use floating-point types if precise averaging is required.
     //
-    template<typename T>
-    [[nodiscard]] constexpr std::optional<T> average_optional(const std::vector<std::optional<T>>& values)
+    template<std::ranges::input_range R>
+        requires detail::OptionalRange<R>
+    [[nodiscard]] constexpr std::optional<detail::optional_value_t<R>>
+      average_optional(R && values, Summation summation = Summation::Pairwise)
     {
-        T sum{};
-        size_t count = 0;
+        using T = detail::optional_value_t<R>;
 
-        for (const auto& val : values)
+        if constexpr(std::is_arithmetic_v<T>)
         {
-            if (val)
+            return detail::average_of(detail::sum_present<T>(
+              std::ranges::begin(values), std::ranges::end(values), summation));
+        }
+        else
+        {
+            T sum{};
+            size_t count = 0;
+
+            for (const auto& val : values)
+            {
+                if (val.has_value())
+                {
+                    sum += *val;
+                    ++count;
+                }
+            }
+
+            if (count == 0)
             {
-                sum += *val;
-                ++count;
+                return std::nullopt;
             }
+
+            return sum / static_cast<T>(count);
         }
+    }
+
+    //
+    // The original vector overload, kept so that calls naming T explicitly still compile,
+    // e.g. average_optional<int>({1, 2, std::nullopt}). Forwards to the range version.
+    //
+    template<typename T>
+    [[nodiscard]] constexpr std::optional<T>
+      average_optional(const std::vector<std::optional<T>> & values,
+                       Summation summation = Summation::Pairwise)
+    {
+        return average_optional(std::ranges::ref_view(values), summation);
+    }
+
+    //
+    // Parallel average_optional: the range is split into up to concurrency chunks, reduced on
+    // separate threads (the calling thread included) and the partial sums are combined in
+    // order. The result is reproducible for a given concurrency, but may differ in the last
+    // bits from the serial overload because the additions are grouped differently.
+    //
+    template<std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R> && detail::OptionalRange<R>
+                 && std::is_arithmetic_v<detail::optional_value_t<R>>
+    [[nodiscard]] std::optional<detail::optional_value_t<R>>
+      average_optional(const R & values, Summation summation, std::size_t concurrency)
+    {
+        using T = detail::optional_value_t<R>;
 
-        if (count == 0)
+        const auto partials =
+          detail::reduce_chunks(values, concurrency, [summation](auto first, auto last) {
+              return detail::sum_present<T>(first, last, summation);
+          });
+
+        detail::SumAccumulator<T> sum(summation);
+        std::size_t count = 0;
+        for(const auto & partial : partials)
         {
-            return std::nullopt;
+            sum.add(partial->sum);
+            count += partial->count;
         }
+        return detail::average_of(detail::PartialSum<T>{sum.total(), count});
+    }
+
+    //
+    // Count, sum, mean, min, max and population variance of the present values, computed in a
+    // single pass over the range. Returns nullopt if all values are empty.
+    //
+    template<std::ranges::input_range R>
+        requires detail::OptionalRange<R> && std::floating_point<detail::optional_value_t<R>>
+    [[nodiscard]] constexpr std::optional<OptionalStats<detail::optional_value_t<R>>>
+      optional_stats(R && values)
+    {
+        using T = detail::optional_value_t<R>;
+        return detail::stats_present<T>(std::ranges::begin(values), std::ranges::end(values))
+          .result();
+    }
+
+    //
+    // Parallel optional_stats: chunks are reduced on up to concurrency threads and merged in
+    // order.
+    //
+    template<std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R> && detail::OptionalRange<R>
+                 && std::floating_point<detail::optional_value_t<R>>
+    [[nodiscard]] std::optional<OptionalStats<detail::optional_value_t<R>>>
+      optional_stats(const R & values, std::size_t concurrency)
+    {
+        using T = detail::optional_value_t<R>;
+
+        const auto partials = detail::reduce_chunks(values, concurrency, [](auto first, auto last) {
+            return detail::stats_present<T>(first, last);
+        });
 
-        return sum / static_cast<T>(count);
+        detail::StatsAccumulator<T> stats;
+        for(const auto & partial : partials)
+        {
+            stats.merge(*partial);
+        }
+        return stats.result();
     }
 
 } // namespace lbnl
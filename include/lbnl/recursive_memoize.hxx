@@ -0,0 +1,379 @@
+// recursive_memoize.hxx
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "work_stealing_pool.hxx"
+
+namespace lbnl
+{
+    //! Thrown by RecursiveEvaluator when a key (directly or through other keys) depends on itself.
+    class DependencyCycleError : public std::logic_error
+    {
+    public:
+        DependencyCycleError() : std::logic_error("lbnl::RecursiveEvaluator: dependency cycle detected")
+        {}
+    };
+
+    //
+    // RecursiveEvaluator: memoization for generators that depend on other keys of the same cache
+    // (dynamic programming over zones, time steps, ...). The generator receives a Context and
+    // requests its subproblems through it:
+    //   - ctx.get(key) computes a missing key inline, or waits for one that is in flight;
+    //   - ctx.get_all(keys) queues the missing keys on a WorkStealingPool so independent
+    //     subproblems run in parallel.
+    //
+    // A thread that needs a key nobody has started yet runs it itself rather than waiting for a
+    // pool worker, so the calling thread keeps helping with its own batch until only keys that
+    // are running elsewhere remain. It then blocks rather than running unrelated pool tasks: a
+    // task stacked on top of a waiting generator could need that generator's own key. Every
+    // wait is recorded in a waits-for graph before the key is queued or run; a request that
+    // would close a cycle throws DependencyCycleError in the generator that made it.
+    //
+    // A generator that throws fails its key and every key waiting on it; the failed key is
+    // removed and computed again on the next request. Computed values are never removed, so
+    // references returned by get() stay valid for the lifetime of the evaluator.
+    //
+    // The pool must outlive the evaluator. The destructor waits for any task the evaluator still
+    // has queued on the pool.
+    //
+    template<typename Key,
+             typename Value,
+             typename Hash = std::hash<Key>,
+             typename KeyEqual = std::equal_to<Key>>
+    class RecursiveEvaluator
+    {
+        struct Node;
+
+    public:
+        class Context
+        {
+        public:
+            //! Value of a subproblem of the key being computed.
+            const Value & get(const Key & key)
+            {
+                return m_Owner.resolve(m_Node, key);
+            }
+
+            //! Values of several independent subproblems, computed in parallel, in input order.
+            template<std::ranges::input_range Keys>
+            std::vector<std::reference_wrapper<const Value>> get_all(const Keys & keys)
+            {
+                return m_Owner.resolveAll(m_Node, keys);
+            }
+
+        private:
+            friend class RecursiveEvaluator;
+
+            Context(RecursiveEvaluator & owner, const Node * node) : m_Owner(owner), m_Node(node)
+            {}
+
+            RecursiveEvaluator & m_Owner;
+            const Node * m_Node;
+        };
+
+        using Generator = std::function<Value(const Key &, Context &)>;
+
+        RecursiveEvaluator(Generator generator, WorkStealingPool & pool) :
+            m_Generator(std::move(generator)), m_Pool(pool)
+        {}
+
+        RecursiveEvaluator(const RecursiveEvaluator &) = delete;
+        RecursiveEvaluator & operator=(const RecursiveEvaluator &) = delete;
+
+        ~RecursiveEvaluator()
+        {
+            std::unique_lock lock(m_QueuedMutex);
+            m_QueuedDone.wait(lock, [this]() { return m_Queued == 0; });
+        }
+
+        const Value & operator()(const Key & key)
+        {
+            return get(key);
+        }
+
+        const Value & get(const Key & key)
+        {
+            return resolve(nullptr, key);
+        }
+
+        template<std::ranges::input_range Keys>
+        std::vector<std::reference_wrapper<const Value>> get_all(const Keys & keys)
+        {
+            return resolveAll(nullptr, keys);
+        }
+
+        //! Number of keys computed or in flight.
+        [[nodiscard]] std::size_t size() const
+        {
+            std::shared_lock lock(m_CacheMutex);
+            return m_Cache.size();
+        }
+
+    private:
+        struct Node
+        {
+            std::promise<Value> promise;
+            std::shared_future<Value> future{promise.get_future().share()};
+            std::atomic<bool> claimed{false};
+            const Key * key{nullptr};
+        };
+
+        using NodePtr = std::shared_ptr<Node>;
+
+        //
+        // Waits-for edges from the node being computed to the nodes it needs, removed on scope exit.
+        // Requests made outside any generator (from == nullptr) cannot be part of a cycle and are
+        // not recorded.
+        //
+        class Dependencies
+        {
+        public:
+            Dependencies(RecursiveEvaluator & owner, const Node * from) : m_Owner(owner), m_From(from)
+            {}
+
+            Dependencies(const Dependencies &) = delete;
+            Dependencies & operator=(const Dependencies &) = delete;
+
+            ~Dependencies()
+            {
+                if(!m_To.empty())
+                {
+                    m_Owner.removeEdges(m_From, m_To);
+                }
+            }
+
+            void add(const Node * to)
+            {
+                if(m_From != nullptr)
+                {
+                    if(m_To.size() == m_To.capacity())
+                    {
+                        m_To.reserve(2 * m_To.size() + 1);   // push_back below must not throw
+                    }
+                    m_Owner.addEdge(m_From, to);
+                    m_To.push_back(to);
+                }
+            }
+
+        private:
+            RecursiveEvaluator & m_Owner;
+            const Node * m_From;
+            std::vector<const Node *> m_To;
+        };
+
+        static bool isReady(const std::shared_future<Value> & future)
+        {
+            return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        //! Returns the node for key and whether this call inserted it.
+        std::pair<NodePtr, bool> findOrInsert(const Key & key)
+        {
+            {
+                std::shared_lock lock(m_CacheMutex);
+                if(auto iter = m_Cache.find(key); iter != m_Cache.end())
+                {
+                    return {iter->second, false};
+                }
+            }
+
+            std::unique_lock lock(m_CacheMutex);
+            auto [iter, inserted] = m_Cache.try_emplace(key);
+            if(inserted)
+            {
+                iter->second = std::make_shared<Node>();
+                iter->second->key = &iter->first;
+            }
+            return {iter->second, inserted};
+        }
+
+        //! Runs the node on this thread unless another thread already has.
+        void tryRun(const NodePtr & node)
+        {
+            if(!node->claimed.exchange(true))
+            {
+                run(*node);
+            }
+        }
+
+        void run(Node & node)
+        {
+            Context context(*this, &node);
+            try
+            {
+                node.promise.set_value(m_Generator(*node.key, context));
+            }
+            catch(...)
+            {
+                {
+                    std::unique_lock lock(m_CacheMutex);
+                    if(auto iter = m_Cache.find(*node.key); iter != m_Cache.end() && iter->second.get() == &node)
+                    {
+                        m_Cache.erase(iter);
+                    }
+                }
+                node.promise.set_exception(std::current_exception());
+            }
+        }
+
+        void enqueue(NodePtr node)
+        {
+            {
+                std::lock_guard lock(m_QueuedMutex);
+                ++m_Queued;
+            }
+            m_Pool.submit([this, node = std::move(node)]() {
+                tryRun(node);
+                std::lock_guard lock(m_QueuedMutex);
+                if(--m_Queued == 0)
+                {
+                    m_QueuedDone.notify_all();
+                }
+            });
+        }
+
+        const Value & resolve(const Node * parent, const Key & key)
+        {
+            auto node = findOrInsert(key).first;
+            if(isReady(node->future))
+            {
+                return node->future.get();
+            }
+
+            Dependencies dependencies(*this, parent);
+            dependencies.add(node.get());
+            tryRun(node);
+            return node->future.get();
+        }
+
+        template<typename Keys>
+        std::vector<std::reference_wrapper<const Value>> resolveAll(const Node * parent, const Keys & keys)
+        {
+            std::vector<NodePtr> nodes;
+            if constexpr(std::ranges::sized_range<Keys>)
+            {
+                nodes.reserve(std::ranges::size(keys));
+            }
+
+            // The waits-for edge goes in before a new node is queued, so a child that asks for
+            // its parent finds the edge and throws instead of waiting on it.
+            Dependencies dependencies(*this, parent);
+            for(const auto & key : keys)
+            {
+                auto [node, inserted] = findOrInsert(key);
+                if(!isReady(node->future))
+                {
+                    dependencies.add(node.get());
+                }
+                if(inserted)
+                {
+                    enqueue(node);
+                }
+                nodes.push_back(std::move(node));
+            }
+
+            // Help: whatever the pool has not picked up yet runs here instead of waiting for it.
+            for(const auto & node : nodes)
+            {
+                tryRun(node);
+            }
+
+            std::vector<std::reference_wrapper<const Value>> values;
+            values.reserve(nodes.size());
+            for(const auto & node : nodes)
+            {
+                values.emplace_back(node->future.get());
+            }
+            return values;
+        }
+
+        //! Checked on every edge: a node found new by this thread may already be claimed by
+        //! another one that recorded its own edges first.
+        void addEdge(const Node * from, const Node * to)
+        {
+            std::lock_guard lock(m_GraphMutex);
+            if(from == to || reaches(to, from))
+            {
+                throw DependencyCycleError();
+            }
+            m_WaitsFor[from].insert(to);
+        }
+
+        void removeEdges(const Node * from, const std::vector<const Node *> & targets)
+        {
+            std::lock_guard lock(m_GraphMutex);
+            auto edges = m_WaitsFor.find(from);
+            for(const auto * to : targets)
+            {
+                edges->second.erase(edges->second.find(to));
+            }
+            if(edges->second.empty())
+            {
+                m_WaitsFor.erase(edges);
+            }
+        }
+
+        //! Depth-first search of the waits-for graph. Caller holds m_GraphMutex.
+        bool reaches(const Node * from, const Node * target) const
+        {
+            if(!m_WaitsFor.contains(from))
+            {
+                return false;   // the common case: a node nobody is running yet
+            }
+            std::vector<const Node *> pending{from};
+            std::unordered_set<const Node *> visited{from};
+            while(!pending.empty())
+            {
+                const auto * current = pending.back();
+                pending.pop_back();
+                auto edges = m_WaitsFor.find(current);
+                if(edges == m_WaitsFor.end())
+                {
+                    continue;
+                }
+                for(const auto * next : edges->second)
+                {
+                    if(next == target)
+                    {
+                        return true;
+                    }
+                    if(visited.insert(next).second)
+                    {
+                        pending.push_back(next);
+                    }
+                }
+            }
+            return false;
+        }
+
+        Generator m_Generator;
+        WorkStealingPool & m_Pool;
+
+        mutable std::shared_mutex m_CacheMutex;
+        std::unordered_map<Key, NodePtr, Hash, KeyEqual> m_Cache;
+
+        std::mutex m_GraphMutex;
+        std::unordered_map<const Node *, std::unordered_multiset<const Node *>> m_WaitsFor;
+
+        std::mutex m_QueuedMutex;
+        std::condition_variable m_QueuedDone;
+        std::size_t m_Queued{0};
+    };
+
+}   // namespace lbnl
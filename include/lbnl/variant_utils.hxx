@@ -0,0 +1,359 @@
+// variant_utils.hxx
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "algorithm/element_forwarding.hxx"
+#include "detail/parallel_for.hxx"
+
+namespace lbnl
+{
+    // How split_by_alternative sizes its output vectors
+    enum class SplitSizing
+    {
+        Grow,   // one pass; the vectors grow as values arrive
+        Exact   // count the alternatives first, then allocate every vector once
+    };
+
+    namespace detail
+    {
+        template<typename T, typename... Ts>
+        inline constexpr std::size_t alternative_count_v =
+          (std::size_t{std::is_same_v<T, Ts>} + ... + 0);
+
+        template<typename T, typename... Ts>
+        constexpr std::size_t alternative_index()
+        {
+            constexpr std::array<bool, sizeof...(Ts)> matches{std::is_same_v<T, Ts>...};
+            return static_cast<std::size_t>(std::ranges::find(matches, true) - matches.begin());
+        }
+
+        template<typename V>
+        struct is_std_variant : std::false_type
+        {};
+
+        template<typename... Ts>
+        struct is_std_variant<std::variant<Ts...>> : std::true_type
+        {};
+
+        template<typename R>
+        using variant_element_t = std::remove_cvref_t<std::ranges::range_reference_t<R>>;
+
+        template<typename R>
+        concept VariantRange =
+          std::ranges::input_range<R> && is_std_variant<variant_element_t<R>>::value;
+
+        template<typename Variant>
+        inline constexpr bool has_bool_alternative_v = false;
+
+        template<typename... Ts>
+        inline constexpr bool has_bool_alternative_v<std::variant<Ts...>> =
+          (std::is_same_v<Ts, bool> || ...);
+    }   // namespace detail
+
+    //
+    // The result of split_by_alternative over a range of std::variant<Ts...>: one contiguous
+    // vector per alternative, in input order, and next to each the input position of every
+    // value. Alternatives are addressed by index, or by type when the type occurs once in Ts.
+    //
+    template<typename... Ts>
+    class AlternativeColumns
+    {
+    public:
+        static constexpr std::size_t alternatives = sizeof...(Ts);
+
+        using Values = std::tuple<std::vector<Ts>...>;
+        using Positions = std::array<std::vector<std::size_t>, sizeof...(Ts)>;
+
+        AlternativeColumns() = default;
+
+        constexpr AlternativeColumns(Values values, Positions positions) :
+            m_values(std::move(values)),
+            m_positions(std::move(positions))
+        {}
+
+        template<std::size_t I>
+        [[nodiscard]] constexpr auto & values() noexcept
+        {
+            return std::get<I>(m_values);
+        }
+
+        template<std::size_t I>
+        [[nodiscard]] constexpr const auto & values() const noexcept
+        {
+            return std::get<I>(m_values);
+        }
+
+        template<typename T>
+            requires(detail::alternative_count_v<T, Ts...> == 1)
+        [[nodiscard]] constexpr std::vector<T> & values() noexcept
+        {
+            return values<detail::alternative_index<T, Ts...>()>();
+        }
+
+        template<typename T>
+            requires(detail::alternative_count_v<T, Ts...> == 1)
+        [[nodiscard]] constexpr const std::vector<T> & values() const noexcept
+        {
+            return values<detail::alternative_index<T, Ts...>()>();
+        }
+
+        //! All value vectors as a tuple, e.g. for structured bindings
+        [[nodiscard]] constexpr Values & columns() noexcept
+        {
+            return m_values;
+        }
+
+        [[nodiscard]] constexpr const Values & columns() const noexcept
+        {
+            return m_values;
+        }
+
+        //! positions<I>()[k] is the input position of values<I>()[k]
+        template<std::size_t I>
+        [[nodiscard]] constexpr const std::vector<std::size_t> & positions() const noexcept
+        {
+            return m_positions[I];
+        }
+
+        template<typename T>
+            requires(detail::alternative_count_v<T, Ts...> == 1)
+        [[nodiscard]] constexpr const std::vector<std::size_t> & positions() const noexcept
+        {
+            return positions<detail::alternative_index<T, Ts...>()>();
+        }
+
+        //! Number of values across all alternatives
+        [[nodiscard]] constexpr std::size_t size() const noexcept
+        {
+            std::size_t total = 0;
+            for(const auto & column : m_positions)
+            {
+                total += column.size();
+            }
+            return total;
+        }
+
+    private:
+        Values m_values;
+        Positions m_positions;
+    };
+
+    namespace detail
+    {
+        // Fills the vectors of an AlternativeColumns, dispatching once on variant.index()
+        template<typename... Ts>
+        struct AlternativeSplitter
+        {
+            using Columns = AlternativeColumns<Ts...>;
+            using Counts = std::array<std::size_t, sizeof...(Ts)>;
+
+            // Adds one to counts[variant.index()]; a valueless variant is not counted
+            template<typename V>
+            static constexpr void count(const V & variant, Counts & counts)
+            {
+                if(!variant.valueless_by_exception())
+                {
+                    ++counts[variant.index()];
+                }
+            }
+
+            constexpr void reserve(const Counts & counts)
+            {
+                reserveAll(counts, std::index_sequence_for<Ts...>{});
+            }
+
+            constexpr void resize(const Counts & counts)
+            {
+                resizeAll(counts, std::index_sequence_for<Ts...>{});
+            }
+
+            // Appends the active alternative of variant; a valueless variant is skipped
+            template<typename V>
+            constexpr void append(V && variant, std::size_t position)
+            {
+                appendActive(
+                  std::forward<V>(variant), position, std::index_sequence_for<Ts...>{});
+            }
+
+            // Stores the active alternative of variant at slot[index] of its column (after resize)
+            template<typename V>
+            constexpr void store(V && variant, std::size_t position, Counts & slot)
+            {
+                storeActive(
+                  std::forward<V>(variant), position, slot, std::index_sequence_for<Ts...>{});
+            }
+
+            constexpr Columns finish() &&
+            {
+                return Columns(std::move(values), std::move(positions));
+            }
+
+            typename Columns::Values values;
+            typename Columns::Positions positions;
+
+        private:
+            template<std::size_t... Is>
+            constexpr void reserveAll(const Counts & counts, std::index_sequence<Is...>)
+            {
+                ((std::get<Is>(values).reserve(counts[Is]), positions[Is].reserve(counts[Is])),
+                 ...);
+            }
+
+            template<std::size_t... Is>
+            constexpr void resizeAll(const Counts & counts, std::index_sequence<Is...>)
+            {
+                ((std::get<Is>(values).resize(counts[Is]), positions[Is].resize(counts[Is])), ...);
+            }
+
+            template<typename V, std::size_t... Is>
+            constexpr void
+              appendActive(V && variant, std::size_t position, std::index_sequence<Is...>)
+            {
+                const auto index = variant.index();
+                (void)((index == Is
+                        && (std::get<Is>(values).push_back(std::get<Is>(std::forward<V>(variant))),
+                            positions[Is].push_back(position),
+                            true))
+                       || ...);
+            }
+
+            template<typename V, std::size_t... Is>
+            constexpr void storeActive(V && variant,
+                                       std::size_t position,
+                                       Counts & slot,
+                                       std::index_sequence<Is...>)
+            {
+                const auto index = variant.index();
+                (void)((index == Is
+                        && (std::get<Is>(values)[slot[Is]] = std::get<Is>(std::forward<V>(variant)),
+                            positions[Is][slot[Is]++] = position,
+                            true))
+                       || ...);
+            }
+        };
+
+        template<typename Variant>
+        struct alternative_splitter;
+
+        template<typename... Ts>
+        struct alternative_splitter<std::variant<Ts...>>
+        {
+            using type = AlternativeSplitter<Ts...>;
+        };
+
+        template<typename R>
+        using alternative_splitter_t = typename alternative_splitter<variant_element_t<R>>::type;
+    }   // namespace detail
+
+    //! Splits a range of std::variant<Ts...> into one vector per alternative in a single pass,
+    //! keeping input order and recording the input position of every value. This replaces one
+    //! get_if_opt pass per alternative; each alternative can then be processed with a tight
+    //! loop over contiguous values and the results scattered back through positions<I>().
+    //! SplitSizing::Exact counts the alternatives first so every vector is allocated once. It
+    //! applies to ranges that store their elements (forward ranges yielding references);
+    //! ranges that compute their elements are always traversed once.
+    //! An owning range passed as an rvalue (e.g. std::move(column)) has its values moved out.
+    //! Valueless variants are skipped.
+    template<std::ranges::input_range R>
+        requires detail::VariantRange<R>
+    [[nodiscard]] constexpr auto split_by_alternative(R && range,
+                                                      SplitSizing sizing = SplitSizing::Grow)
+    {
+        using Splitter = detail::alternative_splitter_t<R>;
+        Splitter splitter;
+
+        if constexpr(std::ranges::forward_range<R>
+                     && std::is_lvalue_reference_v<std::ranges::range_reference_t<R>>)
+        {
+            if(sizing == SplitSizing::Exact)
+            {
+                typename Splitter::Counts counts{};
+                for(const auto & variant : range)
+                {
+                    Splitter::count(variant, counts);
+                }
+                splitter.reserve(counts);
+            }
+        }
+
+        std::size_t position = 0;
+        for(auto && variant : range)
+        {
+            splitter.append(detail::element_from<R>(variant), position++);
+        }
+        return std::move(splitter).finish();
+    }
+
+    //! Parallel split_by_alternative: the range is cut into up to concurrency chunks. The
+    //! alternatives of every chunk are counted in parallel, each vector is sized exactly once,
+    //! and the chunks then fill their own slices in parallel, so the result is identical to
+    //! the serial one. Requires default-constructible alternatives. A bool alternative would be
+    //! collected into a packed std::vector<bool>, whose neighbouring elements cannot be written
+    //! from different threads, so such variants only have the serial overload.
+    template<std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R> && detail::VariantRange<R>
+                 && (!detail::has_bool_alternative_v<detail::variant_element_t<R>>)
+    [[nodiscard]] auto split_by_alternative(R && range, std::size_t concurrency)
+    {
+        using Splitter = detail::alternative_splitter_t<R>;
+        using Counts = typename Splitter::Counts;
+        using Diff = std::ranges::range_difference_t<R>;
+
+        const auto total = static_cast<std::size_t>(std::ranges::size(range));
+        const auto chunkCount =
+          (std::min)((std::max)(concurrency, std::size_t{1}), (std::max)(total, std::size_t{1}));
+        const auto chunkSize = (total + chunkCount - 1) / chunkCount;
+        const auto first = std::ranges::begin(range);
+
+        auto chunkBounds = [&](std::size_t chunk) {
+            const auto begin = (std::min)(chunk * chunkSize, total);
+            return std::pair{begin, (std::min)(begin + chunkSize, total)};
+        };
+
+        std::vector<Counts> offsets(chunkCount, Counts{});
+        detail::parallel_for(chunkCount, chunkCount, [&](std::size_t chunk) {
+            const auto [begin, end] = chunkBounds(chunk);
+            for(auto idx = begin; idx < end; ++idx)
+            {
+                Splitter::count(first[static_cast<Diff>(idx)], offsets[chunk]);
+            }
+        });
+
+        // Turn per-chunk counts into each chunk's first slot in every column
+        Counts totals{};
+        for(auto & chunkOffsets : offsets)
+        {
+            for(std::size_t alt = 0; alt < totals.size(); ++alt)
+            {
+                const auto count = chunkOffsets[alt];
+                chunkOffsets[alt] = totals[alt];
+                totals[alt] += count;
+            }
+        }
+
+        Splitter splitter;
+        splitter.resize(totals);
+        detail::parallel_for(chunkCount, chunkCount, [&](std::size_t chunk) {
+            const auto [begin, end] = chunkBounds(chunk);
+            auto slot = offsets[chunk];
+            for(auto idx = begin; idx < end; ++idx)
+            {
+                auto && variant = first[static_cast<Diff>(idx)];
+                splitter.store(detail::element_from<R>(variant), idx, slot);
+            }
+        });
+        return std::move(splitter).finish();
+    }
+
+}   // namespace lbnl
@@ -0,0 +1,449 @@
+// warm_start.hxx
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#if !defined(_WIN32)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include "memoize/lazy_evaluator.hxx"
+
+#if defined(_WIN32)
+// The few kernel32 calls MappedFile needs, declared here instead of including <windows.h>, so
+// includers (and the lbnl module) do not get its macros. The signatures match the SDK exactly,
+// so a translation unit that also includes <windows.h> sees compatible redeclarations.
+union _LARGE_INTEGER;
+struct _SECURITY_ATTRIBUTES;
+
+namespace lbnl::detail::win32
+{
+    using HANDLE = void *;
+    using DWORD = unsigned long;
+    using BOOL = int;
+#    if defined(_WIN64)
+    using SIZE_T = unsigned __int64;
+#    else
+    using SIZE_T = unsigned long;
+#    endif
+
+    inline constexpr DWORD genericRead = 0x80000000UL;
+    inline constexpr DWORD fileShareRead = 0x00000001UL;
+    inline constexpr DWORD openExisting = 3;
+    inline constexpr DWORD fileAttributeNormal = 0x00000080UL;
+    inline constexpr DWORD pageReadOnly = 0x02;
+    inline constexpr DWORD fileMapRead = 0x0004;
+
+    inline HANDLE invalidHandle() noexcept
+    {
+        return reinterpret_cast<HANDLE>(static_cast<std::intptr_t>(-1));
+    }
+
+    extern "C"
+    {
+        __declspec(dllimport) HANDLE __stdcall CreateFileW(const wchar_t * fileName,
+                                                           DWORD desiredAccess,
+                                                           DWORD shareMode,
+                                                           _SECURITY_ATTRIBUTES * security,
+                                                           DWORD creationDisposition,
+                                                           DWORD flagsAndAttributes,
+                                                           HANDLE templateFile);
+        __declspec(dllimport) BOOL __stdcall GetFileSizeEx(HANDLE file, _LARGE_INTEGER * size);
+        __declspec(dllimport) HANDLE __stdcall CreateFileMappingW(HANDLE file,
+                                                                  _SECURITY_ATTRIBUTES * security,
+                                                                  DWORD protect,
+                                                                  DWORD maximumSizeHigh,
+                                                                  DWORD maximumSizeLow,
+                                                                  const wchar_t * name);
+        __declspec(dllimport) void * __stdcall MapViewOfFile(HANDLE mapping,
+                                                             DWORD desiredAccess,
+                                                             DWORD fileOffsetHigh,
+                                                             DWORD fileOffsetLow,
+                                                             SIZE_T numberOfBytesToMap);
+        __declspec(dllimport) BOOL __stdcall UnmapViewOfFile(const void * baseAddress);
+        __declspec(dllimport) BOOL __stdcall CloseHandle(HANDLE object);
+    }
+}   // namespace lbnl::detail::win32
+#endif
+
+namespace lbnl
+{
+    //
+    // Codec concept: turns a T into bytes and back.
+    // encode() appends to the output buffer; decode() receives exactly the bytes encode() wrote.
+    // decode() may return std::optional<T> to reject bytes it cannot have written (for example
+    // a value of the wrong size from an older file); WarmStartCache then reports a miss.
+    //
+    template<typename C, typename T>
+    concept Codec = requires(const C & codec, const T & value, std::string & out, std::string_view bytes) {
+        codec.encode(value, out);
+        requires std::convertible_to<decltype(codec.decode(bytes)), T>
+                   || std::same_as<decltype(codec.decode(bytes)), std::optional<T>>;
+    };
+
+    //! Byte-wise codec for trivially copyable types (int, double, plain structs).
+    template<typename T>
+        requires std::is_trivially_copyable_v<T>
+    struct TrivialCodec
+    {
+        void encode(const T & value, std::string & out) const
+        {
+            out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        //! nullopt unless bytes holds exactly one T
+        [[nodiscard]] std::optional<T> decode(std::string_view bytes) const
+        {
+            if(bytes.size() != sizeof(T))
+            {
+                return std::nullopt;
+            }
+            T value{};
+            std::memcpy(&value, bytes.data(), sizeof(T));
+            return value;
+        }
+    };
+
+    //! Codec for std::string; the bytes are the characters themselves.
+    struct StringCodec
+    {
+        void encode(const std::string & value, std::string & out) const
+        {
+            out.append(value);
+        }
+
+        [[nodiscard]] std::string decode(std::string_view bytes) const
+        {
+            return std::string(bytes);
+        }
+    };
+
+    namespace detail
+    {
+        //
+        // Read-only memory mapping of a whole file. An empty or missing file yields an empty view.
+        //
+        class MappedFile
+        {
+        public:
+            explicit MappedFile(const std::filesystem::path & path)
+            {
+#if defined(_WIN32)
+                win32::HANDLE file = win32::CreateFileW(path.c_str(),
+                                                        win32::genericRead,
+                                                        win32::fileShareRead,
+                                                        nullptr,
+                                                        win32::openExisting,
+                                                        win32::fileAttributeNormal,
+                                                        nullptr);
+                if(file == win32::invalidHandle())
+                {
+                    return;
+                }
+                // LARGE_INTEGER is a union over a 64-bit QuadPart, so an int64 has its layout
+                std::int64_t size = 0;
+                auto * largeInteger = reinterpret_cast<_LARGE_INTEGER *>(&size);
+                if(win32::GetFileSizeEx(file, largeInteger) && size > 0)
+                {
+                    win32::HANDLE mapping =
+                      win32::CreateFileMappingW(file, nullptr, win32::pageReadOnly, 0, 0, nullptr);
+                    if(mapping != nullptr)
+                    {
+                        if(void * view = win32::MapViewOfFile(mapping, win32::fileMapRead, 0, 0, 0))
+                        {
+                            m_Data = static_cast<const char *>(view);
+                            m_Size = static_cast<std::size_t>(size);
+                        }
+                        win32::CloseHandle(mapping);
+                    }
+                }
+                win32::CloseHandle(file);
+#else
+                const int fd = ::open(path.c_str(), O_RDONLY);
+                if(fd < 0)
+                {
+                    return;
+                }
+                struct stat info{};
+                if(::fstat(fd, &info) == 0 && info.st_size > 0)
+                {
+                    void * view =
+                      ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if(view != MAP_FAILED)
+                    {
+                        m_Data = static_cast<const char *>(view);
+                        m_Size = static_cast<std::size_t>(info.st_size);
+                    }
+                }
+                ::close(fd);
+#endif
+            }
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile & operator=(const MappedFile &) = delete;
+
+            ~MappedFile()
+            {
+                if(m_Data == nullptr)
+                {
+                    return;
+                }
+#if defined(_WIN32)
+                win32::UnmapViewOfFile(m_Data);
+#else
+                ::munmap(const_cast<char *>(m_Data), m_Size);
+#endif
+            }
+
+            [[nodiscard]] std::string_view bytes() const noexcept
+            {
+                return {m_Data, m_Size};
+            }
+
+        private:
+            const char * m_Data{nullptr};
+            std::size_t m_Size{0};
+        };
+
+        //
+        // On-disk layout (native byte order; this is a cache, not an interchange format):
+        //   header:  magic[8] | format u32 | byte-order mark u32 | user version u64 | count u64
+        //   entries: key length u64 | key bytes | value length u64 | value bytes
+        //
+        inline constexpr char warmStartMagic[8] = {'L', 'B', 'N', 'L', 'W', 'S', 'C', '\0'};
+        inline constexpr std::uint32_t warmStartFormat = 1;
+        inline constexpr std::uint32_t warmStartByteOrder = 0x01020304;
+        inline constexpr std::size_t warmStartHeaderSize = 8 + 4 + 4 + 8 + 8;
+
+        template<typename Int>
+        [[nodiscard]] Int readInt(std::string_view bytes, std::size_t offset)
+        {
+            Int value{};
+            std::memcpy(&value, bytes.data() + offset, sizeof(Int));
+            return value;
+        }
+
+        template<typename Int>
+        void appendInt(std::string & out, Int value)
+        {
+            out.append(reinterpret_cast<const char *>(&value), sizeof(Int));
+        }
+    }   // namespace detail
+
+    //
+    // WarmStartCache: read-only view of a file written by save_warm_start().
+    // The file is memory mapped on construction and only the entry boundaries are indexed;
+    // a value is decoded the first time load() is asked for its key.
+    // A missing, truncated or stale (different version) file behaves as an empty cache.
+    //
+    template<typename Key,
+             typename Value,
+             Codec<Key> KeyCodec = TrivialCodec<Key>,
+             Codec<Value> ValueCodec = TrivialCodec<Value>>
+    class WarmStartCache
+    {
+    public:
+        WarmStartCache(const std::filesystem::path & path,
+                       std::uint64_t version,
+                       KeyCodec keyCodec = {},
+                       ValueCodec valueCodec = {}) :
+            m_File(path), m_KeyCodec(std::move(keyCodec)), m_ValueCodec(std::move(valueCodec))
+        {
+            buildIndex(version);
+        }
+
+        //! True when the file existed, matched the version and parsed completely.
+        [[nodiscard]] bool valid() const noexcept
+        {
+            return m_Valid;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_Index.size();
+        }
+
+        //! Decodes the stored value for key, or returns nullopt if the file does not have it
+        //! or the value codec rejects the stored bytes.
+        [[nodiscard]] std::optional<Value> load(const Key & key) const
+        {
+            std::string encoded;
+            m_KeyCodec.encode(key, encoded);
+            auto iter = m_Index.find(encoded);
+            if(iter == m_Index.end())
+            {
+                return std::nullopt;
+            }
+            return std::optional<Value>(m_ValueCodec.decode(iter->second));
+        }
+
+    private:
+        void buildIndex(std::uint64_t version)
+        {
+            const auto bytes = m_File.bytes();
+            if(bytes.size() < detail::warmStartHeaderSize
+               || std::memcmp(bytes.data(), detail::warmStartMagic, sizeof(detail::warmStartMagic)) != 0
+               || detail::readInt<std::uint32_t>(bytes, 8) != detail::warmStartFormat
+               || detail::readInt<std::uint32_t>(bytes, 12) != detail::warmStartByteOrder
+               || detail::readInt<std::uint64_t>(bytes, 16) != version)
+            {
+                return;
+            }
+
+            // Every entry takes at least its two length fields, so a larger count is corrupt
+            const auto count = detail::readInt<std::uint64_t>(bytes, 24);
+            constexpr std::size_t minimumEntrySize = 2 * sizeof(std::uint64_t);
+            if(count > (bytes.size() - detail::warmStartHeaderSize) / minimumEntrySize)
+            {
+                return;
+            }
+            std::size_t offset = detail::warmStartHeaderSize;
+
+            // Reads one length-prefixed field; fails on truncation.
+            auto nextField = [&bytes, &offset](std::string_view & field) {
+                if(bytes.size() - offset < sizeof(std::uint64_t))
+                {
+                    return false;
+                }
+                const auto length = detail::readInt<std::uint64_t>(bytes, offset);
+                offset += sizeof(std::uint64_t);
+                if(bytes.size() - offset < length)
+                {
+                    return false;
+                }
+                field = bytes.substr(offset, static_cast<std::size_t>(length));
+                offset += static_cast<std::size_t>(length);
+                return true;
+            };
+
+            std::unordered_map<std::string_view, std::string_view> index;
+            index.reserve(static_cast<std::size_t>(count));
+            for(std::uint64_t entry = 0; entry < count; ++entry)
+            {
+                std::string_view key;
+                std::string_view value;
+                if(!nextField(key) || !nextField(value))
+                {
+                    return;
+                }
+                index.emplace(key, value);
+            }
+
+            m_Index = std::move(index);
+            m_Valid = true;
+        }
+
+        detail::MappedFile m_File;
+        KeyCodec m_KeyCodec;
+        ValueCodec m_ValueCodec;
+        std::unordered_map<std::string_view, std::string_view> m_Index;
+        bool m_Valid{false};
+    };
+
+    //! Wraps a generator so that it first consults the warm-start file and only computes
+    //! values the file does not have. Pass the result to the LazyEvaluator constructor.
+    template<typename Key, typename Value, typename KeyCodec, typename ValueCodec>
+    [[nodiscard]] typename LazyEvaluator<Key, Value>::Generator
+      with_warm_start(std::shared_ptr<const WarmStartCache<Key, Value, KeyCodec, ValueCodec>> cache,
+                      typename LazyEvaluator<Key, Value>::Generator generator)
+    {
+        return [cache = std::move(cache), generator = std::move(generator)](const Key & key) {
+            if(cache)
+            {
+                if(auto stored = cache->load(key))
+                {
+                    return std::move(*stored);
+                }
+            }
+            return generator(key);
+        };
+    }
+
+    template<typename Key, typename Value, typename KeyCodec, typename ValueCodec>
+    [[nodiscard]] typename LazyEvaluator<Key, Value>::Generator
+      with_warm_start(std::shared_ptr<WarmStartCache<Key, Value, KeyCodec, ValueCodec>> cache,
+                      typename LazyEvaluator<Key, Value>::Generator generator)
+    {
+        return with_warm_start(
+          std::shared_ptr<const WarmStartCache<Key, Value, KeyCodec, ValueCodec>>(std::move(cache)),
+          std::move(generator));
+    }
+
+    //! Writes every computed entry of the evaluator to path, tagged with version.
+    //! The file is written next to path and renamed over it, so readers never see a partial
+    //! file. Returns false if the file could not be written or renamed; the temporary file
+    //! is removed in that case.
+    template<typename Key,
+             typename Value,
+             typename Hash,
+             typename KeyEqual,
+             Codec<Key> KeyCodec = TrivialCodec<Key>,
+             Codec<Value> ValueCodec = TrivialCodec<Value>>
+    bool save_warm_start(const LazyEvaluator<Key, Value, Hash, KeyEqual> & evaluator,
+                         const std::filesystem::path & path,
+                         std::uint64_t version,
+                         const KeyCodec & keyCodec = {},
+                         const ValueCodec & valueCodec = {})
+    {
+        std::string body;
+        std::uint64_t count = 0;
+        std::string field;
+        auto appendField = [&body, &field](auto && encode) {
+            field.clear();
+            encode(field);
+            detail::appendInt(body, static_cast<std::uint64_t>(field.size()));
+            body.append(field);
+        };
+
+        evaluator.for_each_computed([&](const Key & key, const Value & value) {
+            appendField([&](std::string & out) { keyCodec.encode(key, out); });
+            appendField([&](std::string & out) { valueCodec.encode(value, out); });
+            ++count;
+        });
+
+        std::string header(detail::warmStartMagic, sizeof(detail::warmStartMagic));
+        detail::appendInt(header, detail::warmStartFormat);
+        detail::appendInt(header, detail::warmStartByteOrder);
+        detail::appendInt(header, version);
+        detail::appendInt(header, count);
+
+        auto temporary = path;
+        temporary += ".tmp";
+        std::error_code ec;
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(header.data(), static_cast<std::streamsize>(header.size()));
+            out.write(body.data(), static_cast<std::streamsize>(body.size()));
+            out.close();   // flushes; a failed flush or close sets failbit
+            if(!out)
+            {
+                std::filesystem::remove(temporary, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary, path, ec);
+        if(ec)
+        {
+            std::filesystem::remove(temporary, ec);
+            return false;
+        }
+        return true;
+    }
+
+}   // namespace lbnl
@@ -0,0 +1,178 @@
+// work_stealing_pool.hxx
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lbnl
+{
+    //
+    // WorkStealingPool: fixed set of worker threads, each with its own task deque.
+    // A task submitted from a worker goes to that worker's deque and is taken back LIFO
+    // (depth-first, cache-warm); idle workers steal FIFO from the other deques.
+    // Tasks submitted from outside the pool are spread round-robin.
+    //
+    // The pool is callable with a task, so it can be passed directly as the executor of
+    // LazyEvaluator::get_async or enable_refresh_ahead.
+    //
+    class WorkStealingPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        //! A pool with zero threads runs every submitted task inline on the submitting thread.
+        explicit WorkStealingPool(std::size_t threadCount = std::thread::hardware_concurrency()) :
+            m_Queues(threadCount)
+        {
+            m_Threads.reserve(threadCount);
+            for(std::size_t index = 0; index < threadCount; ++index)
+            {
+                m_Threads.emplace_back([this, index]() { workerLoop(index); });
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool & operator=(const WorkStealingPool &) = delete;
+
+        //! Runs every task already submitted, then joins the workers.
+        ~WorkStealingPool()
+        {
+            {
+                std::lock_guard lock(m_SleepMutex);
+                m_Stop = true;
+            }
+            m_Wake.notify_all();
+            for(auto & thread : m_Threads)
+            {
+                thread.join();
+            }
+        }
+
+        //! Queues a task. Tasks should handle their own errors; an exception that escapes a task
+        //! is discarded so the worker survives.
+        void submit(Task task)
+        {
+            if(m_Queues.empty())
+            {
+                runTask(task);
+                return;
+            }
+
+            const auto index = (tl_Pool == this) ? tl_Index : m_NextQueue++ % m_Queues.size();
+            {
+                std::lock_guard lock(m_Queues[index].mutex);
+                m_Queues[index].tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard lock(m_SleepMutex);
+                ++m_Pending;
+            }
+            m_Wake.notify_one();
+        }
+
+        void operator()(Task task)
+        {
+            submit(std::move(task));
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_Threads.size();
+        }
+
+        //! True when called from one of this pool's worker threads.
+        [[nodiscard]] bool is_worker_thread() const noexcept
+        {
+            return tl_Pool == this;
+        }
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        static void runTask(Task & task)
+        {
+            try
+            {
+                task();
+            }
+            catch(...)
+            {
+                // Discarded: see submit()
+            }
+        }
+
+        bool tryPopOwn(std::size_t index, Task & task)
+        {
+            std::lock_guard lock(m_Queues[index].mutex);
+            if(m_Queues[index].tasks.empty())
+            {
+                return false;
+            }
+            task = std::move(m_Queues[index].tasks.back());
+            m_Queues[index].tasks.pop_back();
+            return true;
+        }
+
+        bool trySteal(std::size_t thief, Task & task)
+        {
+            for(std::size_t offset = 1; offset < m_Queues.size(); ++offset)
+            {
+                auto & victim = m_Queues[(thief + offset) % m_Queues.size()];
+                std::lock_guard lock(victim.mutex);
+                if(!victim.tasks.empty())
+                {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void workerLoop(std::size_t index)
+        {
+            tl_Pool = this;
+            tl_Index = index;
+
+            for(;;)
+            {
+                Task task;
+                if(tryPopOwn(index, task) || trySteal(index, task))
+                {
+                    --m_Pending;
+                    runTask(task);
+                    continue;
+                }
+
+                std::unique_lock lock(m_SleepMutex);
+                m_Wake.wait(lock, [this]() { return m_Stop || m_Pending.load() > 0; });
+                if(m_Stop && m_Pending.load() == 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        static inline thread_local const WorkStealingPool * tl_Pool = nullptr;
+        static inline thread_local std::size_t tl_Index = 0;
+
+        std::vector<Queue> m_Queues;
+        std::vector<std::thread> m_Threads;
+        std::atomic<std::size_t> m_NextQueue{0};
+        std::atomic<std::size_t> m_Pending{0};
+        std::mutex m_SleepMutex;
+        std::condition_variable m_Wake;
+        bool m_Stop{false};
+    };
+
+}   // namespace lbnl
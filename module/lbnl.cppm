@@ -0,0 +1,158 @@
+// lbnl.cppm
+//
+// C++20 named module for the whole library:
+//
+//   import lbnl;
+//
+// The headers are compiled once into the module instead of being parsed by every translation
+// unit. Built only when LBNL_BUILD_MODULE is ON (see CMakeLists.txt). Keep the export list in
+// sync with the public names of the headers.
+//
+module;
+
+#include <lbnl/algorithm.hxx>
+#include <lbnl/compact_optional.hxx>
+#include <lbnl/enum_index_mapper.hxx>
+#include <lbnl/enum_map.hxx>
+#include <lbnl/enum_string_mapper.hxx>
+#include <lbnl/error.hxx>
+#include <lbnl/expected.hxx>
+#include <lbnl/expected_utils.hxx>
+#include <lbnl/lazy_chain.hxx>
+#include <lbnl/map_utils.hxx>
+#include <lbnl/memoize.hxx>
+#include <lbnl/optional.hxx>
+#include <lbnl/optional_column.hxx>
+#include <lbnl/optional_utils.hxx>
+#include <lbnl/recursive_memoize.hxx>
+#include <lbnl/variant_utils.hxx>
+#include <lbnl/warm_start.hxx>
+#include <lbnl/work_stealing_pool.hxx>
+
+export module lbnl;
+
+export namespace lbnl
+{
+    // algorithm.hxx
+    using lbnl::contains;
+    using lbnl::filter;
+    using lbnl::find_element;
+    using lbnl::flatten;
+    using lbnl::merge;
+    using lbnl::partition;
+    using lbnl::sorted_unique;
+    using lbnl::split;
+    using lbnl::to_vector;
+    using lbnl::transform_filter;
+    using lbnl::transform_if;
+    using lbnl::transform_to_vector;
+    using lbnl::zip;
+
+    // optional.hxx
+    using lbnl::extend;
+    using lbnl::extend_ref;
+    using lbnl::get_if_opt;
+    using lbnl::is_in_variant_v;
+    using lbnl::is_optional_ext;
+    using lbnl::is_std_optional;
+    using lbnl::OptionalExt;
+
+    // optional_utils.hxx
+    using lbnl::average_optional;
+    using lbnl::optional_stats;
+    using lbnl::OptionalLike;
+    using lbnl::OptionalStats;
+    using lbnl::Summation;
+
+    // compact_optional.hxx
+    using lbnl::compact;
+    using lbnl::CompactOptional;
+    using lbnl::CompactOptionalPolicy;
+    using lbnl::default_compact_policy;
+    using lbnl::default_compact_policy_t;
+    using lbnl::is_compact_optional;
+    using lbnl::NaNPolicy;
+    using lbnl::NullPointerPolicy;
+    using lbnl::SentinelPolicy;
+
+    // optional_column.hxx
+    using lbnl::OptionalColumn;
+
+    // variant_utils.hxx
+    using lbnl::AlternativeColumns;
+    using lbnl::split_by_alternative;
+    using lbnl::SplitSizing;
+
+    // expected.hxx
+    using lbnl::BadExpectedAccess;
+    using lbnl::ExpectedExt;
+    using lbnl::is_expected_ext;
+    using lbnl::make_expected;
+    using lbnl::make_unexpected;
+    using lbnl::unexpect;
+    using lbnl::unexpect_t;
+    using lbnl::Unexpected;
+
+    // expected_utils.hxx
+    using lbnl::collect;
+    using lbnl::partition_results;
+    using lbnl::transform_expected;
+
+    // error.hxx
+    using lbnl::BasicErrorFormat;
+    using lbnl::Error;
+    using lbnl::ErrorFormat;
+    using lbnl::with_context;
+
+    // lazy_chain.hxx
+    using lbnl::lazy;
+    using lbnl::LazyChain;
+
+    // map_utils.hxx
+    using lbnl::AssociativeContainer;
+    using lbnl::map_keys;
+    using lbnl::map_lookup_by_key;
+    using lbnl::map_lookup_by_value;
+    using lbnl::map_values;
+    using lbnl::TransparentLookup;
+    using lbnl::TransparentStringHash;
+
+    // enum_index_mapper.hxx, enum_string_mapper.hxx, enum_map.hxx
+    using lbnl::BulkConversion;
+    using lbnl::Enum;
+    using lbnl::EnumIndexMapper;
+    using lbnl::EnumMap;
+    using lbnl::EnumRange;
+    using lbnl::EnumSet;
+    using lbnl::EnumSlots;
+    using lbnl::EnumStringCase;
+    using lbnl::EnumStringMapper;
+    using lbnl::make_enum_index_mapper;
+    using lbnl::make_enum_string_mapper;
+    using lbnl::MappedEnumSlots;
+
+    // memoize.hxx
+    using lbnl::FrontCache;
+    using lbnl::FrontCacheStats;
+    using lbnl::HeterogeneousKey;
+    using lbnl::InlineLazyEvaluator;
+    using lbnl::LazyEvaluator;
+    using lbnl::make_inline_lazy_evaluator;
+    using lbnl::memoize;
+    using lbnl::Memoized;
+    using lbnl::TransparentHashing;
+    using lbnl::TupleHash;
+
+    // recursive_memoize.hxx, work_stealing_pool.hxx
+    using lbnl::DependencyCycleError;
+    using lbnl::RecursiveEvaluator;
+    using lbnl::WorkStealingPool;
+
+    // warm_start.hxx
+    using lbnl::Codec;
+    using lbnl::save_warm_start;
+    using lbnl::StringCodec;
+    using lbnl::TrivialCodec;
+    using lbnl::WarmStartCache;
+    using lbnl::with_warm_start;
+}   // namespace lbnl
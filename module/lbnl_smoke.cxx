@@ -0,0 +1,22 @@
+// lbnl_smoke.cxx
+//
+// Checks that the lbnl module can be imported and used (built with LBNL_BUILD_MODULE).
+import lbnl;
+
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+int main()
+{
+    const std::vector<int> values{3, 1, 3, 2};
+    const std::vector<std::variant<int, double>> cells{1, 2.0, 3};
+    const auto error = lbnl::Error(1, "row {}", 4).with_context("file {}", std::string("a.csv"));
+    const auto doubled = lbnl::extend(std::optional<int>(2)).map([](int v) { return v * 2; });
+
+    const bool ok = lbnl::sorted_unique(values).size() == 3
+                    && lbnl::split_by_alternative(cells).values<int>().size() == 2
+                    && error.message() == "file a.csv: row 4" && doubled.value_or(0) == 4;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+// compact_optional.unit.cxx
+#include <gtest/gtest.h>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <lbnl/compact_optional.hxx>
+#include <lbnl/optional_utils.hxx>
+
+namespace
+{
+    using CompactDouble = lbnl::CompactOptional<double>;
+    using CompactIndex = lbnl::CompactOptional<int, lbnl::SentinelPolicy<int, -1>>;
+
+    static_assert(sizeof(CompactDouble) == sizeof(double));
+    static_assert(sizeof(lbnl::CompactOptional<float>) == sizeof(float));
+    static_assert(sizeof(CompactIndex) == sizeof(int));
+    static_assert(sizeof(lbnl::CompactOptional<const char *>) == sizeof(const char *));
+    static_assert(std::is_trivially_copyable_v<CompactDouble>);
+    static_assert(lbnl::is_compact_optional<CompactIndex>::value);
+
+    enum class Level : std::uint8_t
+    {
+        Low,
+        High,
+        Unknown = 0xFF
+    };
+
+    // Usable in constant expressions
+    constexpr CompactIndex constexprIndex = CompactIndex(4).map([](int x) { return x + 1; });
+    static_assert(constexprIndex.has_value() && *constexprIndex == 5);
+    static_assert(!CompactDouble().has_value());
+}   // namespace
+
+TEST(CompactOptional, EmptyIsReservedNaNOnly)
+{
+    const CompactDouble empty;
+    EXPECT_FALSE(empty.has_value());
+    EXPECT_TRUE(std::isnan(empty.raw()));
+
+    // Ordinary NaNs are values, not the empty state
+    const CompactDouble quiet(std::numeric_limits<double>::quiet_NaN());
+    EXPECT_TRUE(quiet.has_value());
+
+    const CompactDouble present(2.5);
+    ASSERT_TRUE(present.has_value());
+    EXPECT_EQ(*present, 2.5);
+    EXPECT_EQ(present.value(), 2.5);
+    EXPECT_THROW((void)empty.value(), std::bad_optional_access);
+}
+
+TEST(CompactOptional, CustomNaNPattern)
+{
+    using Tagged = lbnl::CompactOptional<double, lbnl::NaNPolicy<double, 0x7FF8'0000'0000'BEEFull>>;
+    const Tagged empty;
+    EXPECT_EQ(std::bit_cast<std::uint64_t>(empty.raw()), 0x7FF8'0000'0000'BEEFull);
+    EXPECT_TRUE(Tagged(CompactDouble().raw()).has_value());
+}
+
+TEST(CompactOptional, SentinelAndPointerPolicies)
+{
+    CompactIndex index;
+    EXPECT_EQ(index, std::nullopt);
+    index.emplace(3);
+    EXPECT_EQ(index, 3);
+    index.reset();
+    EXPECT_FALSE(index.has_value());
+
+    // Storing the sentinel itself yields an empty optional
+    EXPECT_FALSE(CompactIndex(-1).has_value());
+
+    const lbnl::CompactOptional<Level, lbnl::SentinelPolicy<Level, Level::Unknown>> level(Level::High);
+    EXPECT_EQ(level, Level::High);
+
+    const char * text = "abc";
+    const lbnl::CompactOptional<const char *> name(text);
+    const lbnl::CompactOptional<const char *> none;
+    EXPECT_EQ(name.map([](const char * s) { return std::string(s); }).value_or("none"), "abc");
+    EXPECT_EQ(none.map([](const char * s) { return std::string(s); }).value_or("none"), "none");
+}
+
+TEST(CompactOptional, MonadicOperations)
+{
+    const CompactDouble present(4.0);
+    const CompactDouble empty;
+
+    auto root = present.map([](double x) { return std::sqrt(x); });
+    static_assert(std::is_same_v<decltype(root), CompactDouble>);
+    EXPECT_EQ(root, 2.0);
+
+    auto asFloat = present.transform([](double x) { return static_cast<float>(x); });
+    static_assert(std::is_same_v<decltype(asFloat), lbnl::CompactOptional<float>>);
+
+    auto asString = present.map([](double x) { return std::to_string(static_cast<int>(x)); });
+    static_assert(std::is_same_v<decltype(asString), lbnl::OptionalExt<std::string>>);
+    EXPECT_EQ(*asString, "4");
+    EXPECT_FALSE(empty.map([](double x) { return std::to_string(x); }).has_value());
+
+    auto positive = [](double x) { return x > 0 ? CompactDouble(x) : CompactDouble(); };
+    EXPECT_EQ(present.and_then(positive), 4.0);
+    EXPECT_FALSE(empty.and_then(positive).has_value());
+
+    auto viaStd = present.and_then([](double x) { return std::optional<int>(static_cast<int>(x)); });
+    static_assert(std::is_same_v<decltype(viaStd), lbnl::OptionalExt<int>>);
+    EXPECT_EQ(*viaStd, 4);
+
+    EXPECT_EQ(empty.or_else([] { return 1.0; }), 1.0);
+    EXPECT_EQ(present.or_else([] { return 1.0; }), 4.0);
+    EXPECT_EQ(empty.value_or(-1.0), -1.0);
+
+    int fallbacks = 0;
+    (void)empty.or_else([&fallbacks] { ++fallbacks; });
+    (void)present.or_else([&fallbacks] { ++fallbacks; });
+    EXPECT_EQ(fallbacks, 1);
+}
+
+TEST(CompactOptional, ConvertsToAndFromStdOptional)
+{
+    const std::optional<double> some(1.5);
+    const std::optional<double> none;
+
+    EXPECT_EQ(lbnl::compact(some), 1.5);
+    EXPECT_FALSE(lbnl::compact(none).has_value());
+    EXPECT_EQ(lbnl::compact(some).to_optional(), some);
+    EXPECT_EQ(lbnl::compact(none).to_optional(), std::nullopt);
+}
+
+TEST(CompactOptional, AverageSkipsEmptyEntries)
+{
+    const std::vector<CompactDouble> series{1.0, CompactDouble(), 2.0, std::nullopt, 6.0};
+    auto avg = lbnl::average_optional(series);
+    ASSERT_TRUE(avg.has_value());
+    EXPECT_DOUBLE_EQ(*avg, 3.0);
+
+    const std::vector<CompactDouble> allEmpty(4);
+    EXPECT_FALSE(lbnl::average_optional(allEmpty).has_value());
+
+    const std::vector<CompactIndex> indices{2, -1, 4};
+    EXPECT_EQ(lbnl::average_optional(indices), 3);
+}
@@ -1,4 +1,9 @@
+#include <array>
+#include <cstdint>
 #include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <lbnl/enum_index_mapper.hxx>
@@ -75,3 +80,207 @@ TEST(EnumIndexMapper_Generic, DataExposure)
     EXPECT_EQ(arr[0].first, 1);
     EXPECT_EQ(arr[0].second, SV::Top);
 }
+
+// ---- Lookup tables ----
+
+static_assert(kSVMap.dense_indices() && kSVMap.dense_enums());
+
+// Database codes that are far apart fall back to the sorted table
+enum class Material : std::int16_t
+{
+    Glass = -20,
+    Gas = 0,
+    Frame = 7,
+    Shade = 300
+};
+
+inline constexpr auto kMaterialMap = lbnl::make_enum_index_mapper<Material>({
+  {5000, Material::Shade},
+  {12, Material::Glass},
+  {-40, Material::Frame},
+  {700, Material::Gas},
+});
+
+static_assert(!kMaterialMap.dense_indices() && !kMaterialMap.dense_enums());
+
+// Each direction stores only the table it uses: the dense and sorted tables share storage
+static_assert(sizeof(lbnl::detail::KeyPositionTable<int, 64>)
+              <= 2 * 64 * sizeof(std::uint32_t) + 2 * sizeof(int));
+static_assert(std::is_copy_assignable_v<std::remove_const_t<decltype(kMaterialMap)>>);
+static_assert(*kMaterialMap.to_enum(-40) == Material::Frame);
+static_assert(*kMaterialMap.to_index(Material::Glass) == 12);
+
+TEST(EnumIndexMapper_Generic, SparseCodes)
+{
+    EXPECT_EQ(kMaterialMap.to_enum(5000), Material::Shade);
+    EXPECT_EQ(kMaterialMap.to_enum(700), Material::Gas);
+    EXPECT_FALSE(kMaterialMap.to_enum(13).has_value());
+    EXPECT_FALSE(kMaterialMap.to_enum(-41).has_value());
+    EXPECT_FALSE(kMaterialMap.to_enum(100000).has_value());
+
+    EXPECT_EQ(kMaterialMap.to_index(Material::Shade), 5000);
+    EXPECT_EQ(kMaterialMap.to_index(Material::Gas), 700);
+    EXPECT_FALSE(kMaterialMap.to_index(static_cast<Material>(1)).has_value());
+}
+
+// Large enum with codes offset from its underlying values, as read from a database table
+enum class Code : std::uint16_t
+{
+};
+
+inline constexpr std::size_t kCodeCount = 300;
+
+inline constexpr auto kCodeMap = [] {
+    std::array<std::pair<int, Code>, kCodeCount> pairs{};
+    for(std::size_t i = 0; i < kCodeCount; ++i)
+    {
+        // Indices have gaps (every third code unused), enums are contiguous from 1000
+        pairs[i] = {static_cast<int>(i + i / 2), static_cast<Code>(1000 + i)};
+    }
+    return lbnl::make_enum_index_mapper(pairs);
+}();
+
+static_assert(kCodeMap.dense_indices() && kCodeMap.dense_enums());
+
+TEST(EnumIndexMapper_Generic, LargeNearlyContiguousMapping)
+{
+    for(std::size_t i = 0; i < kCodeCount; ++i)
+    {
+        const int index = static_cast<int>(i + i / 2);
+        EXPECT_EQ(kCodeMap.to_enum(index), static_cast<Code>(1000 + i));
+        EXPECT_EQ(kCodeMap.to_index(static_cast<Code>(1000 + i)), index);
+    }
+    EXPECT_FALSE(kCodeMap.to_enum(2).has_value());   // gap
+    EXPECT_FALSE(kCodeMap.to_enum(-1).has_value());
+    EXPECT_FALSE(kCodeMap.to_index(static_cast<Code>(999)).has_value());
+    EXPECT_FALSE(kCodeMap.to_index(static_cast<Code>(1000 + kCodeCount)).has_value());
+}
+
+// Indices {0, 1, 2, 7}: dense, and index 7 occupies the last slot of the 2N-entry table
+inline constexpr auto kLastSlotMap = lbnl::make_enum_index_mapper<SV>({
+  {0, SV::Top},
+  {1, SV::Left},
+  {2, SV::Right},
+  {7, SV::Bottom},
+});
+
+static_assert(kLastSlotMap.dense_indices());
+static_assert(!kLastSlotMap.to_enum(100).has_value());
+
+TEST(EnumIndexMapper_Generic, KeysOutsideAFullDenseTableAreMissing)
+{
+    EXPECT_EQ(kLastSlotMap.to_enum(7), SV::Bottom);
+    for(int index : {-100, -1, 3, 6, 8, 100, 1 << 30})
+    {
+        EXPECT_FALSE(kLastSlotMap.to_enum(index).has_value()) << index;
+    }
+
+    const std::vector<int> codes{7, 8, -1, 100, 0};
+    std::vector<SV> out(codes.size());
+    const auto result = kLastSlotMap.to_enums(codes, out, SV::Left);
+    EXPECT_EQ(result.invalid, 3u);
+    EXPECT_EQ(out, (std::vector<SV>{SV::Bottom, SV::Left, SV::Left, SV::Left, SV::Top}));
+}
+
+TEST(EnumIndexMapper_Generic, DuplicatesAreRejected)
+{
+    // In a constexpr mapper these are compile errors; at run time they throw.
+    EXPECT_THROW((void)lbnl::make_enum_index_mapper<SV>({{1, SV::Top}, {1, SV::Left}}), std::invalid_argument);
+    EXPECT_THROW((void)lbnl::make_enum_index_mapper<SV>({{1, SV::Top}, {2, SV::Top}}), std::invalid_argument);
+    EXPECT_THROW((void)lbnl::make_enum_index_mapper<Material>({{1, Material::Glass}, {9000, Material::Glass}}),
+                 std::invalid_argument);
+}
+
+// ---- Bulk conversion ----
+
+TEST(EnumIndexMapper_Bulk, ToEnumsDenseAllValid)
+{
+    const std::vector<int> codes{4, 1, 3, 2, 2, 1};
+    std::vector<SV> out(codes.size());
+
+    const auto result = kSVMap.to_enums(codes, out, SV::Top);
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(result.first_invalid, lbnl::BulkConversion::npos);
+    EXPECT_EQ(out, (std::vector<SV>{SV::Bottom, SV::Top, SV::Right, SV::Left, SV::Left, SV::Top}));
+}
+
+TEST(EnumIndexMapper_Bulk, ToEnumsReportsInvalidCodesAndMask)
+{
+    // 130 codes span three mask words; codes 0 and 9 are unmapped
+    std::vector<int> codes(130, 2);
+    codes[5] = 0;
+    codes[70] = 9;
+    codes[129] = -3;
+    std::vector<SV> out(codes.size());
+    std::vector<std::uint64_t> valid(3);
+
+    const auto result = kSVMap.to_enums(codes, out, SV::Bottom, valid);
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(result.invalid, 3u);
+    EXPECT_EQ(result.first_invalid, 5u);
+
+    EXPECT_EQ(out[4], SV::Left);
+    EXPECT_EQ(out[5], SV::Bottom);
+    EXPECT_EQ(out[70], SV::Bottom);
+    EXPECT_EQ(valid[0], ~(std::uint64_t{1} << 5));
+    EXPECT_EQ(valid[1], ~(std::uint64_t{1} << 6));
+    EXPECT_EQ(valid[2], std::uint64_t{0b01});
+}
+
+TEST(EnumIndexMapper_Bulk, SparseTableRoundTrip)
+{
+    const std::vector<int> codes{700, 12, 13, 5000, -40};
+    std::vector<Material> enums(codes.size());
+
+    const auto forward = kMaterialMap.to_enums(codes, enums, Material::Gas);
+    EXPECT_EQ(forward.invalid, 1u);
+    EXPECT_EQ(forward.first_invalid, 2u);
+    EXPECT_EQ(enums[3], Material::Shade);
+
+    std::vector<int> back(enums.size());
+    const auto reverse = kMaterialMap.to_indices(enums, back, -1);
+    EXPECT_TRUE(reverse.ok());
+    EXPECT_EQ(back, (std::vector<int>{700, 12, 700, 5000, -40}));
+}
+
+TEST(EnumIndexMapper_Bulk, ToIndicesLargeMapping)
+{
+    std::vector<Code> enums;
+    for(std::size_t i = 0; i < kCodeCount; ++i)
+    {
+        enums.push_back(static_cast<Code>(1000 + i));
+    }
+    enums.push_back(static_cast<Code>(5));
+    std::vector<int> out(enums.size());
+    std::vector<std::uint64_t> valid((enums.size() + 63) / 64);
+
+    const auto result = kCodeMap.to_indices(enums, out, -1, valid);
+    EXPECT_EQ(result.invalid, 1u);
+    EXPECT_EQ(result.first_invalid, kCodeCount);
+    EXPECT_EQ(out[kCodeCount], -1);
+    for(std::size_t i = 0; i < kCodeCount; ++i)
+    {
+        EXPECT_EQ(out[i], static_cast<int>(i + i / 2));
+    }
+}
+
+TEST(EnumIndexMapper_Bulk, SpanSizesAreChecked)
+{
+    const std::vector<int> codes(65, 1);
+    std::vector<SV> shortOut(64);
+    std::vector<SV> out(65);
+    std::vector<std::uint64_t> shortMask(1);
+
+    EXPECT_THROW((void)kSVMap.to_enums(codes, shortOut, SV::Top), std::invalid_argument);
+    EXPECT_THROW((void)kSVMap.to_enums(codes, out, SV::Top, shortMask), std::invalid_argument);
+}
+
+TEST(EnumIndexMapper_Bulk, Constexpr)
+{
+    constexpr auto invalid = [] {
+        std::array<int, 3> codes{1, 7, 4};
+        std::array<SV, 3> out{};
+        return kSVMap.to_enums(codes, out, SV::Top).invalid;
+    }();
+    static_assert(invalid == 1);
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <lbnl/enum_map.hxx>
+#include <lbnl/map_utils.hxx>
+
+enum class Side : std::uint8_t
+{
+    Front,
+    Back,
+    Left,
+    Right,
+    Top,
+    Bottom
+};
+
+using SideSlots = lbnl::EnumRange<Side::Front, Side::Bottom>;
+using SideSet = lbnl::EnumSet<Side, SideSlots>;
+
+// Sparse values, numbered through a mapper
+enum class Gas : int
+{
+    Air = 1,
+    Argon = 18,
+    Krypton = 36,
+    Xenon = 54
+};
+
+inline constexpr auto kGasMapper = lbnl::make_enum_index_mapper<Gas>({
+  {10, Gas::Air},
+  {20, Gas::Argon},
+  {30, Gas::Krypton},
+  {40, Gas::Xenon},
+});
+
+using GasSlots = lbnl::MappedEnumSlots<kGasMapper>;
+
+// Wider than one 64-bit word
+enum class Channel : int
+{
+    First = -10,
+    Last = 89
+};
+
+using ChannelSlots = lbnl::EnumRange<Channel::First, Channel::Last>;
+
+static_assert(SideSlots::size == 6);
+static_assert(SideSlots::slot(Side::Left) == 2);
+static_assert(SideSlots::value(5) == Side::Bottom);
+static_assert(GasSlots::size == 4);
+static_assert(GasSlots::slot(Gas::Krypton) == 2);
+static_assert(GasSlots::slot(static_cast<Gas>(2)) == GasSlots::size);
+static_assert(ChannelSlots::size == 100);
+static_assert(ChannelSlots::slot(static_cast<Channel>(-11)) == ChannelSlots::size);
+
+static_assert(lbnl::AssociativeContainer<lbnl::EnumMap<Side, double, SideSlots>>);
+static_assert(lbnl::AssociativeContainer<lbnl::EnumMap<Gas, std::string, GasSlots>>);
+
+// EnumSet is usable in constant expressions
+static_assert(SideSet{Side::Front, Side::Top}.size() == 2);
+static_assert((SideSet{Side::Front} | SideSet{Side::Back}).contains(Side::Back));
+static_assert(SideSet::all().size() == 6);
+
+TEST(EnumSet, InsertEraseContains)
+{
+    SideSet set;
+    EXPECT_TRUE(set.empty());
+    EXPECT_TRUE(set.insert(Side::Top));
+    EXPECT_FALSE(set.insert(Side::Top));
+    EXPECT_TRUE(set.insert(Side::Front));
+    EXPECT_EQ(set.size(), 2u);
+    EXPECT_TRUE(set.contains(Side::Top));
+    EXPECT_FALSE(set.contains(Side::Left));
+    EXPECT_EQ(set.erase(Side::Top), 1u);
+    EXPECT_EQ(set.erase(Side::Top), 0u);
+    EXPECT_EQ(set.size(), 1u);
+}
+
+TEST(EnumSet, IteratesInSlotOrder)
+{
+    const SideSet set{Side::Bottom, Side::Back, Side::Left};
+    const std::vector<Side> values(set.begin(), set.end());
+    EXPECT_EQ(values, (std::vector<Side>{Side::Back, Side::Left, Side::Bottom}));
+}
+
+TEST(EnumSet, SetOperations)
+{
+    const SideSet a{Side::Front, Side::Back, Side::Left};
+    const SideSet b{Side::Left, Side::Right};
+
+    EXPECT_EQ(a | b, (SideSet{Side::Front, Side::Back, Side::Left, Side::Right}));
+    EXPECT_EQ(a & b, SideSet{Side::Left});
+    EXPECT_EQ(a - b, (SideSet{Side::Front, Side::Back}));
+    EXPECT_EQ(a ^ b, (SideSet{Side::Front, Side::Back, Side::Right}));
+    EXPECT_EQ(a.complement(), (SideSet{Side::Right, Side::Top, Side::Bottom}));
+    EXPECT_TRUE((a & b).is_subset_of(a));
+    EXPECT_FALSE(a.is_subset_of(b));
+    EXPECT_TRUE(a.intersects(b));
+    EXPECT_FALSE((a - b).intersects(b));
+}
+
+TEST(EnumSet, ValueWithoutSlotThrowsOnInsert)
+{
+    lbnl::EnumSet<Gas, GasSlots> set;
+    EXPECT_FALSE(set.contains(static_cast<Gas>(2)));
+    EXPECT_THROW(set.insert(static_cast<Gas>(2)), std::out_of_range);
+}
+
+TEST(EnumSet, MultiWord)
+{
+    using ChannelSet = lbnl::EnumSet<Channel, ChannelSlots>;
+    ChannelSet set;
+    for(int value = -10; value < 90; value += 7)
+        set.insert(static_cast<Channel>(value));
+
+    std::vector<int> values;
+    for(auto channel : set)
+        values.push_back(static_cast<int>(channel));
+
+    std::vector<int> expected;
+    for(int value = -10; value < 90; value += 7)
+        expected.push_back(value);
+    EXPECT_EQ(values, expected);
+
+    EXPECT_EQ(ChannelSet::all().size(), 100u);
+    EXPECT_EQ(set.complement().size(), 100u - expected.size());
+    EXPECT_EQ(set | set.complement(), ChannelSet::all());
+}
+
+TEST(EnumMap, InsertFindErase)
+{
+    lbnl::EnumMap<Side, double, SideSlots> loads;
+    EXPECT_TRUE(loads.empty());
+
+    loads[Side::Top] = 1.5;
+    EXPECT_TRUE(loads.insert({Side::Front, 2.0}).second);
+    EXPECT_FALSE(loads.insert({Side::Front, 3.0}).second);
+    EXPECT_EQ(loads.at(Side::Front), 2.0);
+
+    loads.insert_or_assign(Side::Front, 3.0);
+    EXPECT_EQ(loads.at(Side::Front), 3.0);
+    EXPECT_EQ(loads.size(), 2u);
+
+    auto it = loads.find(Side::Top);
+    ASSERT_NE(it, loads.end());
+    EXPECT_EQ(it->first, Side::Top);
+    EXPECT_EQ(it->second, 1.5);
+    EXPECT_EQ(loads.find(Side::Left), loads.end());
+    EXPECT_THROW((void)loads.at(Side::Left), std::out_of_range);
+
+    EXPECT_EQ(loads.erase(Side::Top), 1u);
+    EXPECT_FALSE(loads.contains(Side::Top));
+    EXPECT_EQ(loads.size(), 1u);
+}
+
+TEST(EnumMap, IteratesPresentEntriesInSlotOrder)
+{
+    lbnl::EnumMap<Side, int, SideSlots> map{{Side::Bottom, 6}, {Side::Front, 1}, {Side::Right, 4}};
+
+    std::vector<std::pair<Side, int>> entries;
+    for(const auto & [side, value] : map)
+        entries.emplace_back(side, value);
+    EXPECT_EQ(entries,
+              (std::vector<std::pair<Side, int>>{{Side::Front, 1}, {Side::Right, 4}, {Side::Bottom, 6}}));
+
+    for(auto & [side, value] : map)
+        value *= 10;
+    EXPECT_EQ(map.at(Side::Right), 40);
+
+    EXPECT_EQ(map.keys(), (SideSet{Side::Front, Side::Right, Side::Bottom}));
+}
+
+TEST(EnumMap, WorksWithMapUtils)
+{
+    const lbnl::EnumMap<Gas, std::string, GasSlots> names{{Gas::Xenon, "Xe"}, {Gas::Air, "air"}};
+
+    EXPECT_EQ(lbnl::map_lookup_by_key(names, Gas::Xenon), std::optional<std::string>{"Xe"});
+    EXPECT_EQ(lbnl::map_lookup_by_key(names, Gas::Argon), std::nullopt);
+    EXPECT_EQ(lbnl::map_lookup_by_value(names, std::string{"air"}), std::optional<Gas>{Gas::Air});
+    EXPECT_EQ(lbnl::map_keys(names), (std::vector<Gas>{Gas::Air, Gas::Xenon}));
+    EXPECT_EQ(lbnl::map_values(names), (std::vector<std::string>{"air", "Xe"}));
+}
+
+TEST(EnumMap, ManagesElementLifetimes)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        lbnl::EnumMap<Side, std::shared_ptr<int>, SideSlots> map;
+        map.emplace(Side::Left, counter);
+        map.emplace(Side::Right, counter);
+        EXPECT_EQ(counter.use_count(), 3);
+
+        auto copy = map;
+        EXPECT_EQ(counter.use_count(), 5);
+        EXPECT_EQ(copy, map);
+
+        auto moved = std::move(copy);
+        EXPECT_EQ(moved.size(), 2u);
+
+        map.erase(map.find(Side::Left));
+        EXPECT_EQ(map.size(), 1u);
+        map.clear();
+        EXPECT_TRUE(map.empty());
+        EXPECT_EQ(counter.use_count(), 3);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(EnumMap, KeyWithoutSlotThrowsOnInsert)
+{
+    lbnl::EnumMap<Gas, int, GasSlots> map;
+    EXPECT_THROW(map[static_cast<Gas>(2)], std::out_of_range);
+    EXPECT_EQ(map.find(static_cast<Gas>(2)), map.end());
+}
@@ -0,0 +1,165 @@
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <lbnl/enum_string_mapper.hxx>
+
+enum class Month : int
+{
+    January = 1,
+    February,
+    March,
+    April,
+    May,
+    June,
+    July,
+    August,
+    September,
+    October,
+    November,
+    December
+};
+
+inline constexpr auto kMonthNames = lbnl::make_enum_string_mapper<Month>({
+  {"January", Month::January},
+  {"February", Month::February},
+  {"March", Month::March},
+  {"April", Month::April},
+  {"May", Month::May},
+  {"June", Month::June},
+  {"July", Month::July},
+  {"August", Month::August},
+  {"September", Month::September},
+  {"October", Month::October},
+  {"November", Month::November},
+  {"December", Month::December},
+});
+
+inline constexpr auto kMonthNamesNoCase =
+  lbnl::make_enum_string_mapper<Month, lbnl::EnumStringCase::Insensitive>(kMonthNames.data());
+
+// ---- Compile-time checks ----
+static_assert(*kMonthNames.from_string("March") == Month::March);
+static_assert(!kMonthNames.from_string("march").has_value());
+static_assert(*kMonthNamesNoCase.from_string("mArCh") == Month::March);
+static_assert(kMonthNames.to_string(Month::June) == "June");
+
+TEST(EnumStringMapper, FromStringEveryName)
+{
+    for(const auto & [name, month] : kMonthNames.data())
+    {
+        EXPECT_EQ(kMonthNames.from_string(name), month) << name;
+    }
+}
+
+TEST(EnumStringMapper, FromStringUnknown)
+{
+    EXPECT_FALSE(kMonthNames.from_string("").has_value());
+    EXPECT_FALSE(kMonthNames.from_string("Jan").has_value());
+    EXPECT_FALSE(kMonthNames.from_string("Januaryy").has_value());
+    EXPECT_FALSE(kMonthNames.from_string("JANUARY").has_value());
+    EXPECT_EQ(kMonthNames.from_string_or("Smarch", Month::January), Month::January);
+}
+
+TEST(EnumStringMapper, CaseInsensitive)
+{
+    EXPECT_EQ(kMonthNamesNoCase.from_string("JANUARY"), Month::January);
+    EXPECT_EQ(kMonthNamesNoCase.from_string("december"), Month::December);
+    EXPECT_FALSE(kMonthNamesNoCase.from_string("decembe").has_value());
+
+    // to_string returns the stored spelling
+    EXPECT_EQ(kMonthNamesNoCase.to_string(Month::December), "December");
+}
+
+TEST(EnumStringMapper, ToString)
+{
+    EXPECT_EQ(kMonthNames.to_string(Month::January), "January");
+    EXPECT_EQ(kMonthNames.to_string(Month::December), "December");
+    EXPECT_TRUE(kMonthNames.to_string(static_cast<Month>(42)).empty());
+}
+
+TEST(EnumStringMapper, BatchParsing)
+{
+    const std::vector<std::string_view> tokens{"May", "June", "Juny", "July", "may"};
+    std::vector<Month> out(tokens.size());
+    std::vector<std::uint64_t> valid(1);
+
+    const auto result = kMonthNames.from_strings(tokens, out, Month::January, valid);
+    EXPECT_EQ(result.invalid, 2u);
+    EXPECT_EQ(result.first_invalid, 2u);
+    const std::vector<Month> expected{
+      Month::May, Month::June, Month::January, Month::July, Month::January};
+    EXPECT_EQ(out, expected);
+    EXPECT_EQ(valid[0], 0b01011u);
+
+    const auto noCase = kMonthNamesNoCase.from_strings(tokens, out, Month::January);
+    EXPECT_EQ(noCase.invalid, 1u);
+    EXPECT_EQ(out[4], Month::May);
+}
+
+TEST(EnumStringMapper, LargeTable)
+{
+    // Many similar names, as produced by generated configuration keywords
+    enum class Zone : std::uint16_t
+    {
+    };
+    static constexpr std::size_t count = 100;
+    static constexpr auto names = [] {
+        std::array<std::array<char, 8>, count> result{};
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const auto tens = static_cast<char>('0' + i / 10);
+            const auto ones = static_cast<char>('0' + i % 10);
+            result[i] = {'Z', 'o', 'n', 'e', '_', tens, ones};
+        }
+        return result;
+    }();
+    constexpr auto mapper = [] {
+        std::array<std::pair<std::string_view, Zone>, count> pairs{};
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            pairs[i] = {std::string_view(names[i].data(), 7), static_cast<Zone>(i * 3)};
+        }
+        return lbnl::make_enum_string_mapper(pairs);
+    }();
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const std::string_view name(names[i].data(), 7);
+        EXPECT_EQ(mapper.from_string(name), static_cast<Zone>(i * 3));
+        EXPECT_EQ(mapper.to_string(static_cast<Zone>(i * 3)), name);
+    }
+    EXPECT_FALSE(mapper.from_string("Zone_1").has_value());
+    EXPECT_FALSE(mapper.from_string("Zone_100").has_value());
+}
+
+TEST(EnumStringMapper, InvalidTablesAreRejected)
+{
+    using lbnl::EnumStringCase;
+
+    // In a constexpr mapper these are compile errors; at run time they throw.
+    auto duplicateName = [] {
+        return lbnl::make_enum_string_mapper<Month>({{"May", Month::May}, {"May", Month::June}});
+    };
+    auto duplicateEnum = [] {
+        return lbnl::make_enum_string_mapper<Month>({{"May", Month::May}, {"Mai", Month::May}});
+    };
+    auto emptyName = [] { return lbnl::make_enum_string_mapper<Month>({{"", Month::May}}); };
+    auto duplicateIgnoringCase = [] {
+        return lbnl::make_enum_string_mapper<Month, EnumStringCase::Insensitive>(
+          {{"May", Month::May}, {"MAY", Month::June}});
+    };
+
+    EXPECT_THROW((void)duplicateName(), std::invalid_argument);
+    EXPECT_THROW((void)duplicateEnum(), std::invalid_argument);
+    EXPECT_THROW((void)emptyName(), std::invalid_argument);
+    EXPECT_THROW((void)duplicateIgnoringCase(), std::invalid_argument);
+
+    // Different spellings are distinct names when matching is case sensitive
+    const auto sensitive =
+      lbnl::make_enum_string_mapper<Month>({{"May", Month::May}, {"MAY", Month::June}});
+    EXPECT_EQ(sensitive.from_string("MAY"), Month::June);
+}
@@ -0,0 +1,164 @@
+// error.unit.cxx
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <lbnl/error.hxx>
+#include <lbnl/expected.hxx>
+
+namespace
+{
+    enum class Parse
+    {
+        Ok,
+        BadValue,
+        MissingColumn
+    };
+
+    static_assert(sizeof(lbnl::Error) <= 48);
+    static_assert(std::is_nothrow_move_constructible_v<lbnl::Error>);
+    static_assert(std::is_nothrow_copy_constructible_v<lbnl::Error>);
+
+    using Result = lbnl::ExpectedExt<double, lbnl::Error>;
+
+    Result parseCell(std::string_view cell, int row)
+    {
+        if(cell.empty())
+        {
+            return lbnl::Unexpected(lbnl::Error(Parse::MissingColumn, "row {}: no value", row));
+        }
+        if(cell == "x")
+        {
+            return lbnl::Unexpected(
+              lbnl::Error(Parse::BadValue, "row {}: bad value '{}'", row, cell));
+        }
+        return std::stod(std::string(cell));
+    }
+}   // namespace
+
+TEST(Error, FormatsOnlyWhenAsked)
+{
+    const lbnl::Error error(Parse::MissingColumn, "row {} column {}", 12, 3u);
+    EXPECT_EQ(error.code_as<Parse>(), Parse::MissingColumn);
+    EXPECT_EQ(error.code(), 2);
+    EXPECT_EQ(error.format(), "row {} column {}");
+    EXPECT_EQ(error.message(), "row 12 column 3");
+    EXPECT_EQ(error.context_depth(), 0u);
+
+    EXPECT_EQ(lbnl::Error().message(), "");
+    EXPECT_EQ(lbnl::Error(7, "plain").message(), "plain");
+}
+
+TEST(Error, ArgumentKinds)
+{
+    EXPECT_EQ(lbnl::Error(1, "{} {}", -42, 2.5).message(), "-42 2.5");
+    EXPECT_EQ(lbnl::Error(1, "{} {}", true, 'c').message(), "true c");
+    EXPECT_EQ(lbnl::Error(1, "{}", Parse::BadValue).message(), "1");
+    EXPECT_EQ(lbnl::Error(1, "{{{}}} {{}}", 5).message(), "{5} {}");
+
+    // Text and more than inline_arguments values spill to the arena
+    const std::string name = "pressure";
+    const char * missing = nullptr;
+    const lbnl::Error spilled(1, "{}={} [{}, {}] {}'{}'", name, 1.5, 0, 10, "unit", missing);
+    EXPECT_EQ(spilled.message(), "pressure=1.5 [0, 10] unit''");
+    EXPECT_EQ(spilled.format(), "{}={} [{}, {}] {}'{}'");
+
+    const std::string large(100000, 'z');
+    EXPECT_EQ(lbnl::Error(1, "{}", large).message(), large);
+}
+
+TEST(Error, TextArgumentsAreCopied)
+{
+    std::string cell = "abc";
+    const lbnl::Error error(1, "bad '{}'", cell);
+    cell = "changed";
+    EXPECT_EQ(error.message(), "bad 'abc'");
+}
+
+TEST(Error, ContextThroughTransformError)
+{
+    const std::string path = "data.csv";
+
+    const auto bad = parseCell("x", 12).transform_error(lbnl::with_context("reading {}", path));
+    ASSERT_FALSE(bad.has_value());
+    EXPECT_EQ(bad.error().message(), "reading data.csv: row 12: bad value 'x'");
+    EXPECT_EQ(bad.error().code_as<Parse>(), Parse::BadValue);
+    EXPECT_EQ(bad.error().context_depth(), 1u);
+    EXPECT_EQ(bad.error().format(), "row {}: bad value '{}'");
+
+    const auto missing = parseCell("", 4)
+                           .transform_error(lbnl::with_context("column {}", 2))
+                           .transform_error(lbnl::with_context("reading {}", path));
+    EXPECT_EQ(missing.error().message(), "reading data.csv: column 2: row 4: no value");
+    EXPECT_EQ(missing.error().context_depth(), 2u);
+
+    const auto good = parseCell("1.5", 1).transform_error(lbnl::with_context("reading {}", path));
+    EXPECT_EQ(good.value(), 1.5);
+}
+
+TEST(Error, CopiesShareFramesAndStayIndependent)
+{
+    const lbnl::Error base(Parse::BadValue, "row {}", 1);
+    const auto outer = base.with_context("file {}", "a.csv");
+    auto copy = outer;
+    const auto deeper = std::move(copy).with_context("batch {}", 3);
+
+    EXPECT_EQ(base.message(), "row 1");
+    EXPECT_EQ(outer.message(), "file a.csv: row 1");
+    EXPECT_EQ(deeper.message(), "batch 3: file a.csv: row 1");
+
+    lbnl::Error assigned;
+    assigned = deeper;
+    assigned = assigned;
+    EXPECT_EQ(assigned.message(), deeper.message());
+
+    std::string buffer = "> ";
+    outer.append_message(buffer);
+    EXPECT_EQ(buffer, "> file a.csv: row 1");
+}
+
+TEST(Error, OutlivesTheThreadThatBuiltIt)
+{
+    // Enough errors to fill several arena blocks, built on a thread that exits before use
+    std::vector<lbnl::Error> errors;
+    std::thread producer([&errors] {
+        for(int row = 0; row < 5000; ++row)
+        {
+            const std::string cell = "cell" + std::to_string(row);
+            errors.push_back(lbnl::Error(Parse::BadValue, "bad '{}'", cell)
+                               .with_context("row {}", row)
+                               .with_context("sheet {}", "s"));
+        }
+    });
+    producer.join();
+
+    ASSERT_EQ(errors.size(), 5000u);
+    EXPECT_EQ(errors[0].message(), "sheet s: row 0: bad 'cell0'");
+    EXPECT_EQ(errors[4999].message(), "sheet s: row 4999: bad 'cell4999'");
+
+    errors.erase(errors.begin(), errors.begin() + 2500);
+    EXPECT_EQ(errors.front().message(), "sheet s: row 2500: bad 'cell2500'");
+}
+
+TEST(Error, ContextAddedOnAnotherThreadDoesNotLeakBlocks)
+{
+    // The error starts on this thread, gains a frame on another one, then another frame here
+    // while its first block is still this thread's current arena block
+    auto roundTrip = [] {
+        auto error = lbnl::Error(Parse::BadValue, "bad '{}'", std::string("cell"));
+        std::thread worker([&error] { error = std::move(error).with_context("sheet {}", "s"); });
+        worker.join();
+        return std::move(error).with_context("file {}", "a.csv").message();
+    };
+
+    EXPECT_EQ(roundTrip(), "file a.csv: sheet s: bad 'cell'");
+    const auto blocks = lbnl::detail::error_block_count();
+    for(int iteration = 0; iteration < 200; ++iteration)
+    {
+        (void)roundTrip();
+    }
+    EXPECT_EQ(lbnl::detail::error_block_count(), blocks);
+}
@@ -0,0 +1,133 @@
+// expected.layout.unit.cxx
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <lbnl/expected.hxx>
+
+namespace
+{
+    enum class ErrorCode : int
+    {
+        NotFound = 1,
+        OutOfRange
+    };
+
+    // What a hand-written result struct would look like
+    struct PlainResult
+    {
+        double value;
+        ErrorCode code;
+        bool ok;
+    };
+
+    using SmallResult = lbnl::ExpectedExt<double, ErrorCode>;
+
+    // Trivial members keep the whole result trivial, so it is passed and returned in registers
+    static_assert(std::is_trivially_copyable_v<SmallResult>);
+    static_assert(std::is_trivially_destructible_v<SmallResult>);
+    static_assert(std::is_trivially_copy_constructible_v<SmallResult>);
+    static_assert(std::is_trivially_move_assignable_v<SmallResult>);
+    static_assert(sizeof(SmallResult) <= sizeof(PlainResult));
+    static_assert(sizeof(lbnl::ExpectedExt<int, ErrorCode>) == 2 * sizeof(int));
+
+    // Non-trivial members still work, without making the result trivial
+    using StringResult = lbnl::ExpectedExt<std::string, ErrorCode>;
+    static_assert(!std::is_trivially_copyable_v<StringResult>);
+    static_assert(std::is_copy_constructible_v<StringResult>);
+    static_assert(std::is_nothrow_move_constructible_v<StringResult>);
+
+    // Usable in constant expressions
+    constexpr SmallResult half(double x)
+    {
+        if(x < 0)
+        {
+            return lbnl::Unexpected(ErrorCode::OutOfRange);
+        }
+        return x / 2;
+    }
+
+    static_assert(half(4.0).value() == 2.0);
+    static_assert(half(-1.0).error() == ErrorCode::OutOfRange);
+
+    // Copies and moves throw while `armed` is set; the move is not noexcept either way.
+    struct Fragile
+    {
+        static inline bool armed = false;
+        int id;
+
+        explicit Fragile(int i) : id(i)
+        {}
+
+        Fragile(const Fragile & other) : id(other.id)
+        {
+            if(armed)
+            {
+                throw std::runtime_error("copy failed");
+            }
+        }
+
+        Fragile(Fragile && other) : Fragile(static_cast<const Fragile &>(other))
+        {}
+
+        Fragile & operator=(const Fragile &) = default;
+    };
+}   // namespace
+
+TEST(ExpectedExt_Layout, CheckedAccessThrows)
+{
+    SmallResult ok(1.5);
+    SmallResult err(lbnl::Unexpected(ErrorCode::NotFound));
+
+    EXPECT_THROW((void)ok.error(), lbnl::BadExpectedAccess);
+    EXPECT_THROW((void)err.value(), lbnl::BadExpectedAccess);
+    EXPECT_THROW((void)*err, lbnl::BadExpectedAccess);
+    EXPECT_THROW((void)StringResult(lbnl::Unexpected(ErrorCode::NotFound))->size(),
+                 lbnl::BadExpectedAccess);
+    EXPECT_EQ(*ok, 1.5);
+
+    // Handlers written when ExpectedExt was built on std::variant still catch it
+    EXPECT_THROW((void)err.value(), std::bad_variant_access);
+    EXPECT_EQ(ok.value_unchecked(), 1.5);
+    EXPECT_EQ(err.error_unchecked(), ErrorCode::NotFound);
+}
+
+TEST(ExpectedExt_Layout, AssignmentSwitchesActiveMember)
+{
+    StringResult a(std::string(100, 'x'));
+    const StringResult b(lbnl::Unexpected(ErrorCode::NotFound));
+
+    a = b;
+    ASSERT_FALSE(a.has_value());
+    EXPECT_EQ(a.error(), ErrorCode::NotFound);
+
+    a = StringResult(std::string("back"));
+    ASSERT_TRUE(a.has_value());
+    EXPECT_EQ(a.value(), "back");
+
+    StringResult c(std::move(a));
+    EXPECT_EQ(c.value(), "back");
+
+    std::vector<StringResult> results(3, b);
+    results[1] = c;
+    EXPECT_EQ(results[1].value(), "back");
+    EXPECT_FALSE(results[2].has_value());
+}
+
+TEST(ExpectedExt_Layout, FailedAssignmentKeepsPreviousState)
+{
+    using FragileResult = lbnl::ExpectedExt<Fragile, std::string>;
+
+    FragileResult target(lbnl::Unexpected(std::string("previous")));
+    const FragileResult source{Fragile{7}};
+
+    Fragile::armed = true;
+    EXPECT_THROW(target = source, std::runtime_error);
+    Fragile::armed = false;
+
+    ASSERT_FALSE(target.has_value());
+    EXPECT_EQ(target.error(), "previous");
+}
@@ -0,0 +1,109 @@
+// expected.move.unit.cxx
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <lbnl/expected.hxx>
+
+namespace
+{
+    // Payload that counts how often it is copied
+    struct Tracked
+    {
+        static inline int copies = 0;
+
+        std::vector<double> data;
+
+        explicit Tracked(std::vector<double> d) : data(std::move(d))
+        {}
+
+        Tracked(const Tracked & other) : data(other.data)
+        {
+            ++copies;
+        }
+
+        Tracked(Tracked &&) noexcept = default;
+
+        Tracked & operator=(const Tracked & other)
+        {
+            data = other.data;
+            ++copies;
+            return *this;
+        }
+
+        Tracked & operator=(Tracked &&) noexcept = default;
+    };
+
+    using Result = lbnl::ExpectedExt<Tracked, std::string>;
+
+    Result load()
+    {
+        return Tracked{{1.0, 2.0, 3.0}};
+    }
+
+    Result scale(Tracked && t)
+    {
+        for(auto & x : t.data)
+        {
+            x *= 2.0;
+        }
+        return std::move(t);
+    }
+}   // namespace
+
+TEST(ExpectedExt_Move, ChainOnTemporaryDoesNotCopy)
+{
+    Tracked::copies = 0;
+
+    auto result = load()
+                    .and_then(scale)
+                    .transform([](Tracked && t) {
+                        t.data.push_back(8.0);
+                        return std::move(t);
+                    })
+                    .transform_error([](std::string && e) { return e + "!"; })
+                    .or_else([](std::string && e) { return Result(lbnl::Unexpected(std::move(e))); });
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value().data, (std::vector<double>{2.0, 4.0, 6.0, 8.0}));
+    EXPECT_EQ(Tracked::copies, 0);
+
+    const auto moved = std::move(result).value();
+    EXPECT_EQ(moved.data.size(), 4u);
+    EXPECT_EQ(Tracked::copies, 0);
+}
+
+TEST(ExpectedExt_Move, ErrorIsMovedThroughChain)
+{
+    Result err(lbnl::Unexpected(std::string(64, 'e')));
+    auto result = std::move(err)
+                    .transform([](Tracked && t) { return t.data.size(); })
+                    .transform_error([](std::string && e) { return std::move(e); });
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), std::string(64, 'e'));
+}
+
+TEST(ExpectedExt_Move, LvalueChainCopiesAndKeepsSource)
+{
+    Tracked::copies = 0;
+
+    const Result source = load();
+    auto first = source.transform([](const Tracked & t) { return t.data.size(); });
+    auto second = source.or_else([](const std::string &) { return load(); });
+
+    EXPECT_EQ(first.value(), 3u);
+    EXPECT_EQ(second.value().data.size(), 3u);
+    EXPECT_EQ(source.value().data.size(), 3u);
+    EXPECT_EQ(Tracked::copies, 1);   // or_else on a value copies it into the result
+}
+
+TEST(ExpectedExt_Move, ValueOrMovesFromTemporary)
+{
+    Tracked::copies = 0;
+
+    auto value = load().value_or(Tracked{{}});
+    EXPECT_EQ(value.data.size(), 3u);
+    EXPECT_EQ(Tracked::copies, 0);
+}
@@ -0,0 +1,162 @@
+// expected.void.unit.cxx
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <lbnl/expected.hxx>
+
+namespace
+{
+    enum class ErrorCode : int
+    {
+        Locked = 1,
+        Missing
+    };
+
+    using Status = lbnl::ExpectedExt<void, std::string>;
+
+    static_assert(std::is_trivially_copyable_v<lbnl::ExpectedExt<void, ErrorCode>>);
+    static_assert(sizeof(lbnl::ExpectedExt<void, ErrorCode>) == 2 * sizeof(int));
+    static_assert(std::is_void_v<Status::value_type>);
+    static_assert(lbnl::is_expected_ext<Status>::value);
+
+    // Neither copyable nor movable: only in-place construction can store it
+    struct Pinned
+    {
+        std::vector<int> cells;
+        std::string name;
+
+        Pinned(std::size_t n, std::string nm) : cells(n, 0), name(std::move(nm))
+        {}
+
+        Pinned(const Pinned &) = delete;
+        Pinned & operator=(const Pinned &) = delete;
+    };
+
+    struct ThrowsOnNegative
+    {
+        int value;
+
+        explicit ThrowsOnNegative(int v) : value(v)
+        {
+            if(v < 0)
+            {
+                throw std::invalid_argument("negative");
+            }
+        }
+    };
+
+    Status save(bool locked)
+    {
+        if(locked)
+        {
+            return lbnl::Unexpected(std::string("locked"));
+        }
+        return {};
+    }
+}   // namespace
+
+TEST(ExpectedExt_Void, SuccessAndError)
+{
+    const Status ok = save(false);
+    const Status err = save(true);
+
+    EXPECT_TRUE(ok.has_value());
+    EXPECT_NO_THROW(ok.value());
+    EXPECT_THROW((void)ok.error(), lbnl::BadExpectedAccess);
+
+    ASSERT_FALSE(err.has_value());
+    EXPECT_EQ(err.error(), "locked");
+    EXPECT_THROW(err.value(), lbnl::BadExpectedAccess);
+    EXPECT_THROW(*err, lbnl::BadExpectedAccess);
+
+    EXPECT_EQ(ok, (lbnl::make_expected<void, std::string>()));
+    EXPECT_EQ(err, lbnl::Unexpected(std::string("locked")));
+    EXPECT_NE(ok, err);
+}
+
+TEST(ExpectedExt_Void, MonadicOperations)
+{
+    int calls = 0;
+    auto count = [&calls]() { ++calls; };
+
+    auto chained = save(false).and_then([] { return save(false); }).transform(count);
+    EXPECT_TRUE(chained.has_value());
+    EXPECT_EQ(calls, 1);
+
+    auto failed = save(true).transform(count).transform_error([](std::string && e) { return e.size(); });
+    static_assert(std::is_same_v<decltype(failed), lbnl::ExpectedExt<void, std::size_t>>);
+    ASSERT_FALSE(failed.has_value());
+    EXPECT_EQ(failed.error(), 6u);
+    EXPECT_EQ(calls, 1);
+
+    auto recovered = save(true).or_else([](const std::string &) { return Status(); });
+    EXPECT_TRUE(recovered.has_value());
+
+    auto produced = save(false).transform([] { return 42; });
+    static_assert(std::is_same_v<decltype(produced), lbnl::ExpectedExt<int, std::string>>);
+    EXPECT_EQ(produced.value(), 42);
+}
+
+TEST(ExpectedExt_Void, ValueTransformReturningVoid)
+{
+    std::vector<int> sink;
+    const lbnl::ExpectedExt<int, std::string> number(5);
+
+    auto status = number.transform([&sink](int x) { sink.push_back(x); });
+    static_assert(std::is_same_v<decltype(status), Status>);
+    EXPECT_TRUE(status.has_value());
+    EXPECT_EQ(sink, std::vector<int>{5});
+}
+
+TEST(ExpectedExt_Void, AssignAcrossStates)
+{
+    Status s;
+    s = save(true);
+    EXPECT_EQ(s.error(), "locked");
+    s.emplace();
+    EXPECT_TRUE(s.has_value());
+    s = Status(lbnl::unexpect, 3, 'x');
+    EXPECT_EQ(s.error(), "xxx");
+}
+
+TEST(ExpectedExt_InPlace, BuildsValueAndErrorInStorage)
+{
+    const lbnl::ExpectedExt<Pinned, std::string> grid(std::in_place, 16, "grid");
+    ASSERT_TRUE(grid.has_value());
+    EXPECT_EQ(grid->cells.size(), 16u);
+    EXPECT_EQ(grid->name, "grid");
+
+    const lbnl::ExpectedExt<Pinned, std::string> failed(lbnl::unexpect, 4, '?');
+    ASSERT_FALSE(failed.has_value());
+    EXPECT_EQ(failed.error(), "????");
+}
+
+TEST(ExpectedExt_InPlace, EmplaceReplacesContents)
+{
+    lbnl::ExpectedExt<std::vector<int>, ErrorCode> result(lbnl::Unexpected(ErrorCode::Missing));
+
+    auto & v = result.emplace(3, 7);
+    EXPECT_EQ(v, (std::vector<int>{7, 7, 7}));
+    ASSERT_TRUE(result.has_value());
+
+    result.emplace({1, 2});
+    EXPECT_EQ(result.value(), (std::vector<int>{1, 2}));
+}
+
+TEST(ExpectedExt_InPlace, FailedEmplaceKeepsPreviousContents)
+{
+    lbnl::ExpectedExt<ThrowsOnNegative, std::string> result(std::in_place, 1);
+
+    EXPECT_THROW(result.emplace(-1), std::invalid_argument);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->value, 1);
+
+    result = lbnl::Unexpected(std::string("err"));
+    EXPECT_THROW(result.emplace(-1), std::invalid_argument);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), "err");
+}
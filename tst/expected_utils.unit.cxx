@@ -0,0 +1,168 @@
+// expected_utils.unit.cxx
+#include <gtest/gtest.h>
+#include <atomic>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <lbnl/expected_utils.hxx>
+
+namespace
+{
+    using Result = lbnl::ExpectedExt<int, std::string>;
+
+    Result parse(int x)
+    {
+        if(x < 0)
+        {
+            return lbnl::Unexpected("negative: " + std::to_string(x));
+        }
+        return x * 10;
+    }
+}   // namespace
+
+TEST(ExpectedUtils_Collect, AllValues)
+{
+    const std::vector<Result> results{1, 2, 3};
+    auto collected = lbnl::collect(results);
+    static_assert(std::is_same_v<decltype(collected), lbnl::ExpectedExt<std::vector<int>, std::string>>);
+    ASSERT_TRUE(collected.has_value());
+    EXPECT_EQ(collected.value(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(ExpectedUtils_Collect, StopsAtFirstError)
+{
+    int calls = 0;
+    auto view = std::vector<int>{1, -2, -3, 4} | std::views::transform([&calls](int x) {
+                    ++calls;
+                    return parse(x);
+                });
+
+    auto collected = lbnl::collect(view);
+    ASSERT_FALSE(collected.has_value());
+    EXPECT_EQ(collected.error(), "negative: -2");
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(ExpectedUtils_Collect, MovesFromRvalueContainer)
+{
+    std::vector<lbnl::ExpectedExt<std::string, int>> results;
+    results.emplace_back(std::string(100, 'a'));
+    results.emplace_back(std::string(100, 'b'));
+
+    auto copied = lbnl::collect(results);
+    EXPECT_EQ(results[0].value().size(), 100u);
+
+    auto moved = lbnl::collect(std::move(results));
+    ASSERT_TRUE(moved.has_value());
+    EXPECT_EQ(moved.value(), copied.value());
+    EXPECT_TRUE(results[0].value().empty());   // NOLINT(bugprone-use-after-move)
+}
+
+TEST(ExpectedUtils_Collect, VoidResults)
+{
+    using Status = lbnl::ExpectedExt<void, std::string>;
+    const std::vector<Status> ok(3);
+    EXPECT_TRUE(lbnl::collect(ok).has_value());
+
+    const std::vector<Status> mixed{Status(), Status(lbnl::unexpect, "io"), Status(lbnl::unexpect, "disk")};
+    auto collected = lbnl::collect(mixed);
+    ASSERT_FALSE(collected.has_value());
+    EXPECT_EQ(collected.error(), "io");
+}
+
+TEST(ExpectedUtils_Partition, SplitsInOrderWithExactCapacity)
+{
+    const std::vector<Result> results{parse(5), parse(-1), parse(7), parse(-3), parse(9)};
+    auto [values, errors] = lbnl::partition_results(results);
+
+    EXPECT_EQ(values, (std::vector<int>{50, 70, 90}));
+    EXPECT_EQ(errors, (std::vector<std::string>{"negative: -1", "negative: -3"}));
+    EXPECT_EQ(values.capacity(), 3u);
+    EXPECT_EQ(errors.capacity(), 2u);
+}
+
+TEST(ExpectedUtils_Partition, ComputedRangeIsTraversedOnce)
+{
+    int calls = 0;
+    const std::vector<int> inputs{5, -1, 7};
+    auto [values, errors] = lbnl::partition_results(inputs | std::views::transform([&calls](int x) {
+                                                        ++calls;
+                                                        return parse(x);
+                                                    }));
+
+    EXPECT_EQ(values, (std::vector<int>{50, 70}));
+    EXPECT_EQ(errors, std::vector<std::string>{"negative: -1"});
+    EXPECT_EQ(calls, 3);
+}
+
+TEST(ExpectedUtils_Partition, NonSizedRange)
+{
+    const std::list<Result> results{Result(1), Result(lbnl::unexpect, "x"), Result(2)};
+    auto [values, errors] = lbnl::partition_results(results);
+    EXPECT_EQ(values, (std::vector<int>{1, 2}));
+    EXPECT_EQ(errors, std::vector<std::string>{"x"});
+}
+
+TEST(ExpectedUtils_TransformExpected, ParallelValuesInInputOrder)
+{
+    std::vector<int> inputs(1000);
+    std::iota(inputs.begin(), inputs.end(), 0);
+
+    auto result = lbnl::transform_expected(inputs, parse, 8);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result.value().size(), inputs.size());
+    for(std::size_t i = 0; i < inputs.size(); ++i)
+    {
+        EXPECT_EQ(result.value()[i], inputs[i] * 10);
+    }
+}
+
+TEST(ExpectedUtils_TransformExpected, ReportsLowestFailingPositionAndStopsEarly)
+{
+    std::vector<int> inputs(10000);
+    std::iota(inputs.begin(), inputs.end(), 0);
+    inputs[700] = -700;
+    inputs[300] = -300;
+
+    std::atomic<int> calls{0};
+    auto result = lbnl::transform_expected(
+      inputs,
+      [&calls](int x) {
+          ++calls;
+          return parse(x);
+      },
+      4);
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), "negative: -300");
+    EXPECT_LT(calls.load(), 10000);
+}
+
+TEST(ExpectedUtils_TransformExpected, RethrowsException)
+{
+    const std::vector<int> inputs{1, 2, 3, 4};
+    auto throwing = [](int x) -> Result {
+        if(x == 3)
+        {
+            throw std::runtime_error("boom");
+        }
+        return x;
+    };
+    EXPECT_THROW((void)lbnl::transform_expected(inputs, throwing, 2), std::runtime_error);
+}
+
+TEST(ExpectedUtils_TransformExpected, EmptyRangeAndSingleThread)
+{
+    const std::vector<int> empty;
+    auto none = lbnl::transform_expected(empty, parse, 4);
+    ASSERT_TRUE(none.has_value());
+    EXPECT_TRUE(none.value().empty());
+
+    const std::vector<int> inputs{1, 2, 3};
+    auto serial = lbnl::transform_expected(inputs, parse, 0);
+    EXPECT_EQ(serial.value(), (std::vector<int>{10, 20, 30}));
+}
@@ -0,0 +1,202 @@
+// lazy_chain.unit.cxx
+#include <gtest/gtest.h>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <lbnl/lazy_chain.hxx>
+
+namespace
+{
+    // Payload that counts its copies and moves
+    struct Tracked
+    {
+        static inline int copies = 0;
+        static inline int moves = 0;
+
+        std::vector<int> data;
+
+        explicit Tracked(std::vector<int> d) : data(std::move(d))
+        {}
+
+        Tracked(const Tracked & other) : data(other.data)
+        {
+            ++copies;
+        }
+
+        Tracked(Tracked && other) noexcept : data(std::move(other.data))
+        {
+            ++moves;
+        }
+
+        Tracked & operator=(const Tracked &) = default;
+        Tracked & operator=(Tracked &&) noexcept = default;
+
+        static void resetCounts()
+        {
+            copies = 0;
+            moves = 0;
+        }
+    };
+
+    Tracked expand(int n)
+    {
+        return Tracked{std::vector<int>(static_cast<std::size_t>(n), n)};
+    }
+
+    std::optional<Tracked> nonEmpty(Tracked && t)
+    {
+        if(t.data.empty())
+        {
+            return std::nullopt;
+        }
+        return std::optional<Tracked>(std::move(t));
+    }
+
+    Tracked doubled(Tracked && t)
+    {
+        std::vector<int> out;
+        out.reserve(t.data.size());
+        for(int x : t.data)
+        {
+            out.push_back(2 * x);
+        }
+        return Tracked{std::move(out)};
+    }
+
+    // The code a lazy chain is meant to match
+    Tracked handWritten(const std::optional<int> & opt)
+    {
+        if(opt)
+        {
+            if(auto r = nonEmpty(expand(*opt)); r)
+            {
+                return doubled(std::move(*r));
+            }
+        }
+        return Tracked{{}};
+    }
+
+    using Result = lbnl::ExpectedExt<int, std::string>;
+
+    Result checkPositive(int x)
+    {
+        if(x <= 0)
+        {
+            return lbnl::Unexpected(std::string("not positive"));
+        }
+        return x;
+    }
+
+    // Fully evaluated at compile time: the chain is plain function composition
+    static_assert(lbnl::lazy(std::optional<int>(20))
+                    .map([](int x) { return x + 1; })
+                    .and_then([](int x) {
+                        return x % 3 == 0 ? std::optional<int>(x / 3) : std::nullopt;
+                    })
+                    .map([](int x) { return x * 2; })
+                    .value_or(-1)
+                  == 14);
+}   // namespace
+
+TEST(LazyChain, MatchesEagerResults)
+{
+    auto half = [](int x) { return x % 2 == 0 ? std::optional<int>(x / 2) : std::nullopt; };
+    auto label = [](int x) { return std::to_string(x); };
+
+    const std::vector<std::optional<int>> sources{8, 7, std::nullopt};
+    for(const auto & source : sources)
+    {
+        const auto eager = lbnl::extend(source).and_then(half).map(label);
+        const auto lazy = lbnl::lazy(source).and_then(half).map(label).collect();
+        static_assert(
+          std::is_same_v<std::remove_const_t<decltype(lazy)>, lbnl::OptionalExt<std::string>>);
+        EXPECT_EQ(lazy, eager);
+        EXPECT_EQ(lbnl::lazy(source).and_then(half).map(label).value_or("none"),
+                  eager.value_or("none"));
+    }
+}
+
+TEST(LazyChain, NothingRunsBeforeTerminal)
+{
+    int calls = 0;
+    auto count = [&calls](int x) {
+        ++calls;
+        return x;
+    };
+
+    const std::optional<int> source(1);
+    auto chain = lbnl::lazy(source).map(count).map(count);
+    EXPECT_EQ(calls, 0);
+
+    EXPECT_EQ(*chain, 1);
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(chain.value(), 1);   // a chain can be run again
+    EXPECT_EQ(calls, 4);
+
+    // An empty and_then step stops the rest of the chain
+    calls = 0;
+    auto none = [](int) { return std::optional<int>(); };
+    EXPECT_FALSE(lbnl::lazy(source).and_then(none).map(count).collect().has_value());
+    EXPECT_THROW((void)lbnl::lazy(source).and_then(none).map(count).value(),
+                 std::bad_optional_access);
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(LazyChain, ExpectedSourcePropagatesErrors)
+{
+    auto chain = [](Result source) {
+        return lbnl::lazy(std::move(source))
+          .map([](int x) { return x - 5; })
+          .and_then(checkPositive)
+          .map([](int x) { return x * 10; });
+    };
+
+    const auto ok = chain(Result(8)).collect();
+    static_assert(std::is_same_v<std::remove_const_t<decltype(ok)>, Result>);
+    EXPECT_EQ(ok.value(), 30);
+
+    EXPECT_EQ(chain(Result(2)).collect().error(), "not positive");
+    EXPECT_EQ(chain(Result(lbnl::unexpect, "io")).collect().error(), "io");
+    EXPECT_EQ(chain(Result(lbnl::unexpect, "io")).value_or(0), 0);
+    EXPECT_THROW((void)chain(Result(2)).value(), lbnl::BadExpectedAccess);
+}
+
+TEST(LazyChain, MatchesHandWrittenIfCode)
+{
+    const std::optional<int> source(3);
+
+    Tracked::resetCounts();
+    const Tracked manual = handWritten(source);
+    const int manualMoves = Tracked::moves;
+
+    Tracked::resetCounts();
+    const Tracked lazy =
+      lbnl::lazy(source).map(expand).and_then(nonEmpty).map(doubled).value_or(Tracked{{}});
+    const int lazyMoves = Tracked::moves;
+
+    Tracked::resetCounts();
+    const Tracked eager =
+      lbnl::extend(source).map(expand).and_then(nonEmpty).map(doubled).value_or(Tracked{{}});
+    const int eagerMoves = Tracked::moves;
+
+    EXPECT_EQ(lazy.data, manual.data);
+    EXPECT_EQ(eager.data, manual.data);
+    EXPECT_EQ(lazyMoves, manualMoves);   // only the move inside nonEmpty
+    EXPECT_GT(eagerMoves, lazyMoves);    // eager wraps every step in an OptionalExt
+    EXPECT_EQ(Tracked::copies, 0);
+}
+
+TEST(LazyChain, RvalueSourceIsMovedIntoFirstStep)
+{
+    Tracked::resetCounts();
+    std::optional<Tracked> source(Tracked{{1, 2, 3}});
+    auto sizes = lbnl::lazy(std::move(source))
+                   .and_then(nonEmpty)
+                   .map([](const Tracked & t) { return t.data.size(); })
+                   .collect();
+    EXPECT_EQ(*sizes, 3u);
+    EXPECT_EQ(Tracked::copies, 0);
+}
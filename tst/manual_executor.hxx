@@ -0,0 +1,40 @@
+// manual_executor.hxx
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace lbnl::test
+{
+    //! Executor that only queues tasks; the test decides when they run. Copies share one
+    //! queue, so a copy handed to the library (e.g. enable_refresh_ahead) feeds the test's one.
+    struct ManualExecutor
+    {
+        std::shared_ptr<std::vector<std::function<void()>>> tasks =
+          std::make_shared<std::vector<std::function<void()>>>();
+
+        void operator()(std::function<void()> task) const
+        {
+            tasks->push_back(std::move(task));
+        }
+
+        //! Number of queued tasks that have not run yet
+        [[nodiscard]] std::size_t pending() const
+        {
+            return tasks->size();
+        }
+
+        //! Runs the tasks queued so far; tasks they queue wait for the next call
+        void runAll() const
+        {
+            auto queued = std::move(*tasks);
+            tasks->clear();
+            for(auto & task : queued)
+            {
+                task();
+            }
+        }
+    };
+}   // namespace lbnl::test
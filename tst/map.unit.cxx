@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <map>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 #include "lbnl/map_utils.hxx"
 
@@ -32,4 +35,25 @@ TEST(MapUtilsTest, MapLookupValueNotFound)
     std::map<int, std::string> test_map = {{1, "one"}, {2, "two"}, {3, "three"}};
     auto result = lbnl::map_lookup_by_value(test_map, "four");
     ASSERT_FALSE(result.has_value());
-}
\ No newline at end of file
+}
+
+TEST(MapUtilsTest, MapLookupKeyHeterogeneousOrderedMap)
+{
+    std::map<std::string, int, std::less<>> test_map = {{"one", 1}, {"two", 2}};
+    constexpr std::string_view key = "two";
+    auto result = lbnl::map_lookup_by_key(test_map, key);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), 2);
+    EXPECT_FALSE(lbnl::map_lookup_by_key(test_map, std::string_view("three")).has_value());
+}
+
+TEST(MapUtilsTest, MapLookupKeyHeterogeneousUnorderedMap)
+{
+    std::unordered_map<std::string, int, lbnl::TransparentStringHash, std::equal_to<>> test_map = {
+      {"one", 1}, {"two", 2}};
+    auto result = lbnl::map_lookup_by_key(test_map, std::string_view("one"));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), 1);
+    EXPECT_EQ(lbnl::map_lookup_by_key(test_map, "two"), 2);
+    EXPECT_FALSE(lbnl::map_lookup_by_key(test_map, "three").has_value());
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lbnl/memoize.hxx"
+
+#include "manual_executor.hxx"
+
+using lbnl::test::ManualExecutor;
+
+TEST(LazyEvaluatorAsyncTest, GetAsyncRunsGeneratorOnExecutor)
+{
+    std::atomic callCount{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator([&](int key) {
+        ++callCount;
+        return std::to_string(key * 10);
+    });
+
+    ManualExecutor executor;
+    auto future = evaluator.get_async(4, executor);
+
+    EXPECT_EQ(callCount, 0);
+    ASSERT_EQ(executor.pending(), 1u);
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+
+    executor.runAll();
+
+    EXPECT_EQ(callCount, 1);
+    EXPECT_EQ(future.get(), "40");
+    EXPECT_EQ(evaluator.get(4), "40");
+    EXPECT_EQ(callCount, 1);
+}
+
+TEST(LazyEvaluatorAsyncTest, GetAsyncDoesNotResubmitInFlightKey)
+{
+    lbnl::LazyEvaluator<int, int> evaluator([](int key) { return key + 1; });
+
+    ManualExecutor executor;
+    auto first = evaluator.get_async(1, executor);
+    auto second = evaluator.get_async(1, executor);
+
+    EXPECT_EQ(executor.pending(), 1u);
+    executor.runAll();
+
+    EXPECT_EQ(first.get(), 2);
+    EXPECT_EQ(&first.get(), &second.get());
+}
+
+TEST(LazyEvaluatorAsyncTest, TryGetNeverStartsComputation)
+{
+    std::atomic callCount{0};
+    lbnl::LazyEvaluator<int, int> evaluator([&](int key) {
+        ++callCount;
+        return key * 2;
+    });
+
+    EXPECT_EQ(evaluator.try_get(5), nullptr);
+    EXPECT_EQ(callCount, 0);
+
+    ManualExecutor executor;
+    (void)evaluator.get_async(5, executor);
+    EXPECT_EQ(evaluator.try_get(5), nullptr);   // in flight, not ready
+
+    executor.runAll();
+    const int * value = evaluator.try_get(5);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 10);
+    EXPECT_EQ(callCount, 1);
+}
+
+TEST(LazyEvaluatorAsyncTest, GetForTimesOutThenSucceeds)
+{
+    using namespace std::chrono_literals;
+
+    lbnl::LazyEvaluator<int, int> evaluator([](int key) { return key * 3; });
+
+    EXPECT_EQ(evaluator.get_for(7, 1ms), nullptr);   // unknown key
+
+    ManualExecutor executor;
+    (void)evaluator.get_async(7, executor);
+    EXPECT_EQ(evaluator.get_for(7, 1ms), nullptr);   // in flight
+
+    std::thread worker([&executor]() {
+        std::this_thread::sleep_for(10ms);
+        executor.runAll();
+    });
+
+    const int * value = evaluator.get_for(7, 5s);
+    worker.join();
+
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 21);
+}
+
+TEST(LazyEvaluatorAsyncTest, GetForReturnsNullWhenTheComputationFails)
+{
+    using namespace std::chrono_literals;
+
+    lbnl::LazyEvaluator<int, int> evaluator([](int) -> int { throw std::runtime_error("boom"); });
+
+    ManualExecutor executor;
+    (void)evaluator.get_async(8, executor);
+    std::thread worker([&executor]() {
+        std::this_thread::sleep_for(10ms);
+        executor.runAll();
+    });
+
+    const int * value = nullptr;
+    EXPECT_NO_THROW(value = evaluator.get_for(8, 5s));
+    worker.join();
+    EXPECT_EQ(value, nullptr);
+}
+
+TEST(LazyEvaluatorAsyncTest, GetForReturnsNullWhenTheEntryIsRemovedWhileWaiting)
+{
+    using namespace std::chrono_literals;
+
+    lbnl::LazyEvaluator<int, int> evaluator([](int key) { return key * 3; });
+
+    ManualExecutor executor;
+    (void)evaluator.get_async(9, executor);
+    std::thread worker([&]() {
+        std::this_thread::sleep_for(10ms);
+        evaluator.erase(9);
+        (void)evaluator.release_retired();   // the waiting get_for keeps the entry alive
+        executor.runAll();
+    });
+
+    const int * value = evaluator.get_for(9, 5s);
+    worker.join();
+    EXPECT_EQ(value, nullptr);
+    EXPECT_EQ(evaluator.release_retired(), 1u);
+}
+
+TEST(LazyEvaluatorAsyncTest, FailedGenerationIsRetried)
+{
+    std::atomic callCount{0};
+    lbnl::LazyEvaluator<int, int> evaluator([&](int key) {
+        if(++callCount == 1)
+        {
+            throw std::runtime_error("first attempt fails");
+        }
+        return key;
+    });
+
+    ManualExecutor executor;
+    auto future = evaluator.get_async(9, executor);
+    executor.runAll();
+    EXPECT_THROW(future.get(), std::runtime_error);
+    EXPECT_EQ(evaluator.try_get(9), nullptr);
+
+    EXPECT_EQ(evaluator.get(9), 9);
+    EXPECT_EQ(callCount, 2);
+}
+
+TEST(LazyEvaluatorAsyncTest, TaskQueuedByAThrowingExecutorDoesNothing)
+{
+    std::atomic callCount{0};
+    lbnl::LazyEvaluator<int, int> evaluator([&](int key) {
+        ++callCount;
+        return key * 2;
+    });
+
+    // Queues the task, then reports a failure anyway
+    ManualExecutor queue;
+    auto throwingExecutor = [&queue](std::function<void()> task) {
+        queue(std::move(task));
+        throw std::runtime_error("executor shutting down");
+    };
+
+    EXPECT_THROW((void)evaluator.get_async(3, throwingExecutor), std::runtime_error);
+    EXPECT_EQ(evaluator.try_get(3), nullptr);
+
+    ASSERT_EQ(queue.pending(), 1u);
+    EXPECT_NO_THROW(queue.runAll());
+    EXPECT_EQ(callCount, 0);
+
+    EXPECT_EQ(evaluator.get(3), 6);
+    EXPECT_EQ(callCount, 1);
+}
+
+TEST(LazyEvaluatorAsyncTest, SynchronousGetPropagatesGeneratorException)
+{
+    lbnl::LazyEvaluator<int, int> evaluator([](int) -> int { throw std::logic_error("bad key"); });
+
+    EXPECT_THROW(evaluator.get(1), std::logic_error);
+    EXPECT_THROW(evaluator.get(1), std::logic_error);   // not cached as a broken entry
+}
+
+TEST(LazyEvaluatorAsyncTest, ThreadExecutorSharesResultWithBlockingGet)
+{
+    using namespace std::chrono_literals;
+
+    std::atomic callCount{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator([&](int key) {
+        ++callCount;
+        std::this_thread::sleep_for(20ms);
+        return "Value_" + std::to_string(key);
+    });
+
+    std::vector<std::thread> workers;
+    auto threadExecutor = [&workers](std::function<void()> task) {
+        workers.emplace_back(std::move(task));
+    };
+
+    auto future = evaluator.get_async(1, threadExecutor);
+    const auto & blocking = evaluator.get(1);
+
+    for(auto & worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(blocking, "Value_1");
+    EXPECT_EQ(future.get(), "Value_1");
+    EXPECT_EQ(callCount, 1);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "lbnl/memoize.hxx"
+
+namespace
+{
+    using Evaluator = lbnl::LazyEvaluator<int, int>;
+    using Front = lbnl::FrontCache<int, int>;
+}   // namespace
+
+TEST(FrontCacheTest, RepeatedHitsAreServedLocally)
+{
+    std::atomic callCount{0};
+    Evaluator shared([&callCount](int key) {
+        ++callCount;
+        return key * 2;
+    });
+    Front front(shared);
+
+    const int & first = front.get(21);
+    EXPECT_EQ(first, 42);
+    for(int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(&front(21), &first);
+    }
+
+    EXPECT_EQ(&shared.get(21), &first);
+    EXPECT_EQ(callCount, 1);
+    EXPECT_EQ(front.stats().hits, 10u);
+    EXPECT_EQ(front.stats().misses, 1u);
+    EXPECT_NEAR(front.stats().hit_rate(), 10.0 / 11.0, 1e-12);
+
+    front.reset_stats();
+    EXPECT_EQ(front.stats().hits + front.stats().misses, 0u);
+    EXPECT_DOUBLE_EQ(front.stats().hit_rate(), 0.0);
+}
+
+TEST(FrontCacheTest, EraseAndInvalidateAreSeen)
+{
+    std::atomic version{0};
+    Evaluator shared([&version](int key) { return key + 100 * version.load(); });
+    Front front(shared);
+
+    EXPECT_EQ(front.get(1), 1);
+
+    version = 1;
+    shared.erase(1);
+    EXPECT_EQ(front.get(1), 101);
+
+    version = 2;
+    shared.invalidate(1);
+    EXPECT_EQ(front.get(1), 201);
+
+    version = 3;
+    shared.invalidate_if([](int key) { return key == 1; });
+    EXPECT_EQ(front.get(1), 301);
+
+    version = 4;
+    shared.clear();
+    EXPECT_EQ(front.get(1), 401);
+    EXPECT_EQ(front.stats().hits, 0u);
+}
+
+TEST(FrontCacheTest, ExpiredEntryIsNotServed)
+{
+    std::atomic callCount{0};
+    Evaluator shared([&callCount](int key) { return key + 10 * ++callCount; });
+    shared.set_ttl(std::chrono::milliseconds(20));
+    Front front(shared);
+
+    EXPECT_EQ(front.get(1), 11);
+    EXPECT_EQ(front.get(1), 11);
+    EXPECT_EQ(front.stats().hits, 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_EQ(front.get(1), 21);
+}
+
+TEST(FrontCacheTest, CollidingKeysStayCorrect)
+{
+    Evaluator shared([](int key) { return -key; });
+    lbnl::FrontCache<int, int, std::hash<int>, std::equal_to<int>, 1> front(shared);
+
+    for(int round = 0; round < 3; ++round)
+    {
+        EXPECT_EQ(front.get(1), -1);
+        EXPECT_EQ(front.get(2), -2);
+    }
+    EXPECT_EQ(front.stats().hits, 0u);
+
+    EXPECT_EQ(front.get(2), -2);
+    EXPECT_EQ(front.stats().hits, 1u);
+
+    front.clear();
+    EXPECT_EQ(front.get(2), -2);
+    EXPECT_EQ(front.stats().misses, 7u);
+}
+
+TEST(FrontCacheTest, OnePerThreadOverSharedEvaluator)
+{
+    std::atomic callCount{0};
+    Evaluator shared([&callCount](int key) {
+        ++callCount;
+        return key * key;
+    });
+
+    constexpr int threadCount = 4;
+    std::vector<std::thread> threads;
+    std::vector<lbnl::FrontCacheStats> stats(threadCount);
+    for(int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&shared, &stats, t]() {
+            Front front(shared);
+            for(int round = 0; round < 100; ++round)
+            {
+                for(int key = 0; key < 16; ++key)
+                {
+                    EXPECT_EQ(front.get(key), key * key);
+                }
+            }
+            stats[t] = front.stats();
+        });
+    }
+    for(auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(callCount, 16);
+    for(const auto & s : stats)
+    {
+        EXPECT_EQ(s.misses, 16u);
+        EXPECT_EQ(s.hits, 99u * 16u);
+    }
+}
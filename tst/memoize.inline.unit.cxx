@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "lbnl/map_utils.hxx"
+#include "lbnl/memoize.hxx"
+
+namespace
+{
+    struct SquareGenerator
+    {
+        std::atomic<int> * calls;
+
+        double operator()(int key) const
+        {
+            ++*calls;
+            return static_cast<double>(key) * key;
+        }
+    };
+}   // namespace
+
+TEST(InlineLazyEvaluatorTest, ComputesOncePerKey)
+{
+    std::atomic calls{0};
+    lbnl::InlineLazyEvaluator<int, double, SquareGenerator> evaluator(SquareGenerator{&calls});
+
+    EXPECT_DOUBLE_EQ(evaluator.get(3), 9.0);
+    EXPECT_DOUBLE_EQ(evaluator(3), 9.0);
+    EXPECT_EQ(calls, 1);
+
+    EXPECT_DOUBLE_EQ(evaluator(4), 16.0);
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(InlineLazyEvaluatorTest, FactoryDeducesValueType)
+{
+    auto evaluator = lbnl::make_inline_lazy_evaluator<int>([](int key) { return std::to_string(key); });
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(evaluator.get(1))>, std::string>);
+
+    EXPECT_EQ(evaluator.get(12), "12");
+    EXPECT_EQ(&evaluator.get(12), &evaluator.get(12));   // same cached object
+}
+
+TEST(InlineLazyEvaluatorTest, TryGetDoesNotCompute)
+{
+    std::atomic calls{0};
+    lbnl::InlineLazyEvaluator<int, double, SquareGenerator> evaluator(SquareGenerator{&calls});
+
+    EXPECT_EQ(evaluator.try_get(5), nullptr);
+    EXPECT_EQ(calls, 0);
+
+    (void)evaluator.get(5);
+    ASSERT_NE(evaluator.try_get(5), nullptr);
+    EXPECT_DOUBLE_EQ(*evaluator.try_get(5), 25.0);
+}
+
+TEST(InlineLazyEvaluatorTest, ParallelAccessSameKeyComputesOnce)
+{
+    using namespace std::chrono_literals;
+
+    std::atomic calls{0};
+    auto evaluator = lbnl::make_inline_lazy_evaluator<int>([&calls](int key) {
+        ++calls;
+        std::this_thread::sleep_for(30ms);
+        return "Value_" + std::to_string(key);
+    });
+
+    constexpr int numThreads = 8;
+    std::vector<std::thread> threads;
+    std::vector<const std::string *> results(numThreads);
+    for(int idx = 0; idx < numThreads; ++idx)
+    {
+        threads.emplace_back([&evaluator, &results, idx]() { results[idx] = &evaluator.get(7); });
+    }
+    for(auto & thr : threads)
+    {
+        thr.join();
+    }
+
+    EXPECT_EQ(calls, 1);
+    std::set<const std::string *> unique(results.begin(), results.end());
+    ASSERT_EQ(unique.size(), 1u);
+    EXPECT_EQ(**unique.begin(), "Value_7");
+}
+
+TEST(InlineLazyEvaluatorTest, FailedComputationIsRetried)
+{
+    std::atomic calls{0};
+    auto evaluator = lbnl::make_inline_lazy_evaluator<int>([&calls](int key) {
+        if(++calls == 1)
+        {
+            throw std::runtime_error("transient");
+        }
+        return key * 10;
+    });
+
+    EXPECT_THROW((void)evaluator.get(2), std::runtime_error);
+    EXPECT_EQ(evaluator.try_get(2), nullptr);
+    EXPECT_EQ(evaluator.get(2), 20);
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(InlineLazyEvaluatorTest, HeterogeneousLookup)
+{
+    auto evaluator = lbnl::make_inline_lazy_evaluator<std::string, lbnl::TransparentStringHash, std::equal_to<>>(
+      [](const std::string & key) { return key.size(); });
+
+    EXPECT_EQ(evaluator.get(std::string_view("glazing")), 7u);
+    EXPECT_EQ(evaluator("glazing"), 7u);
+}
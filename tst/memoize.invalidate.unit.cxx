@@ -0,0 +1,304 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lbnl/memoize.hxx"
+
+#include "manual_executor.hxx"
+
+using lbnl::test::ManualExecutor;
+
+namespace
+{
+    // Generator whose result changes with every call, so recomputation is observable.
+    struct VersionedGenerator
+    {
+        std::atomic<int> * calls;
+
+        std::string operator()(int key) const
+        {
+            const int call = ++*calls;
+            return std::to_string(key) + "@" + std::to_string(call);
+        }
+    };
+
+    // Value that counts its live instances, so freed entries are observable
+    struct Counted
+    {
+        static inline std::atomic<int> live{0};
+
+        explicit Counted(int v) : value(v)
+        {
+            ++live;
+        }
+
+        Counted(const Counted & other) : value(other.value)
+        {
+            ++live;
+        }
+
+        ~Counted()
+        {
+            --live;
+        }
+
+        Counted & operator=(const Counted &) = default;
+
+        int value;
+    };
+}   // namespace
+
+TEST(LazyEvaluatorInvalidateTest, EraseRecomputesAndOldReferenceStaysValid)
+{
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator(VersionedGenerator{&calls});
+
+    const std::string & first = evaluator.get(1);
+    EXPECT_EQ(first, "1@1");
+
+    EXPECT_TRUE(evaluator.erase(1));
+    EXPECT_FALSE(evaluator.erase(1));
+    EXPECT_EQ(evaluator.try_get(1), nullptr);
+
+    EXPECT_EQ(evaluator.get(1), "1@2");
+    EXPECT_EQ(first, "1@1");   // retired, not freed
+
+    EXPECT_EQ(evaluator.release_retired(), 1u);
+}
+
+TEST(LazyEvaluatorInvalidateTest, PinKeepsEntriesAcrossReleaseRetired)
+{
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator(VersionedGenerator{&calls});
+
+    {
+        const auto pin = evaluator.pin();
+        const std::string & first = evaluator.get(1);
+        EXPECT_TRUE(evaluator.erase(1));
+        EXPECT_EQ(evaluator.release_retired(), 0u);   // still reachable through the pin
+        EXPECT_EQ(first, "1@1");
+    }
+    EXPECT_EQ(evaluator.release_retired(), 1u);
+}
+
+TEST(LazyEvaluatorInvalidateTest, ClearRemovesEverything)
+{
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator(VersionedGenerator{&calls});
+
+    (void)evaluator.get(1);
+    (void)evaluator.get(2);
+    evaluator.clear();
+
+    EXPECT_EQ(evaluator.try_get(1), nullptr);
+    EXPECT_EQ(evaluator.try_get(2), nullptr);
+    EXPECT_EQ(evaluator.get(2), "2@3");
+    EXPECT_EQ(evaluator.release_retired(), 2u);
+    EXPECT_EQ(evaluator.release_retired(), 0u);
+}
+
+TEST(LazyEvaluatorInvalidateTest, RemovedEntriesAreFreedOnlyByReleaseRetired)
+{
+    {
+        lbnl::LazyEvaluator<int, Counted> evaluator([](int key) { return Counted(key); });
+
+        std::vector<const Counted *> held;
+        for(int round = 0; round < 100; ++round)
+        {
+            held.push_back(&evaluator.get(round % 4));
+            evaluator.erase(round % 4);
+        }
+        EXPECT_EQ(Counted::live, 100);
+        for(int round = 0; round < 100; ++round)
+        {
+            EXPECT_EQ(held[static_cast<std::size_t>(round)]->value, round % 4);
+        }
+        held.clear();
+        EXPECT_EQ(evaluator.release_retired(), 100u);
+        EXPECT_EQ(Counted::live, 0);
+
+        // Expired entries are replaced and retired the same way
+        evaluator.set_ttl(std::chrono::nanoseconds(0));
+        for(int round = 0; round < 100; ++round)
+        {
+            EXPECT_EQ(evaluator.get(7).value, 7);
+        }
+        EXPECT_GE(Counted::live, 99);
+        (void)evaluator.release_retired();
+        EXPECT_LE(Counted::live, 1);
+    }
+    EXPECT_EQ(Counted::live, 0);
+}
+
+TEST(LazyEvaluatorInvalidateTest, PinnedReadersRaceWithRemovals)
+{
+    lbnl::LazyEvaluator<int, std::string> evaluator(
+      [](int key) { return std::string(64, static_cast<char>('a' + key)); });
+
+    std::atomic<bool> stop{false};
+    std::thread remover([&] {
+        for(int round = 0; !stop; ++round)
+        {
+            evaluator.erase(round % 8);
+            if(round % 64 == 0)
+            {
+                evaluator.invalidate_if([](int key) { return key % 2 == 0; });
+                (void)evaluator.release_retired();
+            }
+        }
+    });
+
+    std::vector<std::thread> readers;
+    std::atomic<int> mismatches{0};
+    for(int thread = 0; thread < 4; ++thread)
+    {
+        readers.emplace_back([&, thread] {
+            for(int round = 0; round < 5000; ++round)
+            {
+                const int key = (round + thread) % 8;
+                const auto pin = evaluator.pin();
+                const std::string & value = evaluator.get(key);
+                std::this_thread::yield();
+                if(value != std::string(64, static_cast<char>('a' + key)))
+                {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for(auto & reader : readers)
+    {
+        reader.join();
+    }
+    stop = true;
+    remover.join();
+    EXPECT_EQ(mismatches, 0);
+}
+
+TEST(LazyEvaluatorInvalidateTest, InvalidateRecomputesOnNextAccess)
+{
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator(VersionedGenerator{&calls});
+
+    (void)evaluator.get(1);
+    EXPECT_TRUE(evaluator.invalidate(1));
+    EXPECT_FALSE(evaluator.invalidate(99));
+    EXPECT_EQ(evaluator.try_get(1), nullptr);   // stale values are not served
+
+    EXPECT_EQ(evaluator.get(1), "1@2");
+    EXPECT_EQ(evaluator.get(1), "1@2");
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(LazyEvaluatorInvalidateTest, InvalidateIfUsesPredicate)
+{
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator(VersionedGenerator{&calls});
+
+    for(int key = 0; key < 6; ++key)
+    {
+        (void)evaluator.get(key);
+    }
+
+    EXPECT_EQ(evaluator.invalidate_if([](int key) { return key % 2 == 0; }), 3u);
+
+    EXPECT_EQ(evaluator.get(1), "1@2");   // untouched
+    EXPECT_EQ(evaluator.get(2), "2@7");   // recomputed
+    EXPECT_EQ(calls, 7);
+}
+
+TEST(LazyEvaluatorInvalidateTest, TtlExpiresEntries)
+{
+    using namespace std::chrono_literals;
+
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator(VersionedGenerator{&calls});
+    evaluator.set_ttl(20ms);
+
+    EXPECT_EQ(evaluator.get(1), "1@1");
+    EXPECT_EQ(evaluator.get(1), "1@1");
+
+    std::this_thread::sleep_for(40ms);
+    EXPECT_EQ(evaluator.try_get(1), nullptr);
+    EXPECT_EQ(evaluator.get(1), "1@2");
+}
+
+TEST(LazyEvaluatorInvalidateTest, PerEntryTtlPolicy)
+{
+    using Evaluator = lbnl::LazyEvaluator<int, std::string>;
+
+    std::atomic calls{0};
+    Evaluator evaluator(VersionedGenerator{&calls});
+    evaluator.set_ttl([](int key, const std::string &) {
+        return key == 0 ? Evaluator::Clock::duration::max() : Evaluator::Clock::duration::zero();
+    });
+
+    EXPECT_EQ(evaluator.get(0), "0@1");
+    EXPECT_EQ(evaluator.get(0), "0@1");   // never expires
+
+    EXPECT_EQ(evaluator.get(1), "1@2");
+    EXPECT_EQ(evaluator.get(1), "1@3");   // expires immediately
+}
+
+TEST(LazyEvaluatorInvalidateTest, RefreshAheadServesStaleWhileRecomputing)
+{
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator(VersionedGenerator{&calls});
+    ManualExecutor executor;
+    evaluator.enable_refresh_ahead(executor);
+
+    const std::string & original = evaluator.get(1);
+    EXPECT_EQ(original, "1@1");
+    evaluator.invalidate(1);
+
+    // Stale value served, exactly one refresh scheduled
+    EXPECT_EQ(evaluator.get(1), "1@1");
+    EXPECT_EQ(evaluator.get(1), "1@1");
+    ASSERT_NE(evaluator.try_get(1), nullptr);
+    EXPECT_EQ(executor.pending(), 1u);
+    EXPECT_EQ(calls, 1);
+
+    executor.runAll();
+
+    EXPECT_EQ(evaluator.get(1), "1@2");
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(original, "1@1");   // reference held across the refresh stays valid
+}
+
+TEST(LazyEvaluatorInvalidateTest, RefreshAheadWithTtl)
+{
+    using namespace std::chrono_literals;
+
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator(VersionedGenerator{&calls});
+    ManualExecutor executor;
+    evaluator.enable_refresh_ahead(executor);
+    evaluator.set_ttl(10ms);
+
+    EXPECT_EQ(evaluator.get(3), "3@1");
+    std::this_thread::sleep_for(30ms);
+
+    EXPECT_EQ(evaluator.get(3), "3@1");
+    executor.runAll();
+    EXPECT_EQ(evaluator.get(3), "3@2");
+}
+
+TEST(LazyEvaluatorInvalidateTest, EraseWhileInFlight)
+{
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, std::string> evaluator(VersionedGenerator{&calls});
+    ManualExecutor executor;
+
+    auto pending = evaluator.get_async(5, executor);
+    EXPECT_TRUE(evaluator.erase(5));
+    executor.runAll();
+
+    EXPECT_EQ(pending.get(), "5@1");         // waiters of the erased slot still get a value
+    EXPECT_EQ(evaluator.try_get(5), nullptr);   // but it was not cached
+    EXPECT_EQ(evaluator.get(5), "5@2");
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lbnl/memoize.hxx"
+
+TEST(LazyEvaluatorPrewarmTest, FillsAllKeys)
+{
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, int> evaluator([&calls](int key) {
+        ++calls;
+        return key * key;
+    });
+
+    std::vector<int> keys(1000);
+    std::iota(keys.begin(), keys.end(), 0);
+
+    auto report = evaluator.prewarm(keys, 4);
+
+    EXPECT_EQ(report.computed, 1000u);
+    EXPECT_EQ(report.skipped, 0u);
+    EXPECT_TRUE(report.failures.empty());
+    EXPECT_EQ(calls, 1000);
+
+    for(int key : keys)
+    {
+        const int * value = evaluator.try_get(key);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, key * key);
+    }
+}
+
+TEST(LazyEvaluatorPrewarmTest, SkipsCachedAndDuplicateKeys)
+{
+    std::atomic calls{0};
+    lbnl::LazyEvaluator<int, int> evaluator([&calls](int key) {
+        ++calls;
+        return key;
+    });
+
+    (void)evaluator.get(1);
+    (void)evaluator.get(2);
+
+    const std::vector<int> keys = {1, 2, 3, 3, 4};
+    auto report = evaluator.prewarm(keys, 2);
+
+    EXPECT_EQ(report.computed, 2u);   // 3 and 4
+    EXPECT_EQ(report.skipped, 3u);    // 1, 2 and the duplicate 3
+    EXPECT_EQ(calls, 4);
+}
+
+TEST(LazyEvaluatorPrewarmTest, ReportsFailuresAndKeepsGoing)
+{
+    lbnl::LazyEvaluator<int, int> evaluator([](int key) {
+        if(key % 10 == 0)
+        {
+            throw std::runtime_error("bad key " + std::to_string(key));
+        }
+        return key;
+    });
+
+    std::vector<int> keys(50);
+    std::iota(keys.begin(), keys.end(), 0);
+
+    auto report = evaluator.prewarm(keys, 8);
+
+    EXPECT_EQ(report.computed, 45u);
+    ASSERT_EQ(report.failures.size(), 5u);
+
+    std::set<int> failedKeys;
+    for(const auto & [key, error] : report.failures)
+    {
+        failedKeys.insert(key);
+        EXPECT_THROW(std::rethrow_exception(error), std::runtime_error);
+    }
+    EXPECT_EQ(failedKeys, (std::set<int>{0, 10, 20, 30, 40}));
+    EXPECT_EQ(evaluator.try_get(10), nullptr);   // failed keys stay uncached
+}
+
+TEST(LazyEvaluatorPrewarmTest, ReportsProgress)
+{
+    lbnl::LazyEvaluator<int, int> evaluator([](int key) { return key; });
+
+    std::vector<int> keys(20);
+    std::iota(keys.begin(), keys.end(), 0);
+
+    std::vector<std::size_t> seen;
+    auto report = evaluator.prewarm(keys, 3, [&seen](std::size_t done, std::size_t total) {
+        EXPECT_EQ(total, 20u);
+        seen.push_back(done);
+    });
+
+    EXPECT_EQ(report.computed, 20u);
+    ASSERT_EQ(seen.size(), 20u);
+    for(std::size_t idx = 0; idx < seen.size(); ++idx)
+    {
+        EXPECT_EQ(seen[idx], idx + 1);
+    }
+}
+
+TEST(LazyEvaluatorPrewarmTest, RunsInParallel)
+{
+    using namespace std::chrono_literals;
+
+    std::mutex idsMutex;
+    std::set<std::thread::id> threadIds;
+    lbnl::LazyEvaluator<int, int> evaluator([&](int key) {
+        {
+            std::lock_guard lock(idsMutex);
+            threadIds.insert(std::this_thread::get_id());
+        }
+        std::this_thread::sleep_for(5ms);
+        return key;
+    });
+
+    std::vector<int> keys(16);
+    std::iota(keys.begin(), keys.end(), 0);
+
+    auto report = evaluator.prewarm(keys, 4);
+    EXPECT_EQ(report.computed, 16u);
+    EXPECT_GT(threadIds.size(), 1u);
+    EXPECT_LE(threadIds.size(), 4u);
+}
+
+TEST(LazyEvaluatorPrewarmTest, EmptyKeySet)
+{
+    lbnl::LazyEvaluator<int, int> evaluator([](int key) { return key; });
+    auto report = evaluator.prewarm(std::vector<int>{}, 4);
+    EXPECT_EQ(report.computed, 0u);
+    EXPECT_EQ(report.skipped, 0u);
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "lbnl/recursive_memoize.hxx"
+
+using Evaluator = lbnl::RecursiveEvaluator<int, std::uint64_t>;
+
+TEST(RecursiveEvaluatorTest, FibonacciComputesEachKeyOnce)
+{
+    lbnl::WorkStealingPool pool(4);
+    std::atomic callCount{0};
+    Evaluator fib(
+      [&callCount](int n, Evaluator::Context & ctx) -> std::uint64_t {
+          ++callCount;
+          if(n < 2)
+          {
+              return static_cast<std::uint64_t>(n);
+          }
+          return ctx.get(n - 1) + ctx.get(n - 2);
+      },
+      pool);
+
+    EXPECT_EQ(fib.get(50), 12586269025u);
+    EXPECT_EQ(callCount, 51);
+    EXPECT_EQ(fib(50), 12586269025u);
+    EXPECT_EQ(callCount, 51);
+}
+
+TEST(RecursiveEvaluatorTest, GetAllRunsIndependentKeysInParallel)
+{
+    lbnl::WorkStealingPool pool(4);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic callCount{0};
+
+    Evaluator evaluator(
+      [&](int key, Evaluator::Context & ctx) -> std::uint64_t {
+          ++callCount;
+          if(key == 0)
+          {
+              std::vector<int> children(8);
+              std::iota(children.begin(), children.end(), 1);
+              std::uint64_t sum = 0;
+              for(const auto & value : ctx.get_all(children))
+              {
+                  sum += value.get();
+              }
+              return sum;
+          }
+          {
+              std::lock_guard lock(mutex);
+              threads.insert(std::this_thread::get_id());
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(20));
+          return static_cast<std::uint64_t>(key);
+      },
+      pool);
+
+    EXPECT_EQ(evaluator.get(0), 36u);
+    EXPECT_EQ(callCount, 9);
+    EXPECT_EQ(evaluator.size(), 9u);
+    EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(RecursiveEvaluatorTest, SharedSubproblemsAcrossBatchesAreComputedOnce)
+{
+    lbnl::WorkStealingPool pool(4);
+    std::atomic callCount{0};
+
+    // Grid paths: paths(r, c) = paths(r - 1, c) + paths(r, c - 1), encoded as r * 100 + c.
+    Evaluator paths(
+      [&callCount](int key, Evaluator::Context & ctx) -> std::uint64_t {
+          ++callCount;
+          const int row = key / 100;
+          const int col = key % 100;
+          if(row == 0 || col == 0)
+          {
+              return 1u;
+          }
+          const std::vector<int> neighbours{(row - 1) * 100 + col, row * 100 + col - 1};
+          const auto values = ctx.get_all(neighbours);
+          return values[0].get() + values[1].get();
+      },
+      pool);
+
+    EXPECT_EQ(paths.get(16 * 100 + 16), 601080390u);
+    EXPECT_EQ(callCount, 17 * 17 - 1);   // every cell except (0, 0), which no cell depends on
+}
+
+TEST(RecursiveEvaluatorTest, SelfDependencyThrows)
+{
+    lbnl::WorkStealingPool pool(2);
+    Evaluator evaluator([](int key, Evaluator::Context & ctx) -> std::uint64_t { return ctx.get(key); },
+                        pool);
+
+    EXPECT_THROW((void)evaluator.get(1), lbnl::DependencyCycleError);
+}
+
+TEST(RecursiveEvaluatorTest, IndirectCycleThrowsInsteadOfHanging)
+{
+    lbnl::WorkStealingPool pool(4);
+    Evaluator evaluator(
+      [](int key, Evaluator::Context & ctx) -> std::uint64_t {
+          switch(key)
+          {
+              case 0: {
+                  const std::vector<int> children{1, 2};
+                  const auto values = ctx.get_all(children);
+                  return values[0].get() + values[1].get();
+              }
+              case 1:
+                  return ctx.get(2);
+              case 2:
+                  return ctx.get(3);
+              default:
+                  return ctx.get(1);
+          }
+      },
+      pool);
+
+    EXPECT_THROW((void)evaluator.get(0), lbnl::DependencyCycleError);
+    EXPECT_THROW((void)evaluator.get(3), lbnl::DependencyCycleError);
+}
+
+TEST(RecursiveEvaluatorTest, ChildAskingForItsParentThrowsWhileTheBatchIsQueued)
+{
+    // Key 1 is picked up by a worker while key 0 is still queueing its large batch; the edge
+    // from 0 to 1 must already be in the graph when key 1 asks for key 0.
+    std::vector<int> children(20000);
+    std::iota(children.begin(), children.end(), 1);
+
+    for(int round = 0; round < 20; ++round)
+    {
+        lbnl::WorkStealingPool pool(4);
+        Evaluator evaluator(
+          [&children](int key, Evaluator::Context & ctx) -> std::uint64_t {
+              if(key == 0)
+              {
+                  return ctx.get_all(children).size();
+              }
+              if(key == 1)
+              {
+                  return ctx.get(0);
+              }
+              return static_cast<std::uint64_t>(key);
+          },
+          pool);
+
+        EXPECT_THROW((void)evaluator.get(0), lbnl::DependencyCycleError) << round;
+    }
+}
+
+TEST(RecursiveEvaluatorTest, FailedKeyIsRetried)
+{
+    lbnl::WorkStealingPool pool(2);
+    std::atomic fail{true};
+    Evaluator evaluator(
+      [&fail](int key, Evaluator::Context & ctx) -> std::uint64_t {
+          if(key == 0)
+          {
+              return ctx.get(1) + 1;
+          }
+          if(fail.exchange(false))
+          {
+              throw std::runtime_error("transient");
+          }
+          return 41u;
+      },
+      pool);
+
+    EXPECT_THROW((void)evaluator.get(0), std::runtime_error);
+    EXPECT_EQ(evaluator.get(0), 42u);
+}
+
+TEST(RecursiveEvaluatorTest, PoolWithoutThreadsEvaluatesOnCaller)
+{
+    lbnl::WorkStealingPool pool(0);
+    Evaluator evaluator(
+      [](int key, Evaluator::Context & ctx) -> std::uint64_t {
+          if(key == 0)
+          {
+              const std::vector<int> children{1, 2, 3};
+              std::uint64_t sum = 0;
+              for(const auto & value : ctx.get_all(children))
+              {
+                  sum += value.get();
+              }
+              return sum;
+          }
+          return static_cast<std::uint64_t>(key) * 10u;
+      },
+      pool);
+
+    EXPECT_EQ(evaluator.get(0), 60u);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "lbnl/map_utils.hxx"
+#include "lbnl/memoize.hxx"
+
+namespace
+{
+    // String key that counts how often it is constructed from a string_view.
+    struct CountedKey
+    {
+        static inline int constructions = 0;
+
+        std::string text;
+
+        explicit CountedKey(std::string_view view) : text(view)
+        {
+            ++constructions;
+        }
+
+        friend bool operator==(const CountedKey & lhs, const CountedKey & rhs) = default;
+
+        friend bool operator==(const CountedKey & lhs, std::string_view rhs)
+        {
+            return lhs.text == rhs;
+        }
+    };
+
+    struct CountedKeyHash
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view view) const noexcept
+        {
+            return std::hash<std::string_view>{}(view);
+        }
+
+        std::size_t operator()(const CountedKey & key) const noexcept
+        {
+            return (*this)(std::string_view(key.text));
+        }
+    };
+}   // namespace
+
+TEST(LazyEvaluatorTransparentTest, StringViewLookupOnStringKeys)
+{
+    std::atomic callCount{0};
+    lbnl::LazyEvaluator<std::string, std::size_t, lbnl::TransparentStringHash, std::equal_to<>>
+      evaluator([&callCount](const std::string & key) {
+          ++callCount;
+          return key.size();
+      });
+
+    constexpr std::string_view name = "window";
+    EXPECT_EQ(evaluator.get(name), 6u);
+    EXPECT_EQ(evaluator(name), 6u);
+    EXPECT_EQ(evaluator.get("window"), 6u);
+    EXPECT_EQ(evaluator.get(std::string("window")), 6u);
+    EXPECT_EQ(callCount, 1);
+
+    ASSERT_NE(evaluator.try_get(name), nullptr);
+    EXPECT_EQ(*evaluator.try_get(name), 6u);
+    EXPECT_EQ(evaluator.try_get(std::string_view("door")), nullptr);
+    EXPECT_NE(evaluator.get_for(name, std::chrono::milliseconds(1)), nullptr);
+}
+
+TEST(LazyEvaluatorTransparentTest, KeyIsOnlyConstructedOnMiss)
+{
+    CountedKey::constructions = 0;
+    lbnl::LazyEvaluator<CountedKey, std::size_t, CountedKeyHash, std::equal_to<>> evaluator(
+      [](const CountedKey & key) { return key.text.size() * 2; });
+
+    EXPECT_EQ(evaluator.get(std::string_view("wall")), 8u);
+    EXPECT_EQ(CountedKey::constructions, 1);
+
+    for(int hit = 0; hit < 10; ++hit)
+    {
+        EXPECT_EQ(evaluator.get(std::string_view("wall")), 8u);
+    }
+    EXPECT_EQ(CountedKey::constructions, 1);
+
+    EXPECT_EQ(evaluator.get(std::string_view("roof")), 8u);
+    EXPECT_EQ(CountedKey::constructions, 2);
+}
+
+TEST(LazyEvaluatorTransparentTest, DefaultHashStillAcceptsConvertibleKeys)
+{
+    lbnl::LazyEvaluator<std::string, std::string> evaluator(
+      [](const std::string & key) { return key + key; });
+
+    // Not transparent: the literal converts to std::string as before.
+    EXPECT_EQ(evaluator.get("ab"), "abab");
+    EXPECT_EQ(evaluator("ab"), "abab");
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "lbnl/memoize.hxx"
+
+namespace
+{
+    int add(int a, int b)
+    {
+        return a + b;
+    }
+}   // namespace
+
+TEST(MemoizeTest, MultiArgumentFunction)
+{
+    std::atomic calls{0};
+    auto describe = lbnl::memoize([&calls](int zone, double height, const std::string & name) {
+        ++calls;
+        return name + ":" + std::to_string(zone) + ":" + std::to_string(static_cast<int>(height * 10));
+    });
+
+    EXPECT_EQ(describe(1, 2.5, "north"), "north:1:25");
+    EXPECT_EQ(describe(1, 2.5, "north"), "north:1:25");
+    EXPECT_EQ(calls, 1);
+
+    EXPECT_EQ(describe(1, 2.5, "south"), "south:1:25");
+    EXPECT_EQ(describe(2, 2.5, "north"), "north:2:25");
+    EXPECT_EQ(calls, 3);
+}
+
+TEST(MemoizeTest, FunctionPointer)
+{
+    auto cachedAdd = lbnl::memoize(&add);
+    EXPECT_EQ(cachedAdd(2, 3), 5);
+    EXPECT_EQ(&cachedAdd(2, 3), &cachedAdd(2, 3));
+}
+
+TEST(MemoizeTest, CopiesShareTheCache)
+{
+    std::atomic calls{0};
+    auto square = lbnl::memoize([&calls](int x) {
+        ++calls;
+        return x * x;
+    });
+    auto copy = square;
+
+    EXPECT_EQ(square(4), 16);
+    EXPECT_EQ(copy(4), 16);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(MemoizeTest, ProjectionDropsIrrelevantArguments)
+{
+    std::atomic calls{0};
+    auto scaled = lbnl::memoize(
+      [&calls](int value, const std::string & /*logTag*/) {
+          ++calls;
+          return value * 100;
+      },
+      [](int value, const std::string &) { return value; });
+
+    static_assert(std::is_same_v<decltype(scaled)::Key, int>);
+
+    EXPECT_EQ(scaled(3, "first"), 300);
+    EXPECT_EQ(scaled(3, "second"), 300);   // tag ignored, served from cache
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(MemoizeTest, CacheAccessAllowsInvalidation)
+{
+    std::atomic calls{0};
+    auto f = lbnl::memoize([&calls](int a, int b) {
+        ++calls;
+        return a * b;
+    });
+
+    EXPECT_EQ(f(2, 3), 6);
+    EXPECT_TRUE(f.cache().erase(std::make_tuple(2, 3)));
+    EXPECT_EQ(f.cache().try_get(std::make_tuple(2, 3)), nullptr);
+    EXPECT_EQ(f(2, 3), 6);
+    EXPECT_EQ(calls, 2);
+
+    // Stale and expired entries are recomputed through the function, never a null generator
+    EXPECT_TRUE(f.cache().invalidate(std::make_tuple(2, 3)));
+    EXPECT_EQ(f(2, 3), 6);
+    EXPECT_EQ(calls, 3);
+
+    f.cache().set_ttl(std::chrono::nanoseconds(0));
+    f.cache().clear();
+    EXPECT_EQ(f(4, 5), 20);
+    EXPECT_EQ(f(4, 5), 20);
+    EXPECT_EQ(calls, 5);
+}
+
+TEST(MemoizeTest, ParallelCallsComputeOnce)
+{
+    std::atomic calls{0};
+    auto slow = lbnl::memoize([&calls](int a, int b) {
+        ++calls;
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        return std::to_string(a) + "-" + std::to_string(b);
+    });
+
+    constexpr int numThreads = 8;
+    std::vector<std::thread> threads;
+    std::vector<const std::string *> results(numThreads);
+    for(int idx = 0; idx < numThreads; ++idx)
+    {
+        threads.emplace_back([&slow, &results, idx]() { results[idx] = &slow(1, 2); });
+    }
+    for(auto & thr : threads)
+    {
+        thr.join();
+    }
+
+    EXPECT_EQ(calls, 1);
+    std::set<const std::string *> unique(results.begin(), results.end());
+    EXPECT_EQ(unique.size(), 1u);
+    EXPECT_EQ(**unique.begin(), "1-2");
+}
+
+TEST(MemoizeTest, TupleHashDistinguishesOrder)
+{
+    lbnl::TupleHash hash;
+    EXPECT_NE(hash(std::make_tuple(1, 2)), hash(std::make_tuple(2, 1)));
+    EXPECT_EQ(hash(std::make_tuple(1, std::string("a"))), hash(std::make_tuple(1, std::string("a"))));
+}
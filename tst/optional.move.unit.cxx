@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <lbnl/optional.hxx>
+
+namespace
+{
+    // Payload that counts how often it is copied
+    struct Tracked
+    {
+        static inline int copies = 0;
+
+        std::vector<double> data;
+
+        explicit Tracked(std::vector<double> d) : data(std::move(d))
+        {}
+
+        Tracked(const Tracked & other) : data(other.data)
+        {
+            ++copies;
+        }
+
+        Tracked(Tracked &&) noexcept = default;
+        Tracked & operator=(const Tracked &) = default;
+        Tracked & operator=(Tracked &&) noexcept = default;
+    };
+
+    std::optional<Tracked> load()
+    {
+        return Tracked{{1.0, 2.0, 3.0}};
+    }
+
+    struct Surface
+    {
+        std::string name;
+        double area;
+    };
+}   // namespace
+
+TEST(OptionalExtMove, ChainOnTemporaryDoesNotCopy)
+{
+    Tracked::copies = 0;
+
+    auto result = lbnl::extend(load())
+                    .map([](Tracked && t) {
+                        t.data.push_back(4.0);
+                        return std::move(t);
+                    })
+                    .and_then([](Tracked && t) { return std::optional<Tracked>(std::move(t)); })
+                    .or_else([] { return Tracked{{}}; });
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->data, (std::vector<double>{1.0, 2.0, 3.0, 4.0}));
+
+    const Tracked out = std::move(result).value_or(Tracked{{}});
+    EXPECT_EQ(out.data.size(), 4u);
+    EXPECT_EQ(Tracked::copies, 0);
+}
+
+TEST(OptionalExtMove, LvalueChainKeepsSource)
+{
+    Tracked::copies = 0;
+
+    const auto source = lbnl::extend(load());
+    auto sizes = source.map([](const Tracked & t) { return t.data.size(); });
+    auto same = source.or_else([] { return Tracked{{}}; });
+
+    EXPECT_EQ(*sizes, 3u);
+    EXPECT_EQ(same->data.size(), 3u);
+    EXPECT_EQ(source->data.size(), 3u);
+    EXPECT_EQ(Tracked::copies, 1);   // or_else on a present value copies it into the result
+}
+
+TEST(OptionalExtMove, ExtendMovesFromRvalueOptional)
+{
+    Tracked::copies = 0;
+
+    std::optional<Tracked> opt = load();
+    auto copied = lbnl::extend(opt);
+    EXPECT_EQ(Tracked::copies, 1);
+
+    auto moved = lbnl::extend(std::move(opt));
+    EXPECT_EQ(Tracked::copies, 1);
+    EXPECT_EQ(moved->data.size(), 3u);
+
+    std::optional<Tracked> raw = std::move(moved).raw();
+    EXPECT_EQ(raw->data.size(), 3u);
+    EXPECT_EQ(Tracked::copies, 1);
+}
+
+TEST(OptionalExtRef, WrapsWithoutCopying)
+{
+    Tracked::copies = 0;
+
+    std::optional<Tracked> opt = load();
+    auto ref = lbnl::extend_ref(opt);
+    static_assert(std::is_same_v<decltype(ref), lbnl::OptionalExt<Tracked &>>);
+    ASSERT_TRUE(ref.has_value());
+
+    ref->data.push_back(9.0);
+    EXPECT_EQ(opt->data.size(), 4u);
+
+    auto total = ref.map([](const Tracked & t) { return t.data.size(); });
+    EXPECT_EQ(*total, 4u);
+    EXPECT_EQ(Tracked::copies, 0);
+}
+
+TEST(OptionalExtRef, EmptyFromNullPointerOrEmptyOptional)
+{
+    const std::optional<int> none;
+    auto fromOptional = lbnl::extend_ref(none);
+    static_assert(std::is_same_v<decltype(fromOptional), lbnl::OptionalExt<const int &>>);
+    EXPECT_FALSE(fromOptional.has_value());
+    EXPECT_EQ(fromOptional, std::nullopt);
+
+    int * nothing = nullptr;
+    auto fromPointer = lbnl::extend_ref(nothing);
+    EXPECT_FALSE(fromPointer);
+    EXPECT_EQ(fromPointer.value_or(7), 7);
+    EXPECT_FALSE(fromPointer.map([](int x) { return x * 2; }).has_value());
+}
+
+TEST(OptionalExtRef, ChainsThroughReferences)
+{
+    std::map<std::string, Surface> surfaces{{"roof", {"roof", 120.0}}, {"wall", {"wall", 40.0}}};
+
+    auto find = [&surfaces](const std::string & key) {
+        auto it = surfaces.find(key);
+        return lbnl::OptionalExt<Surface &>(it == surfaces.end() ? nullptr : &it->second);
+    };
+
+    // and_then returning another reference keeps pointing into the map
+    auto name = find("roof").and_then([](Surface & s) { return lbnl::OptionalExt<std::string &>(s.name); });
+    static_assert(std::is_same_v<decltype(name), lbnl::OptionalExt<std::string &>>);
+    ASSERT_TRUE(name.has_value());
+    *name = "ceiling";
+    EXPECT_EQ(surfaces.at("roof").name, "ceiling");
+
+    Surface fallback{"none", 0.0};
+    auto chosen = find("floor").or_else([&fallback]() -> Surface & { return fallback; });
+    EXPECT_EQ(chosen.raw(), &fallback);
+    EXPECT_EQ(find("wall").map([](const Surface & s) { return s.area; }).value_or(0.0), 40.0);
+
+    lbnl::OptionalExt<const Surface &> readOnly = find("wall");
+    EXPECT_EQ(readOnly->area, 40.0);
+}
+
+TEST(OptionalExtRef, ComparesReferencedValues)
+{
+    int a = 5;
+    int b = 5;
+    int c = 6;
+    EXPECT_EQ(lbnl::OptionalExt<int &>(a), lbnl::OptionalExt<int &>(b));
+    EXPECT_NE(lbnl::OptionalExt<int &>(a), lbnl::OptionalExt<int &>(c));
+    EXPECT_EQ(lbnl::OptionalExt<int &>(a), 5);
+    EXPECT_NE(lbnl::OptionalExt<int &>(a), std::nullopt);
+}
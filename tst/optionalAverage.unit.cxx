@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
+#include <cmath>
+#include <list>
+#include <optional>
+#include <ranges>
+#include <vector>
 
+#include <lbnl/compact_optional.hxx>
+#include <lbnl/optional.hxx>
 #include <lbnl/optional_utils.hxx>
 
 TEST(AverageOptionalTest, AllValuesPresent)
@@ -38,4 +45,95 @@ TEST(AverageOptionalTest, SingleValuePresent)
     auto result = lbnl::average_optional(input);
     ASSERT_TRUE(result.has_value());
     EXPECT_DOUBLE_EQ(result.value(), 3.14);
-}
\ No newline at end of file
+}
+
+TEST(AverageOptionalTest, ExplicitTemplateArgumentStillCompiles)
+{
+    const std::vector<std::optional<int>> values{1, 2, std::nullopt, 5};
+    EXPECT_EQ(lbnl::average_optional<int>(values), 2);
+    EXPECT_EQ(lbnl::average_optional<int>({1, 2, std::nullopt}), 1);
+    EXPECT_EQ(lbnl::average_optional<double>({1.0, std::nullopt, 2.0}, lbnl::Summation::Kahan),
+              1.5);
+    static_assert(lbnl::average_optional<int>({4, std::nullopt, 8}) == 6);
+}
+
+TEST(AverageOptionalTest, IntegerValuesTruncate)
+{
+    std::vector<std::optional<int>> input = {1, std::nullopt, 2};
+    EXPECT_EQ(lbnl::average_optional(input), 1);
+}
+
+TEST(AverageOptionalTest, AcceptsAnyRangeOfOptionals)
+{
+    const std::list<std::optional<double>> list = {1.0, std::nullopt, 5.0};
+    EXPECT_DOUBLE_EQ(*lbnl::average_optional(list), 3.0);
+
+    const std::vector<lbnl::OptionalExt<double>> extended = {lbnl::OptionalExt<double>(2.0),
+                                                             lbnl::OptionalExt<double>(std::nullopt)};
+    EXPECT_DOUBLE_EQ(*lbnl::average_optional(extended), 2.0);
+
+    const std::vector<lbnl::CompactOptional<double>> compact = {4.0, std::nullopt, 8.0};
+    EXPECT_DOUBLE_EQ(*lbnl::average_optional(compact), 6.0);
+
+    // A computed range yielding optionals by value
+    const std::vector<int> raw = {-1, 3, -1, 5};
+    auto view = raw | std::views::transform([](int x) {
+                    return x < 0 ? std::optional<double>() : std::optional<double>(x);
+                });
+    EXPECT_DOUBLE_EQ(*lbnl::average_optional(view), 4.0);
+}
+
+TEST(AverageOptionalTest, ManyBlocksWithGaps)
+{
+    // Longer than one kernel block, with a gap pattern that does not align to lanes
+    std::vector<std::optional<double>> input(1000);
+    double sum = 0.0;
+    std::size_t count = 0;
+    for(std::size_t i = 0; i < input.size(); ++i)
+    {
+        if(i % 3 != 0)
+        {
+            input[i] = static_cast<double>(i);
+            sum += static_cast<double>(i);
+            ++count;
+        }
+    }
+    for(auto summation : {lbnl::Summation::Simple, lbnl::Summation::Kahan, lbnl::Summation::Pairwise})
+    {
+        EXPECT_DOUBLE_EQ(*lbnl::average_optional(input, summation), sum / static_cast<double>(count));
+    }
+}
+
+TEST(AverageOptionalTest, CompensatedSummationKeepsFloatPrecision)
+{
+    const std::vector<lbnl::CompactOptional<float>> series(1u << 22, 0.1f);
+
+    const float simple = *lbnl::average_optional(series, lbnl::Summation::Simple);
+    const float kahan = *lbnl::average_optional(series, lbnl::Summation::Kahan);
+    const float pairwise = *lbnl::average_optional(series, lbnl::Summation::Pairwise);
+
+    EXPECT_NEAR(kahan, 0.1f, 1e-7f);
+    EXPECT_NEAR(pairwise, 0.1f, 1e-7f);
+    EXPECT_GT(std::abs(simple - 0.1f), std::abs(pairwise - 0.1f));
+}
+
+TEST(AverageOptionalTest, ParallelMatchesSerial)
+{
+    std::vector<std::optional<double>> input(100'000);
+    for(std::size_t i = 0; i < input.size(); ++i)
+    {
+        if(i % 7 != 0)
+        {
+            input[i] = 1.0 / static_cast<double>(i + 1);
+        }
+    }
+
+    const auto serial = lbnl::average_optional(input);
+    const auto parallel = lbnl::average_optional(input, lbnl::Summation::Pairwise, 8);
+    ASSERT_TRUE(parallel.has_value());
+    EXPECT_NEAR(*parallel, *serial, 1e-15);
+    EXPECT_EQ(parallel, lbnl::average_optional(input, lbnl::Summation::Pairwise, 8));
+
+    const std::vector<std::optional<double>> empty;
+    EXPECT_FALSE(lbnl::average_optional(empty, lbnl::Summation::Kahan, 4).has_value());
+}
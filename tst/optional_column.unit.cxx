@@ -0,0 +1,181 @@
+// optional_column.unit.cxx
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <lbnl/optional_column.hxx>
+
+namespace
+{
+    using Column = lbnl::OptionalColumn<double>;
+
+    static_assert(std::ranges::random_access_range<Column>);
+    static_assert(std::ranges::sized_range<Column>);
+    static_assert(lbnl::OptionalLike<Column::const_reference>);
+
+    // 200 slots: every third one null, spanning full, mixed and partial bitmap words
+    Column makeSeries()
+    {
+        Column column;
+        for(std::size_t i = 0; i < 200; ++i)
+        {
+            if(i % 3 == 0)
+            {
+                column.push_back(std::nullopt);
+            }
+            else
+            {
+                column.push_back(static_cast<double>(i));
+            }
+        }
+        return column;
+    }
+}   // namespace
+
+TEST(OptionalColumn, RoundTripsThroughVectorOfOptionals)
+{
+    const std::vector<std::optional<double>> source{1.0, std::nullopt, 3.0, std::nullopt};
+    const Column column(source);
+
+    EXPECT_EQ(column.size(), 4u);
+    EXPECT_EQ(column.count_valid(), 2u);
+    EXPECT_TRUE(column[0].has_value());
+    EXPECT_EQ(column[1], std::nullopt);
+    EXPECT_EQ(column[2], 3.0);
+    EXPECT_EQ(column.to_optionals(), source);
+}
+
+TEST(OptionalColumn, ValueBufferAndBitmapAreContiguous)
+{
+    Column column{1.0, std::nullopt, 3.0};
+    const std::span<const double> values = std::as_const(column).values();
+    EXPECT_EQ(values.data(), &*column[0]);
+    EXPECT_EQ(values[1], 0.0);   // null slots hold T{}
+    ASSERT_EQ(column.validity().size(), 1u);
+    EXPECT_EQ(column.validity()[0], 0b101u);
+
+    column.values()[2] = 30.0;
+    EXPECT_EQ(column[2], 30.0);
+
+    const Column fromBuffers(std::vector<double>{5.0, 6.0},
+                             std::vector<std::uint64_t>{~std::uint64_t{0}});
+    EXPECT_EQ(fromBuffers.count_valid(), 2u);   // bits past size() are cleared
+}
+
+TEST(OptionalColumn, BufferConstructorResetsNullSlots)
+{
+    const Column column(std::vector<double>{1.0, 2.0, 3.0, 4.0},
+                        std::vector<std::uint64_t>{0b0101u});
+    EXPECT_EQ(column.count_valid(), 2u);
+    EXPECT_EQ(column.values()[1], 0.0);
+    EXPECT_EQ(column.values()[3], 0.0);
+    EXPECT_EQ(column, (Column{1.0, std::nullopt, 3.0, std::nullopt}));
+    EXPECT_EQ(column.value_or(-1.0), (std::vector<double>{1.0, -1.0, 3.0, -1.0}));
+}
+
+TEST(OptionalColumn, ElementAssignmentThroughProxy)
+{
+    Column column(3);
+    EXPECT_EQ(column.count_valid(), 0u);
+
+    column[0] = 1.5;
+    column[2] = std::optional<double>(2.5);
+    column[1] = column[2];
+    EXPECT_EQ(column[1], 2.5);
+    EXPECT_EQ(column[2], 2.5);
+
+    column[2] = std::nullopt;
+    EXPECT_FALSE(column[2].has_value());
+    EXPECT_EQ(column.values()[2], 0.0);
+    EXPECT_EQ(column[2].value_or(-1.0), -1.0);
+    EXPECT_THROW((void)column[2].value(), std::bad_optional_access);
+}
+
+TEST(OptionalColumn, MapKeepsNullsAndSkipsThem)
+{
+    const auto series = makeSeries();
+    int calls = 0;
+    const auto doubled = series.map([&calls](double x) {
+        ++calls;
+        return x * 2.0;
+    });
+
+    EXPECT_EQ(calls, static_cast<int>(series.count_valid()));
+    ASSERT_EQ(doubled.size(), series.size());
+    for(std::size_t i = 0; i < series.size(); ++i)
+    {
+        EXPECT_EQ(doubled[i].has_value(), series[i].has_value());
+        if(series[i].has_value())
+        {
+            EXPECT_EQ(*doubled[i], *series[i] * 2.0);
+        }
+    }
+
+    const auto labels =
+      series.transform([](double x) { return std::to_string(static_cast<int>(x)); });
+    EXPECT_EQ(labels[4], std::string("4"));
+    EXPECT_FALSE(labels[3].has_value());
+}
+
+TEST(OptionalColumn, FilterAndThenOrElseValueOr)
+{
+    const auto series = makeSeries();
+
+    const auto even = series.filter([](double x) { return static_cast<int>(x) % 2 == 0; });
+    EXPECT_EQ(even.count_valid(), 66u);
+    EXPECT_EQ(even[2], 2.0);
+    EXPECT_FALSE(even[1].has_value());
+    EXPECT_EQ(even.values()[1], 0.0);
+
+    const auto roots = series.and_then([](double x) {
+        return x > 100.0 ? std::optional<double>(std::sqrt(x)) : std::nullopt;
+    });
+    EXPECT_FALSE(roots[100].has_value());
+    EXPECT_DOUBLE_EQ(*roots[121], 11.0);
+
+    const auto filled = series.or_else([] { return -1.0; });
+    EXPECT_EQ(filled.count_valid(), series.size());
+    EXPECT_EQ(filled[0], -1.0);
+    EXPECT_EQ(filled[1], 1.0);
+
+    const auto dense = series.value_or(0.0);
+    EXPECT_EQ(dense.size(), series.size());
+    EXPECT_EQ(dense[3], 0.0);
+    EXPECT_EQ(dense[199], 199.0);
+}
+
+TEST(OptionalColumn, AverageMatchesAverageOptional)
+{
+    const auto series = makeSeries();
+    const auto expected = lbnl::average_optional(series.to_optionals());
+
+    ASSERT_TRUE(series.average().has_value());
+    EXPECT_DOUBLE_EQ(*series.average(), *expected);
+    EXPECT_DOUBLE_EQ(*series.average(lbnl::Summation::Kahan), *expected);
+
+    // The column is also a range of optionals for the generic reductions
+    EXPECT_DOUBLE_EQ(*lbnl::average_optional(series), *expected);
+    EXPECT_DOUBLE_EQ(*lbnl::average_optional(series, lbnl::Summation::Pairwise, 4), *expected);
+    EXPECT_EQ(lbnl::optional_stats(series)->count, series.count_valid());
+
+    EXPECT_FALSE(Column(10).average().has_value());
+    EXPECT_FALSE(Column().average().has_value());
+}
+
+TEST(OptionalColumn, EqualityIgnoresNullSlotContents)
+{
+    Column lhs{1.0, std::nullopt};
+    const Column rhs{1.0, std::nullopt};
+    EXPECT_EQ(lhs, rhs);
+
+    lhs.values()[1] = 42.0;   // the slot stays null
+    EXPECT_EQ(lhs, rhs);
+
+    lhs[1] = 42.0;
+    EXPECT_NE(lhs, rhs);
+}
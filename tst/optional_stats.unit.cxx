@@ -0,0 +1,75 @@
+// optional_stats.unit.cxx
+#include <gtest/gtest.h>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include <lbnl/compact_optional.hxx>
+#include <lbnl/optional_utils.hxx>
+
+TEST(OptionalStats, SmallSeries)
+{
+    const std::vector<std::optional<double>> input = {2.0, std::nullopt, 4.0, 4.0, std::nullopt,
+                                                      4.0, 5.0, 5.0, 7.0, 9.0};
+    const auto stats = lbnl::optional_stats(input);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->count, 8u);
+    EXPECT_DOUBLE_EQ(stats->sum, 40.0);
+    EXPECT_DOUBLE_EQ(stats->mean, 5.0);
+    EXPECT_DOUBLE_EQ(stats->min, 2.0);
+    EXPECT_DOUBLE_EQ(stats->max, 9.0);
+    EXPECT_DOUBLE_EQ(stats->variance, 4.0);
+}
+
+TEST(OptionalStats, EmptyAndAllMissing)
+{
+    const std::vector<std::optional<double>> none;
+    EXPECT_FALSE(lbnl::optional_stats(none).has_value());
+
+    const std::vector<lbnl::CompactOptional<double>> missing(1000);
+    EXPECT_FALSE(lbnl::optional_stats(missing).has_value());
+}
+
+TEST(OptionalStats, LargeOffsetDoesNotCancel)
+{
+    // Values 1e9 + {0, 1, 2, ...}: the naive E[x^2] - E[x]^2 formula loses every digit here
+    std::vector<lbnl::CompactOptional<double>> input(8760);
+    for(std::size_t i = 0; i < input.size(); ++i)
+    {
+        if(i % 5 != 4)
+        {
+            input[i] = 1e9 + static_cast<double>(i % 4);
+        }
+    }
+
+    const auto stats = lbnl::optional_stats(input);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->count, 7008u);
+    EXPECT_DOUBLE_EQ(stats->min, 1e9);
+    EXPECT_DOUBLE_EQ(stats->max, 1e9 + 3.0);
+    EXPECT_NEAR(stats->mean, 1e9 + 1.5, 1e-6);
+    EXPECT_NEAR(stats->variance, 1.25, 1e-9);
+}
+
+TEST(OptionalStats, ParallelMatchesSerial)
+{
+    std::vector<std::optional<double>> input(8760 * 10);
+    for(std::size_t i = 0; i < input.size(); ++i)
+    {
+        if(i % 11 != 0)
+        {
+            input[i] = std::sin(static_cast<double>(i) * 0.01) * 100.0;
+        }
+    }
+
+    const auto serial = lbnl::optional_stats(input);
+    const auto parallel = lbnl::optional_stats(input, 6);
+    ASSERT_TRUE(serial.has_value());
+    ASSERT_TRUE(parallel.has_value());
+    EXPECT_EQ(parallel->count, serial->count);
+    EXPECT_EQ(parallel->min, serial->min);
+    EXPECT_EQ(parallel->max, serial->max);
+    EXPECT_NEAR(parallel->sum, serial->sum, 1e-9);
+    EXPECT_NEAR(parallel->mean, serial->mean, 1e-12);
+    EXPECT_NEAR(parallel->variance, serial->variance, 1e-9);
+}
@@ -0,0 +1,54 @@
+// parallel_for.unit.cxx
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <lbnl/detail/parallel_for.hxx>
+
+TEST(ParallelFor, VisitsEveryIndexOnce)
+{
+    for(std::size_t concurrency : {0u, 1u, 3u, 64u})
+    {
+        std::vector<std::atomic<int>> visits(1000);
+        lbnl::detail::parallel_for(visits.size(), concurrency, [&](std::size_t index) {
+            ++visits[index];
+        });
+        for(const auto & count : visits)
+        {
+            EXPECT_EQ(count.load(), 1) << concurrency;
+        }
+    }
+
+    bool called = false;
+    lbnl::detail::parallel_for(0, 4, [&](std::size_t) { called = true; });
+    EXPECT_FALSE(called);
+}
+
+TEST(ParallelFor, ReturningFalseStopsClaimingIndices)
+{
+    std::atomic<std::size_t> calls{0};
+    lbnl::detail::parallel_for(100000, 4, [&](std::size_t index) {
+        ++calls;
+        return index < 10;
+    });
+    EXPECT_GE(calls.load(), 11u);
+    EXPECT_LT(calls.load(), 100000u);
+}
+
+TEST(ParallelFor, RethrowsTheFirstExceptionAfterJoining)
+{
+    std::atomic<std::size_t> calls{0};
+    EXPECT_THROW(lbnl::detail::parallel_for(100000,
+                                            4,
+                                            [&](std::size_t index) {
+                                                ++calls;
+                                                if(index == 5)
+                                                {
+                                                    throw std::runtime_error("boom");
+                                                }
+                                            }),
+                 std::runtime_error);
+    EXPECT_LT(calls.load(), 100000u);
+}
@@ -0,0 +1,157 @@
+// variant_utils.unit.cxx
+#include <gtest/gtest.h>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <lbnl/optional.hxx>
+#include <lbnl/variant_utils.hxx>
+
+namespace
+{
+    using Cell = std::variant<int, std::string, double>;
+
+    // 1000 cells cycling through int, string, double
+    std::vector<Cell> makeCells()
+    {
+        std::vector<Cell> cells;
+        for(int i = 0; i < 1000; ++i)
+        {
+            switch(i % 3)
+            {
+                case 0:
+                    cells.emplace_back(i);
+                    break;
+                case 1:
+                    cells.emplace_back("s" + std::to_string(i));
+                    break;
+                default:
+                    cells.emplace_back(i * 0.5);
+            }
+        }
+        return cells;
+    }
+}   // namespace
+
+TEST(SplitByAlternative, MatchesGetIfOptPerAlternative)
+{
+    const std::vector<Cell> cells{1, std::string("a"), 2.5, 3, std::string("b")};
+    const auto split = lbnl::split_by_alternative(cells);
+
+    EXPECT_EQ(split.values<int>(), (std::vector<int>{1, 3}));
+    EXPECT_EQ(split.values<std::string>(), (std::vector<std::string>{"a", "b"}));
+    EXPECT_EQ(split.values<2>(), (std::vector<double>{2.5}));
+    EXPECT_EQ(split.positions<int>(), (std::vector<std::size_t>{0, 3}));
+    EXPECT_EQ(split.positions<std::string>(), (std::vector<std::size_t>{1, 4}));
+    EXPECT_EQ(split.positions<double>(), (std::vector<std::size_t>{2}));
+    EXPECT_EQ(split.size(), cells.size());
+
+    // Same values as running get_if_opt once per alternative
+    std::vector<int> viaGetIfOpt;
+    for(const auto & cell : cells)
+    {
+        if(auto value = lbnl::get_if_opt<int>(cell))
+        {
+            viaGetIfOpt.push_back(*value);
+        }
+    }
+    EXPECT_EQ(split.values<int>(), viaGetIfOpt);
+
+    const auto & [ints, strings, doubles] = split.columns();
+    EXPECT_EQ(ints.size() + strings.size() + doubles.size(), cells.size());
+}
+
+TEST(SplitByAlternative, ExactSizingAllocatesOnce)
+{
+    const auto cells = makeCells();
+    const auto grown = lbnl::split_by_alternative(cells);
+    const auto exact = lbnl::split_by_alternative(cells, lbnl::SplitSizing::Exact);
+
+    EXPECT_EQ(exact.columns(), grown.columns());
+    EXPECT_EQ(exact.positions<0>(), grown.positions<0>());
+    EXPECT_EQ(exact.values<int>().capacity(), exact.values<int>().size());
+    EXPECT_EQ(exact.values<std::string>().capacity(), 333u);
+    EXPECT_EQ(exact.positions<double>().capacity(), 333u);
+
+    // A range computing its elements is traversed once whatever the sizing
+    auto generated = std::views::iota(0, 10) | std::views::transform([](int i) -> Cell {
+                         return i % 2 == 0 ? Cell(i) : Cell(static_cast<double>(i));
+                     });
+    const auto split = lbnl::split_by_alternative(generated, lbnl::SplitSizing::Exact);
+    EXPECT_EQ(split.values<int>(), (std::vector<int>{0, 2, 4, 6, 8}));
+    EXPECT_EQ(split.positions<double>(), (std::vector<std::size_t>{1, 3, 5, 7, 9}));
+}
+
+TEST(SplitByAlternative, MovesFromAnOwningRvalue)
+{
+    using Owned = std::variant<std::unique_ptr<int>, std::string>;
+    std::vector<Owned> cells;
+    cells.emplace_back(std::make_unique<int>(7));
+    cells.emplace_back(std::string(64, 'x'));
+    cells.emplace_back(std::make_unique<int>(9));
+
+    auto split = lbnl::split_by_alternative(std::move(cells));
+    ASSERT_EQ(split.values<0>().size(), 2u);
+    EXPECT_EQ(*split.values<0>()[1], 9);
+    EXPECT_EQ(split.values<std::string>()[0], std::string(64, 'x'));
+
+    std::vector<Cell> strings{std::string("kept"), std::string(64, 'y')};
+    auto parallel = lbnl::split_by_alternative(std::move(strings), std::size_t{2});
+    EXPECT_EQ(parallel.values<std::string>()[1], std::string(64, 'y'));
+    EXPECT_TRUE(strings[1].index() == 1 && std::get<1>(strings[1]).empty());   // moved-from
+}
+
+TEST(SplitByAlternative, ParallelMatchesSerial)
+{
+    const auto cells = makeCells();
+    const auto serial = lbnl::split_by_alternative(cells);
+
+    for(std::size_t concurrency : {1u, 2u, 7u, 64u, 5000u})
+    {
+        const auto parallel = lbnl::split_by_alternative(cells, concurrency);
+        EXPECT_EQ(parallel.columns(), serial.columns()) << concurrency;
+        EXPECT_EQ(parallel.positions<0>(), serial.positions<0>()) << concurrency;
+        EXPECT_EQ(parallel.positions<1>(), serial.positions<1>()) << concurrency;
+        EXPECT_EQ(parallel.positions<2>(), serial.positions<2>()) << concurrency;
+    }
+
+    const std::vector<Cell> empty;
+    EXPECT_EQ(lbnl::split_by_alternative(empty, std::size_t{4}).size(), 0u);
+}
+
+namespace
+{
+    template<typename R>
+    concept ParallelSplittable = requires(R range) {
+        lbnl::split_by_alternative(range, std::size_t{2});
+    };
+}   // namespace
+
+TEST(SplitByAlternative, BoolAlternativesAreSplitSerially)
+{
+    // std::vector<bool> packs its elements, so chunks cannot fill it concurrently
+    using Flag = std::variant<int, bool>;
+    static_assert(ParallelSplittable<const std::vector<Cell> &>);
+    static_assert(!ParallelSplittable<const std::vector<Flag> &>);
+
+    const std::vector<Flag> flags{1, true, 2, false, true};
+    const auto split = lbnl::split_by_alternative(flags);
+    EXPECT_EQ(split.values<bool>(), (std::vector<bool>{true, false, true}));
+    EXPECT_EQ(split.positions<bool>(), (std::vector<std::size_t>{1, 3, 4}));
+}
+
+TEST(SplitByAlternative, RepeatedAlternativeTypesAreAddressedByIndex)
+{
+    using Reading = std::variant<double, double, int>;   // e.g. Celsius, Fahrenheit, error code
+    const std::vector<Reading> readings{Reading(std::in_place_index<1>, 68.0),
+                                        Reading(std::in_place_index<0>, 20.0),
+                                        Reading(std::in_place_index<2>, -1)};
+
+    const auto split = lbnl::split_by_alternative(readings);
+    EXPECT_EQ(split.values<0>(), (std::vector<double>{20.0}));
+    EXPECT_EQ(split.values<1>(), (std::vector<double>{68.0}));
+    EXPECT_EQ(split.positions<1>(), (std::vector<std::size_t>{0}));
+    EXPECT_EQ(split.values<int>(), (std::vector<int>{-1}));
+}
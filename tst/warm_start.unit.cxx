@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "lbnl/warm_start.hxx"
+
+namespace
+{
+    std::filesystem::path tempFile(const std::string & name)
+    {
+        auto path = std::filesystem::temp_directory_path() / ("lbnl_warm_start_" + name + ".bin");
+        std::filesystem::remove(path);
+        return path;
+    }
+}   // namespace
+
+TEST(WarmStartTest, RoundTripSkipsGeneratorForStoredKeys)
+{
+    const auto path = tempFile("roundtrip");
+    constexpr std::uint64_t version = 3;
+
+    {
+        lbnl::LazyEvaluator<int, double> evaluator([](int key) { return key * 1.5; });
+        (void)evaluator.get(1);
+        (void)evaluator.get(2);
+        (void)evaluator.get(10);
+        ASSERT_TRUE(lbnl::save_warm_start(evaluator, path, version));
+    }
+
+    auto cache = std::make_shared<lbnl::WarmStartCache<int, double>>(path, version);
+    ASSERT_TRUE(cache->valid());
+    EXPECT_EQ(cache->size(), 3u);
+
+    std::atomic callCount{0};
+    lbnl::LazyEvaluator<int, double> restarted(
+      lbnl::with_warm_start<int, double>(cache, [&callCount](int key) {
+          ++callCount;
+          return key * 1.5;
+      }));
+
+    EXPECT_DOUBLE_EQ(restarted.get(2), 3.0);
+    EXPECT_DOUBLE_EQ(restarted.get(10), 15.0);
+    EXPECT_EQ(callCount, 0);
+
+    EXPECT_DOUBLE_EQ(restarted.get(4), 6.0);   // not in the file
+    EXPECT_EQ(callCount, 1);
+
+    cache.reset();
+    std::filesystem::remove(path);
+}
+
+TEST(WarmStartTest, StringCodecRoundTrip)
+{
+    const auto path = tempFile("strings");
+
+    {
+        lbnl::LazyEvaluator<std::string, std::string> evaluator(
+          [](const std::string & key) { return key + "!"; });
+        (void)evaluator.get("alpha");
+        (void)evaluator.get("");
+        ASSERT_TRUE(lbnl::save_warm_start(evaluator, path, 1, lbnl::StringCodec{}, lbnl::StringCodec{}));
+    }
+
+    lbnl::WarmStartCache<std::string, std::string, lbnl::StringCodec, lbnl::StringCodec> cache(path, 1);
+    ASSERT_TRUE(cache.valid());
+    EXPECT_EQ(cache.load("alpha"), "alpha!");
+    EXPECT_EQ(cache.load(""), "!");
+    EXPECT_FALSE(cache.load("beta").has_value());
+}
+
+TEST(WarmStartTest, MissingFileFallsBackToGenerator)
+{
+    const auto path = tempFile("missing");
+
+    auto cache = std::make_shared<lbnl::WarmStartCache<int, int>>(path, 1);
+    EXPECT_FALSE(cache->valid());
+    EXPECT_EQ(cache->size(), 0u);
+
+    lbnl::LazyEvaluator<int, int> evaluator(
+      lbnl::with_warm_start<int, int>(cache, [](int key) { return key + 100; }));
+    EXPECT_EQ(evaluator.get(1), 101);
+}
+
+TEST(WarmStartTest, StaleVersionIsIgnored)
+{
+    const auto path = tempFile("stale");
+
+    {
+        lbnl::LazyEvaluator<int, int> evaluator([](int key) { return key; });
+        (void)evaluator.get(5);
+        ASSERT_TRUE(lbnl::save_warm_start(evaluator, path, 1));
+    }
+
+    {
+        lbnl::WarmStartCache<int, int> cache(path, 2);
+        EXPECT_FALSE(cache.valid());
+        EXPECT_FALSE(cache.load(5).has_value());
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(WarmStartTest, TruncatedFileIsIgnored)
+{
+    const auto path = tempFile("truncated");
+
+    {
+        lbnl::LazyEvaluator<int, int> evaluator([](int key) { return key; });
+        (void)evaluator.get(5);
+        (void)evaluator.get(6);
+        ASSERT_TRUE(lbnl::save_warm_start(evaluator, path, 1));
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 2);
+
+    {
+        lbnl::WarmStartCache<int, int> cache(path, 1);
+        EXPECT_FALSE(cache.valid());
+        EXPECT_EQ(cache.size(), 0u);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(WarmStartTest, CorruptEntryCountIsIgnored)
+{
+    const auto path = tempFile("corrupt_count");
+
+    {
+        lbnl::LazyEvaluator<int, int> evaluator([](int key) { return key; });
+        (void)evaluator.get(5);
+        ASSERT_TRUE(lbnl::save_warm_start(evaluator, path, 1));
+    }
+    {
+        // The entry count lives at byte 24 of the header
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        const std::uint64_t count = std::uint64_t{1} << 60;
+        file.seekp(24);
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    }
+
+    lbnl::WarmStartCache<int, int> cache(path, 1);
+    EXPECT_FALSE(cache.valid());
+    EXPECT_EQ(cache.size(), 0u);
+    std::filesystem::remove(path);
+}
+
+TEST(WarmStartTest, ValueOfTheWrongSizeIsAMiss)
+{
+    const auto path = tempFile("wrong_size");
+
+    {
+        lbnl::LazyEvaluator<int, std::int16_t> evaluator(
+          [](int key) { return static_cast<std::int16_t>(key); });
+        (void)evaluator.get(5);
+        ASSERT_TRUE(lbnl::save_warm_start(evaluator, path, 1));
+    }
+
+    auto cache = std::make_shared<lbnl::WarmStartCache<int, double>>(path, 1);
+    ASSERT_TRUE(cache->valid());
+    EXPECT_FALSE(cache->load(5).has_value());
+
+    lbnl::LazyEvaluator<int, double> evaluator(
+      lbnl::with_warm_start<int, double>(cache, [](int key) { return key * 2.0; }));
+    EXPECT_DOUBLE_EQ(evaluator.get(5), 10.0);   // computed, not read from the file
+
+    cache.reset();
+    std::filesystem::remove(path);
+}
+
+TEST(WarmStartTest, FailedSaveLeavesNoTemporaryFile)
+{
+    lbnl::LazyEvaluator<int, double> evaluator([](int key) { return key * 1.5; });
+    (void)evaluator.get(1);
+
+    // The target is a non-empty directory, so the final rename fails.
+    const auto directory = tempFile("target_dir");
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+    std::ofstream(directory / "keep") << "x";
+    auto temporary = directory;
+    temporary += ".tmp";
+
+    EXPECT_FALSE(lbnl::save_warm_start(evaluator, directory, 1));
+    EXPECT_FALSE(std::filesystem::exists(temporary));
+    EXPECT_TRUE(std::filesystem::is_directory(directory));
+
+    // The temporary file cannot even be opened.
+    const auto unreachable = directory / "missing" / "cache.bin";
+    auto unreachableTemporary = unreachable;
+    unreachableTemporary += ".tmp";
+    EXPECT_FALSE(lbnl::save_warm_start(evaluator, unreachable, 1));
+    EXPECT_FALSE(std::filesystem::exists(unreachableTemporary));
+
+    std::filesystem::remove_all(directory);
+}
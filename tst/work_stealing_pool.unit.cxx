@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "lbnl/memoize.hxx"
+#include "lbnl/work_stealing_pool.hxx"
+
+TEST(WorkStealingPoolTest, RunsEverySubmittedTaskBeforeDestruction)
+{
+    std::atomic count{0};
+    {
+        lbnl::WorkStealingPool pool(3);
+        for(int i = 0; i < 1000; ++i)
+        {
+            pool.submit([&count, &pool]() {
+                if(pool.is_worker_thread())
+                {
+                    ++count;
+                }
+            });
+        }
+        pool.submit([]() { throw std::runtime_error("discarded"); });
+    }
+    EXPECT_EQ(count, 1000);
+}
+
+TEST(WorkStealingPoolTest, ServesAsLazyEvaluatorExecutor)
+{
+    lbnl::WorkStealingPool pool(2);
+    lbnl::LazyEvaluator<int, int> evaluator([](int key) { return key * 3; });
+
+    auto future = evaluator.get_async(7, pool);
+    EXPECT_EQ(future.get(), 21);
+}